@@ -0,0 +1,198 @@
+#pragma once
+#ifndef ALIGNED_ALLOCATOR
+#define ALIGNED_ALLOCATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif // __linux__
+
+#include "Config.h"
+#include "Utility.h"
+
+JSTD_START
+
+inline constexpr STD size_t cacheLineSize = 64;
+inline constexpr STD size_t pageSize = 4096;
+inline constexpr STD size_t hugePageSize = STD size_t(2) << 20;
+
+/*
+* Allocator whose blocks start on an Align byte boundary, e.g. a cache line for SIMD loops.
+*
+* With HugePageThreshold != 0, blocks of at least that many bytes are mapped directly with
+* mmap, aligned to 2 MiB and marked MADV_HUGEPAGE, so the kernel can back them with
+* transparent huge pages and cut TLB misses on very large vectors. Only on Linux;
+* elsewhere the threshold is ignored and operator new is used.
+*/
+template <typename T, STD size_t Align = cacheLineSize, STD size_t HugePageThreshold = 0>
+class AlignedAllocator
+{
+public:
+
+	static_assert(!STD is_const_v<T>, "The C++ Standard forbids containers of const elements "
+									  "because allocator<const T> is ill-formed.");
+	static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of two.");
+
+	using value_type = T;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+
+	using propagate_on_container_move_assignment = STD true_type;
+	using is_always_equal = STD true_type;
+
+	static constexpr STD size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+
+	template <typename T2>
+	struct rebind
+	{
+		using other = AlignedAllocator<T2, Align, HugePageThreshold>;
+	};
+
+	AlignedAllocator() = default;
+
+	AlignedAllocator(const AlignedAllocator&) = default;
+
+	template <typename T2>
+	AlignedAllocator(const AlignedAllocator<T2, Align, HugePageThreshold>&) noexcept { }
+
+	AlignedAllocator& operator=(const AlignedAllocator&) = default;
+
+	~AlignedAllocator() = default;
+
+	NODISCARD T* allocate(size_type n)
+	{
+		if (n > max_size())
+		{
+			throw STD bad_array_new_length();
+		}
+
+		const STD size_t bytes = n * sizeof(T);
+		if (useHugePages(bytes))
+		{
+			return static_cast<T*>(mapHugePages(bytes));
+		}
+
+		return static_cast<T*>(::operator new(bytes, static_cast<STD align_val_t>(alignment)));
+	}
+
+	void deallocate(T* ptr, size_type n) JLIBCXX_NOEXCEPT
+	{
+		const STD size_t bytes = n * sizeof(T);
+		if (useHugePages(bytes))
+		{
+			unmapHugePages(ptr, bytes);
+			return;
+		}
+
+		::operator delete(ptr, bytes, static_cast<STD align_val_t>(alignment));
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD numeric_limits<size_type>::max() / sizeof(T);
+	}
+
+	template <typename T2>
+	friend bool operator==(const AlignedAllocator&, const AlignedAllocator<T2, Align, HugePageThreshold>&) JLIBCXX_NOEXCEPT
+	{
+		return true;
+	}
+
+private:
+
+	// The decision only depends on the size, so deallocate takes the same path as allocate.
+	static constexpr bool useHugePages(const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+#ifdef __linux__
+		return HugePageThreshold != 0 && alignment <= hugePageSize && bytes >= HugePageThreshold;
+#else
+		(void)bytes;
+		return false;
+#endif // __linux__
+	}
+
+	static constexpr STD size_t mappingLength(const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		return (bytes + hugePageSize - 1) & ~(hugePageSize - 1);
+	}
+
+#ifdef __linux__
+	/*
+	* Over-map by one huge page and trim both ends, which leaves a mapping of exactly
+	* mappingLength(bytes) starting on a 2 MiB boundary.
+	*/
+	static void* mapHugePages(const STD size_t bytes)
+	{
+		const STD size_t length = mappingLength(bytes);
+		if (length < bytes || length > STD numeric_limits<STD size_t>::max() - hugePageSize)
+		{
+			throw STD bad_alloc();
+		}
+
+		void* raw = ::mmap(nullptr, length + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == MAP_FAILED)
+		{
+			throw STD bad_alloc();
+		}
+
+		const auto start = reinterpret_cast<STD uintptr_t>(raw);
+		const auto aligned = (start + hugePageSize - 1) & ~(static_cast<STD uintptr_t>(hugePageSize) - 1);
+		const STD size_t head = aligned - start;
+		const STD size_t tail = hugePageSize - head;
+		if (head)
+		{
+			::munmap(raw, head);
+		}
+
+		if (tail)
+		{
+			::munmap(reinterpret_cast<void*>(aligned + length), tail);
+		}
+
+		void* result = reinterpret_cast<void*>(aligned);
+
+		// Only a hint, the mapping works without huge pages too.
+		::madvise(result, length, MADV_HUGEPAGE);
+		return result;
+	}
+
+	static void unmapHugePages(void* ptr, const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		::munmap(ptr, mappingLength(bytes));
+	}
+#else
+	static void* mapHugePages(STD size_t)
+	{
+		throw STD bad_alloc();
+	}
+
+	static void unmapHugePages(void*, STD size_t) JLIBCXX_NOEXCEPT { }
+#endif // __linux__
+};
+
+template <typename T>
+using CacheAlignedAllocator = AlignedAllocator<T, cacheLineSize>;
+
+template <typename T>
+using PageAlignedAllocator = AlignedAllocator<T, pageSize>;
+
+// Page aligned, mappings of 2 MiB and more are backed by transparent huge pages.
+template <typename T>
+using HugePageAllocator = AlignedAllocator<T, pageSize, hugePageSize>;
+
+// construct and destroy are the allocator_traits defaults.
+template <typename T, STD size_t Align, STD size_t HugePageThreshold>
+struct is_default_construct_allocator<AlignedAllocator<T, Align, HugePageThreshold>> : STD true_type {};
+
+JSTD_END
+
+#endif // !ALIGNED_ALLOCATOR
@@ -2,9 +2,15 @@
 #ifndef ALLOCATOR
 #define ALLOCATOR
 
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <limits>
 
+#include "Config.h"
+#include "Utility.h"
+
 JSTD_START
 
 template <typename T>
@@ -29,7 +35,7 @@ public:
 
 	AllocatorBase() = default;
 
-	AllocatorBase(AllocatorBase&) noexcept { }
+	AllocatorBase(const AllocatorBase&) noexcept { }
 
 	template <typename T2>
 	AllocatorBase(const AllocatorBase<T2>&) noexcept { }
@@ -51,14 +57,21 @@ public:
 		return static_cast<T*>(::operator new(size * sizeof(T)));
 	}
 
-	void deallocate(T* p, size_type size)
+	void deallocate(T* p, size_type size) noexcept
 	{
+		if (!p)
+		{
+			return;
+		}
+
 		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
 		{
 			::operator delete(p, size * sizeof(T), static_cast<std::align_val_t>(alignof(T)));
 		}
-
-		::operator delete(p, size * sizeof(T));
+		else
+		{
+			::operator delete(p, size * sizeof(T));
+		}
 	}
 
 	NODISCARD size_type max_size() const noexcept
@@ -153,6 +166,13 @@ operator!=(const MyAllocator<T1>&, const MyAllocator<T2>&) noexcept
 	return false;
 }
 
+// construct and destroy are placement new and ~T().
+template <typename T>
+struct is_default_construct_allocator<AllocatorBase<T>> : STD true_type {};
+
+template <typename T>
+struct is_default_construct_allocator<MyAllocator<T>> : STD true_type {};
+
 JSTD_END
 
 #endif // !ALLOCATOR
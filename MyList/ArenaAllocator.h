@@ -0,0 +1,272 @@
+#pragma once
+#ifndef ARENA_ALLOCATOR
+#define ARENA_ALLOCATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "Config.h"
+#include "Utility.h"
+
+JSTD_START
+
+/*
+* Where a BasicMonotonicArena gets its chunks: the global operator new.
+* Any other source provides the same two members, see pmr::MonotonicBufferResource.
+*/
+struct NewDeleteChunks
+{
+	NODISCARD void* allocateChunk(const STD size_t bytes)
+	{
+		return ::operator new(bytes);
+	}
+
+	void deallocateChunk(void* chunk, const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		::operator delete(chunk, bytes);
+	}
+};
+
+/*
+* Bump pointer arena.
+*
+* allocate() moves a cursor through the current chunk and takes a new, twice as large
+* chunk from ChunkSource when it runs out. deallocate() does nothing, the memory of every
+* allocation is given back at once by release() or the destructor.
+* An optional initial buffer, e.g. on the stack, is used before any chunk is allocated.
+*
+* Chunks only need the alignment of operator new, stricter requests are padded inside them.
+*
+* Not thread safe. Use the MonotonicArena alias.
+*/
+template <typename ChunkSource = NewDeleteChunks>
+class BasicMonotonicArena : private ChunkSource
+{
+private:
+
+	struct ChunkHeader
+	{
+		ChunkHeader* mNext;
+		STD size_t mBytes;
+	};
+
+public:
+
+	static constexpr STD size_t defaultChunkSize = 1024;
+
+	explicit BasicMonotonicArena(const STD size_t initialChunkSize = defaultChunkSize, const ChunkSource& source = ChunkSource()) JLIBCXX_NOEXCEPT
+		: ChunkSource(source),
+		mNextChunkSize(initialChunkSize < sizeof(ChunkHeader) ? defaultChunkSize : initialChunkSize)
+	{ }
+
+	BasicMonotonicArena(void* buffer, const STD size_t bytes, const ChunkSource& source = ChunkSource()) JLIBCXX_NOEXCEPT
+		: ChunkSource(source),
+		mCursor(static_cast<unsigned char*>(buffer)),
+		mEnd(static_cast<unsigned char*>(buffer) + bytes),
+		mInitialBuffer(buffer),
+		mInitialBytes(bytes),
+		mNextChunkSize(bytes < defaultChunkSize ? defaultChunkSize : bytes * 2)
+	{ }
+
+	BasicMonotonicArena(const BasicMonotonicArena&) = delete;
+
+	BasicMonotonicArena& operator=(const BasicMonotonicArena&) = delete;
+
+	~BasicMonotonicArena()
+	{
+		release();
+	}
+
+	NODISCARD void* allocate(const STD size_t bytes, const STD size_t alignment = alignof(STD max_align_t))
+	{
+		void* result = alignCursor(bytes, alignment);
+		if (!result)
+		{
+			addChunk(bytes, alignment); // Throw
+			result = alignCursor(bytes, alignment);
+		}
+
+		mCursor = static_cast<unsigned char*>(result) + bytes;
+		return result;
+	}
+
+	// Individual blocks are never reused.
+	void deallocate(void*, STD size_t, STD size_t = alignof(STD max_align_t)) JLIBCXX_NOEXCEPT { }
+
+	/*
+	* Free every chunk and rewind to the initial buffer.
+	* All memory handed out so far becomes invalid.
+	*/
+	void release() JLIBCXX_NOEXCEPT
+	{
+		while (mChunks)
+		{
+			ChunkHeader* next = mChunks->mNext;
+			ChunkSource::deallocateChunk(static_cast<void*>(mChunks), mChunks->mBytes);
+			mChunks = next;
+		}
+
+		mCursor = static_cast<unsigned char*>(mInitialBuffer);
+		mEnd = mCursor + mInitialBytes;
+		mAllocatedChunkBytes = 0;
+	}
+
+	// Bytes obtained from ChunkSource and not yet released.
+	NODISCARD STD size_t chunk_bytes() const JLIBCXX_NOEXCEPT
+	{
+		return mAllocatedChunkBytes;
+	}
+
+	NODISCARD const ChunkSource& chunk_source() const JLIBCXX_NOEXCEPT
+	{
+		return *this;
+	}
+
+private:
+
+	// The aligned address for bytes in the current chunk, or null if they do not fit.
+	void* alignCursor(const STD size_t bytes, const STD size_t alignment) const JLIBCXX_NOEXCEPT
+	{
+		if (!mCursor)
+		{
+			return nullptr;
+		}
+
+		const auto address = reinterpret_cast<STD uintptr_t>(mCursor);
+		const auto aligned = (address + alignment - 1) & ~(static_cast<STD uintptr_t>(alignment) - 1);
+		const auto available = static_cast<STD size_t>(mEnd - mCursor);
+		const auto padding = static_cast<STD size_t>(aligned - address);
+		if (padding > available || bytes > available - padding)
+		{
+			return nullptr;
+		}
+
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	void addChunk(const STD size_t bytes, const STD size_t alignment)
+	{
+		if (bytes > STD numeric_limits<STD size_t>::max() / 2 - alignment - sizeof(ChunkHeader))
+		{
+			throw STD bad_alloc();
+		}
+
+		const STD size_t needed = sizeof(ChunkHeader) + alignment + bytes;
+		const STD size_t size = needed > mNextChunkSize ? needed : mNextChunkSize;
+
+		void* memory = ChunkSource::allocateChunk(size); // Throw
+		mChunks = ::new(memory) ChunkHeader{ mChunks, size };
+		mCursor = static_cast<unsigned char*>(memory) + sizeof(ChunkHeader);
+		mEnd = static_cast<unsigned char*>(memory) + size;
+		mAllocatedChunkBytes += size;
+
+		mNextChunkSize = size <= STD numeric_limits<STD size_t>::max() / 2 ? size * 2 : size;
+	}
+
+	unsigned char* mCursor = nullptr;
+	unsigned char* mEnd = nullptr;
+	ChunkHeader* mChunks = nullptr;
+	void* mInitialBuffer = nullptr;
+	STD size_t mInitialBytes = 0;
+	STD size_t mNextChunkSize;
+	STD size_t mAllocatedChunkBytes = 0;
+};
+
+using MonotonicArena = BasicMonotonicArena<>;
+
+/*
+* Allocator handle to a MonotonicArena.
+*
+* Stateful: two handles compare equal when they refer to the same arena. The handle
+* travels with the elements on copy assignment, move assignment and swap, so a container
+* never frees into an arena it did not allocate from. The arena must outlive every
+* container using it.
+*/
+template <typename T>
+class ArenaAllocator
+{
+public:
+
+	static_assert(!STD is_const_v<T>, "The C++ Standard forbids containers of const elements "
+									  "because allocator<const T> is ill-formed.");
+
+	using value_type = T;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+
+	using propagate_on_container_copy_assignment = STD true_type;
+	using propagate_on_container_move_assignment = STD true_type;
+	using propagate_on_container_swap = STD true_type;
+	using is_always_equal = STD false_type;
+
+	template <typename T2>
+	struct rebind
+	{
+		using other = ArenaAllocator<T2>;
+	};
+
+	ArenaAllocator(MonotonicArena& arena) JLIBCXX_NOEXCEPT
+		: mArena(STD addressof(arena))
+	{ }
+
+	ArenaAllocator(const ArenaAllocator&) = default;
+
+	template <typename T2>
+	ArenaAllocator(const ArenaAllocator<T2>& other) JLIBCXX_NOEXCEPT
+		: mArena(other.arena())
+	{ }
+
+	ArenaAllocator& operator=(const ArenaAllocator&) = default;
+
+	~ArenaAllocator() = default;
+
+	NODISCARD T* allocate(size_type n)
+	{
+		if (n > max_size())
+		{
+			throw STD bad_array_new_length();
+		}
+
+		return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_type n) JLIBCXX_NOEXCEPT
+	{
+		mArena->deallocate(ptr, n * sizeof(T), alignof(T));
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD numeric_limits<size_type>::max() / sizeof(T);
+	}
+
+	NODISCARD MonotonicArena* arena() const JLIBCXX_NOEXCEPT
+	{
+		return mArena;
+	}
+
+	template <typename T2>
+	friend bool operator==(const ArenaAllocator& left, const ArenaAllocator<T2>& right) JLIBCXX_NOEXCEPT
+	{
+		return left.arena() == right.arena();
+	}
+
+private:
+
+	MonotonicArena* mArena;
+};
+
+// construct and destroy are the allocator_traits defaults.
+template <typename T>
+struct is_default_construct_allocator<ArenaAllocator<T>> : STD true_type {};
+
+JSTD_END
+
+#endif // !ARENA_ALLOCATOR
@@ -9,6 +9,7 @@
 #include <stdexcept>
 
 #include "Healper.h"
+#include "Utility.h"
 
 JSTD_START
 
@@ -98,6 +99,16 @@ public:
 
     constexpr void swap(Array& other) noexcept(Traits::is_nothrow_swappable_v())
     {
+        // Trivially relocatable elements are exchanged as raw bytes.
+        if constexpr (N != 0 && is_trivially_relocatable_v<T>)
+        {
+            if (!STD is_constant_evaluated())
+            {
+                swapBytes(data(), other.data(), sizeof(T) * N);
+                return;
+            }
+        }
+
         STD swap_ranges(begin(), end(), other.begin());
     }
 
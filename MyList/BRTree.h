@@ -1 +1,3131 @@
 #pragma once
+#ifndef BRTREE
+#define BRTREE
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+
+JSTD_START
+
+enum class RbColor : bool
+{
+	Red = false,
+	Black = true
+};
+
+/*
+* Links of a red-black tree node, without the value.
+*/
+class RbNodeBase
+{
+public:
+
+	RbColor mColor;
+
+	RbNodeBase* mParent;
+
+	RbNodeBase* mLeft;
+
+	RbNodeBase* mRight;
+
+	static RbNodeBase* minimum(RbNodeBase* node) JLIBCXX_NOEXCEPT
+	{
+		while (node->mLeft)
+		{
+			node = node->mLeft;
+		}
+
+		return node;
+	}
+
+	static RbNodeBase* maximum(RbNodeBase* node) JLIBCXX_NOEXCEPT
+	{
+		while (node->mRight)
+		{
+			node = node->mRight;
+		}
+
+		return node;
+	}
+};
+
+/*
+* Sentinel of a tree, same idea as ListNodeHeader.
+*
+* mHeader.mParent is the root, mHeader.mLeft the leftmost and mHeader.mRight the
+* rightmost node, so begin() and --end() are O(1). The header is red and is the
+* root's parent, which is how decrementing end() finds it.
+*/
+class RbTreeHeader
+{
+public:
+
+	RbNodeBase mHeader;
+
+	STD size_t mNodeCount;
+
+	RbTreeHeader() JLIBCXX_NOEXCEPT
+	{
+		mHeader.mColor = RbColor::Red;
+		resetAllMembers();
+	}
+
+	RbTreeHeader(RbTreeHeader&& other) JLIBCXX_NOEXCEPT
+	{
+		if (other.mHeader.mParent)
+		{
+			moveData(other);
+			return;
+		}
+
+		mHeader.mColor = RbColor::Red;
+		resetAllMembers();
+	}
+
+	// Take the nodes of other, which must not be empty, and leave it empty.
+	void moveData(RbTreeHeader& other) JLIBCXX_NOEXCEPT
+	{
+		mHeader.mColor = other.mHeader.mColor;
+		mHeader.mParent = other.mHeader.mParent;
+		mHeader.mLeft = other.mHeader.mLeft;
+		mHeader.mRight = other.mHeader.mRight;
+		mHeader.mParent->mParent = &mHeader;
+		mNodeCount = other.mNodeCount;
+
+		other.resetAllMembers();
+	}
+
+	void resetAllMembers() JLIBCXX_NOEXCEPT
+	{
+		mHeader.mParent = nullptr;
+		mHeader.mLeft = &mHeader;
+		mHeader.mRight = &mHeader;
+		mNodeCount = 0;
+	}
+
+	void swapData(RbTreeHeader& other) JLIBCXX_NOEXCEPT
+	{
+		if (!mHeader.mParent)
+		{
+			if (other.mHeader.mParent)
+			{
+				moveData(other);
+			}
+
+			return;
+		}
+
+		if (!other.mHeader.mParent)
+		{
+			other.moveData(*this);
+			return;
+		}
+
+		STD swap(mHeader.mParent, other.mHeader.mParent);
+		STD swap(mHeader.mLeft, other.mHeader.mLeft);
+		STD swap(mHeader.mRight, other.mHeader.mRight);
+		mHeader.mParent->mParent = &mHeader;
+		other.mHeader.mParent->mParent = &other.mHeader;
+		STD swap(mNodeCount, other.mNodeCount);
+	}
+};
+
+// A node with its value. The value is built by the allocator, so the node holds raw storage.
+template <typename T>
+class RbNode : public RbNodeBase
+{
+public:
+
+	T* valuePtr() JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<T*>(mStorage));
+	}
+
+	const T* valuePtr() const JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<const T*>(mStorage));
+	}
+
+	T& valueRef() JLIBCXX_NOEXCEPT
+	{
+		return *valuePtr();
+	}
+
+	const T& valueRef() const JLIBCXX_NOEXCEPT
+	{
+		return *valuePtr();
+	}
+
+private:
+
+	alignas(T) unsigned char mStorage[sizeof(T)];
+};
+
+inline RbNodeBase* rbTreeIncrement(RbNodeBase* node) JLIBCXX_NOEXCEPT
+{
+	if (node->mRight)
+	{
+		return RbNodeBase::minimum(node->mRight);
+	}
+
+	RbNodeBase* parent = node->mParent;
+	while (node == parent->mRight)
+	{
+		node = parent;
+		parent = parent->mParent;
+	}
+
+	// Incrementing the rightmost node of a one node tree stops at the header.
+	return node->mRight != parent ? parent : node;
+}
+
+inline RbNodeBase* rbTreeDecrement(RbNodeBase* node) JLIBCXX_NOEXCEPT
+{
+	// end() is the header, step to the rightmost node.
+	if (node->mColor == RbColor::Red && node->mParent->mParent == node)
+	{
+		return node->mRight;
+	}
+
+	if (node->mLeft)
+	{
+		return RbNodeBase::maximum(node->mLeft);
+	}
+
+	RbNodeBase* parent = node->mParent;
+	while (node == parent->mLeft)
+	{
+		node = parent;
+		parent = parent->mParent;
+	}
+
+	return parent;
+}
+
+inline void rbTreeRotateLeft(RbNodeBase* const node, RbNodeBase*& root) JLIBCXX_NOEXCEPT
+{
+	RbNodeBase* const right = node->mRight;
+
+	node->mRight = right->mLeft;
+	if (right->mLeft)
+	{
+		right->mLeft->mParent = node;
+	}
+
+	right->mParent = node->mParent;
+	if (node == root)
+	{
+		root = right;
+	}
+	else if (node == node->mParent->mLeft)
+	{
+		node->mParent->mLeft = right;
+	}
+	else
+	{
+		node->mParent->mRight = right;
+	}
+
+	right->mLeft = node;
+	node->mParent = right;
+}
+
+inline void rbTreeRotateRight(RbNodeBase* const node, RbNodeBase*& root) JLIBCXX_NOEXCEPT
+{
+	RbNodeBase* const left = node->mLeft;
+
+	node->mLeft = left->mRight;
+	if (left->mRight)
+	{
+		left->mRight->mParent = node;
+	}
+
+	left->mParent = node->mParent;
+	if (node == root)
+	{
+		root = left;
+	}
+	else if (node == node->mParent->mRight)
+	{
+		node->mParent->mRight = left;
+	}
+	else
+	{
+		node->mParent->mLeft = left;
+	}
+
+	left->mRight = node;
+	node->mParent = left;
+}
+
+// Link node as the left or right child of parent and restore the red-black properties.
+inline void rbTreeInsertAndRebalance(const bool insertLeft, RbNodeBase* node, RbNodeBase* parent, RbNodeBase& header) JLIBCXX_NOEXCEPT
+{
+	RbNodeBase*& root = header.mParent;
+
+	node->mParent = parent;
+	node->mLeft = nullptr;
+	node->mRight = nullptr;
+	node->mColor = RbColor::Red;
+
+	// parent == &header only happens for the first node, which goes left.
+	if (insertLeft)
+	{
+		parent->mLeft = node;
+		if (parent == &header)
+		{
+			header.mParent = node;
+			header.mRight = node;
+		}
+		else if (parent == header.mLeft)
+		{
+			header.mLeft = node;
+		}
+	}
+	else
+	{
+		parent->mRight = node;
+		if (parent == header.mRight)
+		{
+			header.mRight = node;
+		}
+	}
+
+	while (node != root && node->mParent->mColor == RbColor::Red)
+	{
+		RbNodeBase* const grandParent = node->mParent->mParent;
+		if (node->mParent == grandParent->mLeft)
+		{
+			RbNodeBase* const uncle = grandParent->mRight;
+			if (uncle && uncle->mColor == RbColor::Red)
+			{
+				node->mParent->mColor = RbColor::Black;
+				uncle->mColor = RbColor::Black;
+				grandParent->mColor = RbColor::Red;
+				node = grandParent;
+				continue;
+			}
+
+			if (node == node->mParent->mRight)
+			{
+				node = node->mParent;
+				rbTreeRotateLeft(node, root);
+			}
+
+			node->mParent->mColor = RbColor::Black;
+			grandParent->mColor = RbColor::Red;
+			rbTreeRotateRight(grandParent, root);
+		}
+		else
+		{
+			RbNodeBase* const uncle = grandParent->mLeft;
+			if (uncle && uncle->mColor == RbColor::Red)
+			{
+				node->mParent->mColor = RbColor::Black;
+				uncle->mColor = RbColor::Black;
+				grandParent->mColor = RbColor::Red;
+				node = grandParent;
+				continue;
+			}
+
+			if (node == node->mParent->mLeft)
+			{
+				node = node->mParent;
+				rbTreeRotateRight(node, root);
+			}
+
+			node->mParent->mColor = RbColor::Black;
+			grandParent->mColor = RbColor::Red;
+			rbTreeRotateLeft(grandParent, root);
+		}
+	}
+
+	root->mColor = RbColor::Black;
+}
+
+/*
+* Unlink target from the tree and restore the red-black properties.
+* Returns target, whose links are left dangling.
+*/
+inline RbNodeBase* rbTreeRebalanceForErase(RbNodeBase* const target, RbNodeBase& header) JLIBCXX_NOEXCEPT
+{
+	RbNodeBase*& root = header.mParent;
+	RbNodeBase*& leftmost = header.mLeft;
+	RbNodeBase*& rightmost = header.mRight;
+
+	RbNodeBase* removed = target;
+	RbNodeBase* child = nullptr;
+	RbNodeBase* childParent = nullptr;
+
+	if (!removed->mLeft)
+	{
+		child = removed->mRight;
+	}
+	else if (!removed->mRight)
+	{
+		child = removed->mLeft;
+	}
+	else
+	{
+		// Two children, the successor takes target's place.
+		removed = RbNodeBase::minimum(removed->mRight);
+		child = removed->mRight;
+	}
+
+	if (removed != target)
+	{
+		target->mLeft->mParent = removed;
+		removed->mLeft = target->mLeft;
+		if (removed != target->mRight)
+		{
+			childParent = removed->mParent;
+			if (child)
+			{
+				child->mParent = removed->mParent;
+			}
+
+			removed->mParent->mLeft = child;
+			removed->mRight = target->mRight;
+			target->mRight->mParent = removed;
+		}
+		else
+		{
+			childParent = removed;
+		}
+
+		if (root == target)
+		{
+			root = removed;
+		}
+		else if (target->mParent->mLeft == target)
+		{
+			target->mParent->mLeft = removed;
+		}
+		else
+		{
+			target->mParent->mRight = removed;
+		}
+
+		removed->mParent = target->mParent;
+		STD swap(removed->mColor, target->mColor);
+
+		// From here on removed is the position that lost a node.
+		removed = target;
+	}
+	else
+	{
+		childParent = removed->mParent;
+		if (child)
+		{
+			child->mParent = removed->mParent;
+		}
+
+		if (root == target)
+		{
+			root = child;
+		}
+		else if (target->mParent->mLeft == target)
+		{
+			target->mParent->mLeft = child;
+		}
+		else
+		{
+			target->mParent->mRight = child;
+		}
+
+		if (leftmost == target)
+		{
+			leftmost = target->mRight ? RbNodeBase::minimum(child) : target->mParent;
+		}
+
+		if (rightmost == target)
+		{
+			rightmost = target->mLeft ? RbNodeBase::maximum(child) : target->mParent;
+		}
+	}
+
+	if (removed->mColor == RbColor::Red)
+	{
+		return target;
+	}
+
+	while (child != root && (!child || child->mColor == RbColor::Black))
+	{
+		if (child == childParent->mLeft)
+		{
+			RbNodeBase* sibling = childParent->mRight;
+			if (sibling->mColor == RbColor::Red)
+			{
+				sibling->mColor = RbColor::Black;
+				childParent->mColor = RbColor::Red;
+				rbTreeRotateLeft(childParent, root);
+				sibling = childParent->mRight;
+			}
+
+			if ((!sibling->mLeft || sibling->mLeft->mColor == RbColor::Black)
+				&& (!sibling->mRight || sibling->mRight->mColor == RbColor::Black))
+			{
+				sibling->mColor = RbColor::Red;
+				child = childParent;
+				childParent = childParent->mParent;
+				continue;
+			}
+
+			if (!sibling->mRight || sibling->mRight->mColor == RbColor::Black)
+			{
+				sibling->mLeft->mColor = RbColor::Black;
+				sibling->mColor = RbColor::Red;
+				rbTreeRotateRight(sibling, root);
+				sibling = childParent->mRight;
+			}
+
+			sibling->mColor = childParent->mColor;
+			childParent->mColor = RbColor::Black;
+			if (sibling->mRight)
+			{
+				sibling->mRight->mColor = RbColor::Black;
+			}
+
+			rbTreeRotateLeft(childParent, root);
+			break;
+		}
+		else
+		{
+			RbNodeBase* sibling = childParent->mLeft;
+			if (sibling->mColor == RbColor::Red)
+			{
+				sibling->mColor = RbColor::Black;
+				childParent->mColor = RbColor::Red;
+				rbTreeRotateRight(childParent, root);
+				sibling = childParent->mLeft;
+			}
+
+			if ((!sibling->mRight || sibling->mRight->mColor == RbColor::Black)
+				&& (!sibling->mLeft || sibling->mLeft->mColor == RbColor::Black))
+			{
+				sibling->mColor = RbColor::Red;
+				child = childParent;
+				childParent = childParent->mParent;
+				continue;
+			}
+
+			if (!sibling->mLeft || sibling->mLeft->mColor == RbColor::Black)
+			{
+				sibling->mRight->mColor = RbColor::Black;
+				sibling->mColor = RbColor::Red;
+				rbTreeRotateLeft(sibling, root);
+				sibling = childParent->mLeft;
+			}
+
+			sibling->mColor = childParent->mColor;
+			childParent->mColor = RbColor::Black;
+			if (sibling->mLeft)
+			{
+				sibling->mLeft->mColor = RbColor::Black;
+			}
+
+			rbTreeRotateRight(childParent, root);
+			break;
+		}
+	}
+
+	if (child)
+	{
+		child->mColor = RbColor::Black;
+	}
+
+	return target;
+}
+
+template <typename T>
+class RbTreeIterator
+{
+public:
+
+	using Node = RbNode<T>;
+	using difference_type = STD ptrdiff_t;
+	using iterator_category = STD bidirectional_iterator_tag;
+	using value_type = T;
+	using pointer = T*;
+	using reference = T&;
+
+	RbTreeIterator() JLIBCXX_NOEXCEPT
+		: mNode()
+	{ }
+
+	explicit RbTreeIterator(RbNodeBase* node) JLIBCXX_NOEXCEPT
+		: mNode(node)
+	{ }
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<Node*>(mNode)->valueRef();
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<Node*>(mNode)->valuePtr();
+	}
+
+	RbTreeIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		mNode = rbTreeIncrement(mNode);
+		return *this;
+	}
+
+	RbTreeIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		RbTreeIterator temp = *this;
+		mNode = rbTreeIncrement(mNode);
+		return temp;
+	}
+
+	RbTreeIterator& operator--() JLIBCXX_NOEXCEPT
+	{
+		mNode = rbTreeDecrement(mNode);
+		return *this;
+	}
+
+	RbTreeIterator operator--(int) JLIBCXX_NOEXCEPT
+	{
+		RbTreeIterator temp = *this;
+		mNode = rbTreeDecrement(mNode);
+		return temp;
+	}
+
+	friend bool operator==(const RbTreeIterator& left, const RbTreeIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mNode == right.mNode;
+	}
+
+	friend bool operator!=(const RbTreeIterator& left, const RbTreeIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mNode != right.mNode;
+	}
+
+	RbNodeBase* mNode;
+};
+
+template <typename T>
+class RbTreeConstIterator
+{
+public:
+
+	using Node = const RbNode<T>;
+	using difference_type = STD ptrdiff_t;
+	using iterator_category = STD bidirectional_iterator_tag;
+	using value_type = T;
+	using pointer = const T*;
+	using reference = const T&;
+	using iterator = RbTreeIterator<T>;
+
+	RbTreeConstIterator() JLIBCXX_NOEXCEPT
+		: mNode()
+	{ }
+
+	explicit RbTreeConstIterator(const RbNodeBase* node) JLIBCXX_NOEXCEPT
+		: mNode(node)
+	{ }
+
+	RbTreeConstIterator(const iterator& other) JLIBCXX_NOEXCEPT
+		: mNode(other.mNode)
+	{ }
+
+	iterator constCast() const JLIBCXX_NOEXCEPT
+	{
+		return iterator(const_cast<RbNodeBase*>(mNode));
+	}
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<Node*>(mNode)->valueRef();
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<Node*>(mNode)->valuePtr();
+	}
+
+	RbTreeConstIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		mNode = rbTreeIncrement(const_cast<RbNodeBase*>(mNode));
+		return *this;
+	}
+
+	RbTreeConstIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		RbTreeConstIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	RbTreeConstIterator& operator--() JLIBCXX_NOEXCEPT
+	{
+		mNode = rbTreeDecrement(const_cast<RbNodeBase*>(mNode));
+		return *this;
+	}
+
+	RbTreeConstIterator operator--(int) JLIBCXX_NOEXCEPT
+	{
+		RbTreeConstIterator temp = *this;
+		--*this;
+		return temp;
+	}
+
+	friend bool operator==(const RbTreeConstIterator& left, const RbTreeConstIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mNode == right.mNode;
+	}
+
+	friend bool operator!=(const RbTreeConstIterator& left, const RbTreeConstIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mNode != right.mNode;
+	}
+
+	const RbNodeBase* mNode;
+};
+
+/*
+* Owns a node taken out of a tree by extract, so it can be reinserted without allocating.
+* key() and mapped() are there for maps, value() for sets.
+*/
+template <typename Value, typename NodeAlloc>
+class RbNodeHandle
+{
+private:
+
+	using Node_Alloc_Traits = MyAlloctTraits<NodeAlloc>;
+	using Node = RbNode<Value>;
+
+	template <typename, typename, typename, typename, typename>
+	friend class RbTree;
+
+	template <typename V>
+	struct PairTraits
+	{
+		using key_type = void;
+		using mapped_type = void;
+	};
+
+	template <typename K, typename M>
+	struct PairTraits<STD pair<const K, M>>
+	{
+		using key_type = K;
+		using mapped_type = M;
+	};
+
+public:
+
+	using value_type = Value;
+	using allocator_type = typename MyAlloctTraits<NodeAlloc>:: template rebind<Value>::other;
+
+	constexpr RbNodeHandle() JLIBCXX_NOEXCEPT
+		: mNode(nullptr)
+	{ }
+
+	RbNodeHandle(RbNodeHandle&& other) JLIBCXX_NOEXCEPT
+		: mNode(other.mNode), mAlloc(STD move(other.mAlloc))
+	{
+		other.mNode = nullptr;
+		other.mAlloc.reset();
+	}
+
+	RbNodeHandle& operator=(RbNodeHandle&& other) JLIBCXX_NOEXCEPT
+	{
+		dropNode();
+		mNode = other.mNode;
+		other.mNode = nullptr;
+
+		if (!mAlloc || Node_Alloc_Traits::propagate_on_move_assign_v())
+		{
+			mAlloc = STD move(other.mAlloc);
+		}
+
+		other.mAlloc.reset();
+		return *this;
+	}
+
+	~RbNodeHandle() JLIBCXX_NOEXCEPT
+	{
+		dropNode();
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return mNode == nullptr;
+	}
+
+	explicit operator bool() const JLIBCXX_NOEXCEPT
+	{
+		return mNode != nullptr;
+	}
+
+	NODISCARD allocator_type get_allocator() const
+	{
+		return allocator_type(*mAlloc);
+	}
+
+	template <typename V = Value, typename = STD enable_if_t<STD is_void_v<typename PairTraits<V>::key_type>>>
+	NODISCARD V& value() const JLIBCXX_NOEXCEPT
+	{
+		return mNode->valueRef();
+	}
+
+	// The key is const inside the tree, but nobody else can see this node.
+	template <typename V = Value, typename K = typename PairTraits<V>::key_type,
+		typename = STD enable_if_t<!STD is_void_v<K>>>
+	NODISCARD K& key() const JLIBCXX_NOEXCEPT
+	{
+		return const_cast<K&>(mNode->valueRef().first);
+	}
+
+	template <typename V = Value, typename M = typename PairTraits<V>::mapped_type,
+		typename = STD enable_if_t<!STD is_void_v<M>>>
+	NODISCARD M& mapped() const JLIBCXX_NOEXCEPT
+	{
+		return mNode->valueRef().second;
+	}
+
+	void swap(RbNodeHandle& other) JLIBCXX_NOEXCEPT
+	{
+		STD swap(mNode, other.mNode);
+		if (!mAlloc || !other.mAlloc || Node_Alloc_Traits::propagate_on_swap_v())
+		{
+			mAlloc.swap(other.mAlloc);
+		}
+	}
+
+	friend void swap(RbNodeHandle& left, RbNodeHandle& right) JLIBCXX_NOEXCEPT
+	{
+		left.swap(right);
+	}
+
+private:
+
+	RbNodeHandle(Node* node, const NodeAlloc& alloc) JLIBCXX_NOEXCEPT
+		: mNode(node), mAlloc(alloc)
+	{ }
+
+	Node* release() JLIBCXX_NOEXCEPT
+	{
+		Node* node = mNode;
+		mNode = nullptr;
+		mAlloc.reset();
+		return node;
+	}
+
+	void dropNode() JLIBCXX_NOEXCEPT
+	{
+		if (mNode)
+		{
+			Node_Alloc_Traits::destroy(*mAlloc, mNode->valuePtr());
+			Node_Alloc_Traits::deallocate(*mAlloc, mNode, 1);
+			mNode = nullptr;
+		}
+	}
+
+	Node* mNode;
+	STD optional<NodeAlloc> mAlloc;
+};
+
+template <typename Iterator, typename NodeHandle>
+struct RbInsertReturn
+{
+	Iterator position;
+	bool inserted;
+	NodeHandle node;
+};
+
+/*
+* Red-black tree behind Map, Set, MultiMap and MultiSet.
+*
+* Value is what a node stores, KeyOfValue picks the Key out of it.
+* The *Unique functions reject a key that is already there, the *Equal ones add it after its equals.
+* Lookups take any K when Compare::is_transparent is defined.
+*/
+template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc = STD allocator<Value>>
+class RbTree
+{
+	template <typename, typename, typename, typename, typename>
+	friend class RbTree;
+
+protected:
+
+	using T_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Value>::other;
+	using Node_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<RbNode<Value>>::other;
+	using Node_Alloc_Traits = MyAlloctTraits<Node_Alloc_Type>;
+	using Node = RbNode<Value>;
+	using BasePtr = RbNodeBase*;
+	using ConstBasePtr = const RbNodeBase*;
+
+	static_assert(STD is_pointer_v<typename Node_Alloc_Traits::pointer>, "jstd::RbTree needs an allocator with raw pointers.");
+
+	template <typename K, typename C = Compare>
+	using RequireTransparent = STD enable_if_t<IsTransparent<C>::value, K>;
+
+public:
+
+	using key_type = Key;
+	using value_type = Value;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using allocator_type = Alloc;
+	using key_compare = Compare;
+
+	using iterator = RbTreeIterator<value_type>;
+	using const_iterator = RbTreeConstIterator<value_type>;
+	using reverse_iterator = STD reverse_iterator<iterator>;
+	using const_reverse_iterator = STD reverse_iterator<const_iterator>;
+
+	using node_type = RbNodeHandle<Value, Node_Alloc_Type>;
+	using insert_return_type = RbInsertReturn<iterator, node_type>;
+
+protected:
+
+	// The empty base optimization for the allocator.
+	struct RbTreeImpl : public Node_Alloc_Type
+	{
+		CompressedPair<Compare, RbTreeHeader> mData;
+
+		RbTreeImpl() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<Node_Alloc_Type>
+			&& STD is_nothrow_default_constructible_v<Compare>)
+			: Node_Alloc_Type(), mData(ZeroThenVariadicArgsT{})
+		{ }
+
+		RbTreeImpl(const Compare& comp, const Node_Alloc_Type& alloc)
+			: Node_Alloc_Type(alloc), mData(OneThenVariadicArgsT{}, comp)
+		{ }
+
+		RbTreeImpl(RbTreeImpl&& other) = default;
+
+		RbTreeImpl(RbTreeImpl&& other, const Node_Alloc_Type& alloc)
+			: Node_Alloc_Type(alloc), mData(OneThenVariadicArgsT{}, other.mData.first(), STD move(other.mData.second))
+		{ }
+	};
+
+	RbTreeImpl mImpl;
+
+	Node_Alloc_Type& getNodeAllocator() JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	const Node_Alloc_Type& getNodeAllocator() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	RbTreeHeader& header() JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second;
+	}
+
+	const RbTreeHeader& header() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second;
+	}
+
+	BasePtr endNode() JLIBCXX_NOEXCEPT
+	{
+		return &header().mHeader;
+	}
+
+	ConstBasePtr endNode() const JLIBCXX_NOEXCEPT
+	{
+		return &header().mHeader;
+	}
+
+	BasePtr& root() JLIBCXX_NOEXCEPT
+	{
+		return header().mHeader.mParent;
+	}
+
+	BasePtr& leftmost() JLIBCXX_NOEXCEPT
+	{
+		return header().mHeader.mLeft;
+	}
+
+	BasePtr& rightmost() JLIBCXX_NOEXCEPT
+	{
+		return header().mHeader.mRight;
+	}
+
+	static const Key& keyOf(ConstBasePtr node) JLIBCXX_NOEXCEPT
+	{
+		return KeyOfValue()(static_cast<const Node*>(node)->valueRef());
+	}
+
+	static Node* asNode(BasePtr node) JLIBCXX_NOEXCEPT
+	{
+		return static_cast<Node*>(node);
+	}
+
+	template <typename K1, typename K2>
+	bool less(const K1& left, const K2& right) const
+	{
+		return mImpl.mData.first()(left, right);
+	}
+
+	Node* allocateNode()
+	{
+		return Node_Alloc_Traits::allocate(getNodeAllocator(), 1);
+	}
+
+	void deallocateNode(Node* node) JLIBCXX_NOEXCEPT
+	{
+		Node_Alloc_Traits::deallocate(getNodeAllocator(), node, 1);
+	}
+
+	// The value is constructed through the node allocator's traits, so an allocator's own construct() is honoured.
+	template <typename... Args>
+	Node* createNode(Args&&... args)
+	{
+		Node* node = allocateNode();
+
+		TRY_START
+		Node_Alloc_Traits::construct(getNodeAllocator(), node->valuePtr(), STD forward<Args>(args)...);
+		CATCH_ALL
+		deallocateNode(node);
+		THROW_AGAIN
+		END_CATCH
+
+		return node;
+	}
+
+	void dropNode(Node* node) JLIBCXX_NOEXCEPT
+	{
+		Node_Alloc_Traits::destroy(getNodeAllocator(), node->valuePtr());
+		deallocateNode(node);
+	}
+
+	template <bool MoveValues, typename NodePtr>
+	Node* cloneNode(NodePtr source)
+	{
+		Node* node;
+		if constexpr (MoveValues)
+		{
+			node = createNode(STD move(const_cast<Value&>(source->valueRef())));
+		}
+		else
+		{
+			node = createNode(source->valueRef());
+		}
+
+		node->mColor = source->mColor;
+		node->mLeft = nullptr;
+		node->mRight = nullptr;
+		return node;
+	}
+
+	// Copy the subtree at source below parent. Recurses on right children, loops on left ones.
+	template <bool MoveValues>
+	BasePtr copyTree(ConstBasePtr source, BasePtr parent)
+	{
+		Node* top = cloneNode<MoveValues>(static_cast<const Node*>(source));
+		top->mParent = parent;
+
+		TRY_START
+		if (source->mRight)
+		{
+			top->mRight = copyTree<MoveValues>(source->mRight, top);
+		}
+
+		parent = top;
+		source = source->mLeft;
+		while (source)
+		{
+			Node* node = cloneNode<MoveValues>(static_cast<const Node*>(source));
+			parent->mLeft = node;
+			node->mParent = parent;
+			if (source->mRight)
+			{
+				node->mRight = copyTree<MoveValues>(source->mRight, node);
+			}
+
+			parent = node;
+			source = source->mLeft;
+		}
+		CATCH_ALL
+		eraseTree(top);
+		THROW_AGAIN
+		END_CATCH
+
+		return top;
+	}
+
+	// Copy the whole of other into this empty tree.
+	template <bool MoveValues, typename OtherTree>
+	void copyFrom(OtherTree& other)
+	{
+		if (!other.header().mHeader.mParent)
+		{
+			return;
+		}
+
+		root() = copyTree<MoveValues>(other.header().mHeader.mParent, endNode());
+		leftmost() = RbNodeBase::minimum(root());
+		rightmost() = RbNodeBase::maximum(root());
+		header().mNodeCount = other.header().mNodeCount;
+	}
+
+	void eraseTree(BasePtr node) JLIBCXX_NOEXCEPT
+	{
+		while (node)
+		{
+			eraseTree(node->mRight);
+			BasePtr left = node->mLeft;
+			dropNode(asNode(node));
+			node = left;
+		}
+	}
+
+	template <typename K>
+	BasePtr lowerBoundImpl(BasePtr node, BasePtr result, const K& key) const
+	{
+		while (node)
+		{
+			if (!less(keyOf(node), key))
+			{
+				result = node;
+				node = node->mLeft;
+			}
+			else
+			{
+				node = node->mRight;
+			}
+		}
+
+		return result;
+	}
+
+	template <typename K>
+	BasePtr upperBoundImpl(BasePtr node, BasePtr result, const K& key) const
+	{
+		while (node)
+		{
+			if (less(key, keyOf(node)))
+			{
+				result = node;
+				node = node->mLeft;
+			}
+			else
+			{
+				node = node->mRight;
+			}
+		}
+
+		return result;
+	}
+
+	BasePtr mutableRoot() const JLIBCXX_NOEXCEPT
+	{
+		return const_cast<BasePtr>(header().mHeader.mParent);
+	}
+
+	BasePtr mutableEnd() const JLIBCXX_NOEXCEPT
+	{
+		return const_cast<BasePtr>(endNode());
+	}
+
+	template <typename K>
+	BasePtr findImpl(const K& key) const
+	{
+		const BasePtr result = lowerBoundImpl(mutableRoot(), mutableEnd(), key);
+		return (result == mutableEnd() || less(key, keyOf(result))) ? mutableEnd() : result;
+	}
+
+	template <typename K>
+	STD pair<BasePtr, BasePtr> equalRangeImpl(const K& key) const
+	{
+		BasePtr node = mutableRoot();
+		BasePtr result = mutableEnd();
+		while (node)
+		{
+			if (less(keyOf(node), key))
+			{
+				node = node->mRight;
+			}
+			else if (less(key, keyOf(node)))
+			{
+				result = node;
+				node = node->mLeft;
+			}
+			else
+			{
+				// Split the search: lower bound on the left, upper bound on the right.
+				return { lowerBoundImpl(node->mLeft, node, key), upperBoundImpl(node->mRight, result, key) };
+			}
+		}
+
+		return { result, result };
+	}
+
+	template <typename K>
+	size_type countImpl(const K& key) const
+	{
+		const auto range = equalRangeImpl(key);
+		return static_cast<size_type>(STD distance(const_iterator(range.first), const_iterator(range.second)));
+	}
+
+	/*
+	* Where a unique key would go.
+	* { nullptr, parent } or { parent, parent } to insert below parent,
+	* { existing, nullptr } if the key is already there.
+	*/
+	STD pair<BasePtr, BasePtr> getInsertUniquePos(const Key& key)
+	{
+		BasePtr node = root();
+		BasePtr parent = endNode();
+		bool goLeft = true;
+		while (node)
+		{
+			parent = node;
+			goLeft = less(key, keyOf(node));
+			node = goLeft ? node->mLeft : node->mRight;
+		}
+
+		iterator before(parent);
+		if (goLeft)
+		{
+			if (before == begin())
+			{
+				return { node, parent };
+			}
+
+			--before;
+		}
+
+		if (less(keyOf(before.mNode), key))
+		{
+			return { node, parent };
+		}
+
+		return { before.mNode, nullptr };
+	}
+
+	STD pair<BasePtr, BasePtr> getInsertEqualPos(const Key& key)
+	{
+		BasePtr node = root();
+		BasePtr parent = endNode();
+		while (node)
+		{
+			parent = node;
+			node = less(key, keyOf(node)) ? node->mLeft : node->mRight;
+		}
+
+		return { nullptr, parent };
+	}
+
+	// As getInsertUniquePos, O(1) when key belongs right before or after hint.
+	STD pair<BasePtr, BasePtr> getInsertHintUniquePos(const_iterator hint, const Key& key)
+	{
+		BasePtr pos = hint.constCast().mNode;
+
+		if (pos == endNode())
+		{
+			if (size() > 0 && less(keyOf(rightmost()), key))
+			{
+				return { nullptr, rightmost() };
+			}
+
+			return getInsertUniquePos(key);
+		}
+
+		if (less(key, keyOf(pos)))
+		{
+			if (pos == leftmost())
+			{
+				return { leftmost(), leftmost() };
+			}
+
+			BasePtr before = rbTreeDecrement(pos);
+			if (less(keyOf(before), key))
+			{
+				return before->mRight ? STD pair<BasePtr, BasePtr>(pos, pos) : STD pair<BasePtr, BasePtr>(nullptr, before);
+			}
+
+			return getInsertUniquePos(key);
+		}
+
+		if (less(keyOf(pos), key))
+		{
+			if (pos == rightmost())
+			{
+				return { nullptr, rightmost() };
+			}
+
+			BasePtr after = rbTreeIncrement(pos);
+			if (less(key, keyOf(after)))
+			{
+				return pos->mRight ? STD pair<BasePtr, BasePtr>(after, after) : STD pair<BasePtr, BasePtr>(nullptr, pos);
+			}
+
+			return getInsertUniquePos(key);
+		}
+
+		return { pos, nullptr };
+	}
+
+	STD pair<BasePtr, BasePtr> getInsertHintEqualPos(const_iterator hint, const Key& key)
+	{
+		BasePtr pos = hint.constCast().mNode;
+
+		if (pos == endNode())
+		{
+			if (size() > 0 && !less(key, keyOf(rightmost())))
+			{
+				return { nullptr, rightmost() };
+			}
+
+			return getInsertEqualPos(key);
+		}
+
+		if (!less(keyOf(pos), key))
+		{
+			if (pos == leftmost())
+			{
+				return { leftmost(), leftmost() };
+			}
+
+			BasePtr before = rbTreeDecrement(pos);
+			if (!less(key, keyOf(before)))
+			{
+				return before->mRight ? STD pair<BasePtr, BasePtr>(pos, pos) : STD pair<BasePtr, BasePtr>(nullptr, before);
+			}
+
+			return getInsertEqualPos(key);
+		}
+
+		if (pos == rightmost())
+		{
+			return { nullptr, rightmost() };
+		}
+
+		BasePtr after = rbTreeIncrement(pos);
+		if (!less(keyOf(after), key))
+		{
+			return pos->mRight ? STD pair<BasePtr, BasePtr>(after, after) : STD pair<BasePtr, BasePtr>(nullptr, pos);
+		}
+
+		return getInsertEqualPos(key);
+	}
+
+	// Link node at a position from getInsert*Pos. A non-null position forces the left side.
+	iterator insertNode(BasePtr position, BasePtr parent, Node* node) JLIBCXX_NOEXCEPT
+	{
+		const bool insertLeft = position != nullptr || parent == endNode() || less(keyOf(node), keyOf(parent));
+		rbTreeInsertAndRebalance(insertLeft, node, parent, header().mHeader);
+		++header().mNodeCount;
+		return iterator(node);
+	}
+
+	void eraseNode(BasePtr node) JLIBCXX_NOEXCEPT
+	{
+		dropNode(asNode(rbTreeRebalanceForErase(node, header().mHeader)));
+		--header().mNodeCount;
+	}
+
+	void clearAll() JLIBCXX_NOEXCEPT
+	{
+		eraseTree(root());
+		header().resetAllMembers();
+	}
+
+	// Move other's values one by one, for allocators that cannot take over its nodes.
+	void moveElementsFrom(RbTree& other)
+	{
+		copyFrom<true>(other);
+		other.clear();
+	}
+
+public:
+
+	RbTree() = default;
+
+	RbTree(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: mImpl(comp, Node_Alloc_Type(alloc))
+	{ }
+
+	RbTree(const RbTree& other)
+		: mImpl(other.mImpl.mData.first(), Node_Alloc_Traits::select_on_container_copy_construction(other.getNodeAllocator()))
+	{
+		copyFrom<false>(other);
+	}
+
+	RbTree(const RbTree& other, const allocator_type& alloc)
+		: mImpl(other.mImpl.mData.first(), Node_Alloc_Type(alloc))
+	{
+		copyFrom<false>(other);
+	}
+
+	RbTree(RbTree&&) = default;
+
+	RbTree(RbTree&& other, const allocator_type& alloc)
+		: mImpl(other.mImpl.mData.first(), Node_Alloc_Type(alloc))
+	{
+		if (Node_Alloc_Traits::always_equal_v() || getNodeAllocator() == other.getNodeAllocator())
+		{
+			header().swapData(other.header());
+			return;
+		}
+
+		moveElementsFrom(other);
+	}
+
+	~RbTree() JLIBCXX_NOEXCEPT
+	{
+		eraseTree(root());
+	}
+
+	RbTree& operator=(const RbTree& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		clear();
+		if constexpr (Node_Alloc_Traits::propagate_on_container_copy_assignment_v())
+		{
+			Node_Alloc_Traits::doCopy(getNodeAllocator(), other.getNodeAllocator());
+		}
+
+		mImpl.mData.first() = other.mImpl.mData.first();
+		copyFrom<false>(other);
+		return *this;
+	}
+
+	RbTree& operator=(RbTree&& other) JLIBCXX_NOEXCEPT_IF(Node_Alloc_Traits::nothrow_move() && STD is_nothrow_move_assignable_v<Compare>)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		clear();
+		mImpl.mData.first() = STD move(other.mImpl.mData.first());
+
+		if constexpr (!Node_Alloc_Traits::nothrow_move())
+		{
+			if (getNodeAllocator() != other.getNodeAllocator())
+			{
+				moveElementsFrom(other);
+				return *this;
+			}
+		}
+
+		header().swapData(other.header());
+		Node_Alloc_Traits::doMove(getNodeAllocator(), other.getNodeAllocator());
+		return *this;
+	}
+
+	NODISCARD allocator_type get_allocator() const JLIBCXX_NOEXCEPT
+	{
+		return allocator_type(getNodeAllocator());
+	}
+
+	NODISCARD key_compare key_comp() const
+	{
+		return mImpl.mData.first();
+	}
+
+	NODISCARD iterator begin() JLIBCXX_NOEXCEPT
+	{
+		return iterator(header().mHeader.mLeft);
+	}
+
+	NODISCARD const_iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return const_iterator(header().mHeader.mLeft);
+	}
+
+	NODISCARD iterator end() JLIBCXX_NOEXCEPT
+	{
+		return iterator(endNode());
+	}
+
+	NODISCARD const_iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return const_iterator(endNode());
+	}
+
+	NODISCARD reverse_iterator rbegin() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	NODISCARD const_reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(end());
+	}
+
+	NODISCARD reverse_iterator rend() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
+	NODISCARD const_reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD const_reverse_iterator crbegin() const JLIBCXX_NOEXCEPT
+	{
+		return rbegin();
+	}
+
+	NODISCARD const_reverse_iterator crend() const JLIBCXX_NOEXCEPT
+	{
+		return rend();
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return header().mNodeCount == 0;
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return header().mNodeCount;
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return Node_Alloc_Traits::max_size(getNodeAllocator());
+	}
+
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		clearAll();
+	}
+
+	void swap(RbTree& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		header().swapData(other.header());
+		using STD swap;
+		swap(mImpl.mData.first(), other.mImpl.mData.first());
+		Node_Alloc_Traits::doSwap(getNodeAllocator(), other.getNodeAllocator());
+	}
+
+	iterator erase(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		const iterator next = STD next(pos).constCast();
+		eraseNode(pos.constCast().mNode);
+		return next;
+	}
+
+	iterator erase(iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return erase(const_iterator(pos));
+	}
+
+	iterator erase(const_iterator first, const_iterator last) JLIBCXX_NOEXCEPT
+	{
+		if (first == cbegin() && last == cend())
+		{
+			clear();
+			return end();
+		}
+
+		while (first != last)
+		{
+			first = erase(first);
+		}
+
+		return last.constCast();
+	}
+
+	NODISCARD iterator find(const Key& key)
+	{
+		return iterator(findImpl(key));
+	}
+
+	NODISCARD const_iterator find(const Key& key) const
+	{
+		return const_iterator(findImpl(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator find(const K& key)
+	{
+		return iterator(findImpl(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator find(const K& key) const
+	{
+		return const_iterator(findImpl(key));
+	}
+
+	NODISCARD size_type count(const Key& key) const
+	{
+		return countImpl(key);
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD size_type count(const K& key) const
+	{
+		return countImpl(key);
+	}
+
+	NODISCARD bool contains(const Key& key) const
+	{
+		return findImpl(key) != endNode();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD bool contains(const K& key) const
+	{
+		return findImpl(key) != endNode();
+	}
+
+	NODISCARD iterator lower_bound(const Key& key)
+	{
+		return iterator(lowerBoundImpl(root(), endNode(), key));
+	}
+
+	NODISCARD const_iterator lower_bound(const Key& key) const
+	{
+		return const_iterator(lowerBoundImpl(mutableRoot(), mutableEnd(), key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key)
+	{
+		return iterator(lowerBoundImpl(root(), endNode(), key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator lower_bound(const K& key) const
+	{
+		return const_iterator(lowerBoundImpl(mutableRoot(), mutableEnd(), key));
+	}
+
+	NODISCARD iterator upper_bound(const Key& key)
+	{
+		return iterator(upperBoundImpl(root(), endNode(), key));
+	}
+
+	NODISCARD const_iterator upper_bound(const Key& key) const
+	{
+		return const_iterator(upperBoundImpl(mutableRoot(), mutableEnd(), key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key)
+	{
+		return iterator(upperBoundImpl(root(), endNode(), key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator upper_bound(const K& key) const
+	{
+		return const_iterator(upperBoundImpl(mutableRoot(), mutableEnd(), key));
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const Key& key)
+	{
+		const auto range = equalRangeImpl(key);
+		return { iterator(range.first), iterator(range.second) };
+	}
+
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const Key& key) const
+	{
+		const auto range = equalRangeImpl(key);
+		return { const_iterator(range.first), const_iterator(range.second) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key)
+	{
+		const auto range = equalRangeImpl(key);
+		return { iterator(range.first), iterator(range.second) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{
+		const auto range = equalRangeImpl(key);
+		return { const_iterator(range.first), const_iterator(range.second) };
+	}
+
+	NODISCARD node_type extract(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		BasePtr node = rbTreeRebalanceForErase(pos.constCast().mNode, header().mHeader);
+		--header().mNodeCount;
+		return node_type(asNode(node), getNodeAllocator());
+	}
+
+	NODISCARD node_type extract(const Key& key)
+	{
+		const iterator pos = find(key);
+		return pos == end() ? node_type() : extract(pos);
+	}
+
+protected:
+
+	// Insert a value whose key is known up front, without building a node when the key exists.
+	template <typename Arg>
+	STD pair<iterator, bool> insertUnique(Arg&& value)
+	{
+		const auto pos = getInsertUniquePos(KeyOfValue()(value));
+		if (!pos.second)
+		{
+			return { iterator(pos.first), false };
+		}
+
+		return { insertNode(pos.first, pos.second, createNode(STD forward<Arg>(value))), true };
+	}
+
+	template <typename Arg>
+	iterator insertHintUnique(const_iterator hint, Arg&& value)
+	{
+		const auto pos = getInsertHintUniquePos(hint, KeyOfValue()(value));
+		if (!pos.second)
+		{
+			return iterator(pos.first);
+		}
+
+		return insertNode(pos.first, pos.second, createNode(STD forward<Arg>(value)));
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplaceUnique(Args&&... args)
+	{
+		Node* node = createNode(STD forward<Args>(args)...);
+		const auto pos = getInsertUniquePos(keyOf(node));
+		if (!pos.second)
+		{
+			dropNode(node);
+			return { iterator(pos.first), false };
+		}
+
+		return { insertNode(pos.first, pos.second, node), true };
+	}
+
+	template <typename... Args>
+	iterator emplaceHintUnique(const_iterator hint, Args&&... args)
+	{
+		Node* node = createNode(STD forward<Args>(args)...);
+		const auto pos = getInsertHintUniquePos(hint, keyOf(node));
+		if (!pos.second)
+		{
+			dropNode(node);
+			return iterator(pos.first);
+		}
+
+		return insertNode(pos.first, pos.second, node);
+	}
+
+	template <typename... Args>
+	iterator emplaceEqual(Args&&... args)
+	{
+		Node* node = createNode(STD forward<Args>(args)...);
+		const auto pos = getInsertEqualPos(keyOf(node));
+		return insertNode(pos.first, pos.second, node);
+	}
+
+	template <typename... Args>
+	iterator emplaceHintEqual(const_iterator hint, Args&&... args)
+	{
+		Node* node = createNode(STD forward<Args>(args)...);
+		const auto pos = getInsertHintEqualPos(hint, keyOf(node));
+		return insertNode(pos.first, pos.second, node);
+	}
+
+	// Only builds the value if key is missing. For Map::try_emplace and operator[].
+	template <typename K, typename... Args>
+	STD pair<iterator, bool> tryEmplace(K&& key, Args&&... args)
+	{
+		const auto pos = getInsertUniquePos(key);
+		if (!pos.second)
+		{
+			return { iterator(pos.first), false };
+		}
+
+		Node* node = createNode(STD piecewise_construct,
+			STD forward_as_tuple(STD forward<K>(key)), STD forward_as_tuple(STD forward<Args>(args)...));
+		return { insertNode(pos.first, pos.second, node), true };
+	}
+
+	template <typename K, typename... Args>
+	iterator tryEmplaceHint(const_iterator hint, K&& key, Args&&... args)
+	{
+		const auto pos = getInsertHintUniquePos(hint, key);
+		if (!pos.second)
+		{
+			return iterator(pos.first);
+		}
+
+		Node* node = createNode(STD piecewise_construct,
+			STD forward_as_tuple(STD forward<K>(key)), STD forward_as_tuple(STD forward<Args>(args)...));
+		return insertNode(pos.first, pos.second, node);
+	}
+
+	template <typename InputIterator>
+	void insertRangeUnique(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+		{
+			emplaceHintUnique(cend(), *first);
+		}
+	}
+
+	template <typename InputIterator>
+	void insertRangeEqual(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+		{
+			emplaceHintEqual(cend(), *first);
+		}
+	}
+
+	template <typename K>
+	size_type eraseKey(const K& key)
+	{
+		const auto range = equal_range(key);
+		const size_type oldSize = size();
+		erase(range.first, range.second);
+		return oldSize - size();
+	}
+
+	// A node from a tree with an unequal allocator cannot be adopted.
+	void checkNodeAllocator(const node_type& node) const
+	{
+		if constexpr (!Node_Alloc_Traits::always_equal_v())
+		{
+			if (!(*node.mAlloc == getNodeAllocator()))
+			{
+				throw STD logic_error("RbTree: node_type allocator does not match the container");
+			}
+		}
+	}
+
+	insert_return_type reinsertNodeUnique(node_type&& node)
+	{
+		if (node.empty())
+		{
+			return { end(), false, node_type() };
+		}
+
+		checkNodeAllocator(node);
+		const auto pos = getInsertUniquePos(keyOf(node.mNode));
+		if (!pos.second)
+		{
+			return { iterator(pos.first), false, STD move(node) };
+		}
+
+		const iterator result = insertNode(pos.first, pos.second, node.release());
+		return { result, true, node_type() };
+	}
+
+	iterator reinsertNodeHintUnique(const_iterator hint, node_type&& node)
+	{
+		if (node.empty())
+		{
+			return end();
+		}
+
+		checkNodeAllocator(node);
+		const auto pos = getInsertHintUniquePos(hint, keyOf(node.mNode));
+		if (!pos.second)
+		{
+			return iterator(pos.first);
+		}
+
+		return insertNode(pos.first, pos.second, node.release());
+	}
+
+	iterator reinsertNodeEqual(node_type&& node)
+	{
+		if (node.empty())
+		{
+			return end();
+		}
+
+		checkNodeAllocator(node);
+		const auto pos = getInsertEqualPos(keyOf(node.mNode));
+		return insertNode(pos.first, pos.second, node.release());
+	}
+
+	iterator reinsertNodeHintEqual(const_iterator hint, node_type&& node)
+	{
+		if (node.empty())
+		{
+			return end();
+		}
+
+		checkNodeAllocator(node);
+		const auto pos = getInsertHintEqualPos(hint, keyOf(node.mNode));
+		return insertNode(pos.first, pos.second, node.release());
+	}
+
+	// Move the nodes of source whose keys are missing here. No allocation, no copy.
+	template <typename Compare2>
+	void mergeUnique(RbTree<Key, Value, KeyOfValue, Compare2, Alloc>& source) JLIBCXX_NOEXCEPT
+	{
+		for (auto it = source.begin(); it != source.end();)
+		{
+			const BasePtr node = it.mNode;
+			++it;
+
+			const auto pos = getInsertUniquePos(keyOf(node));
+			if (pos.second)
+			{
+				rbTreeRebalanceForErase(node, source.header().mHeader);
+				--source.header().mNodeCount;
+				insertNode(pos.first, pos.second, asNode(node));
+			}
+		}
+	}
+
+	template <typename Compare2>
+	void mergeEqual(RbTree<Key, Value, KeyOfValue, Compare2, Alloc>& source) JLIBCXX_NOEXCEPT
+	{
+		for (auto it = source.begin(); it != source.end();)
+		{
+			const BasePtr node = it.mNode;
+			++it;
+
+			const auto pos = getInsertEqualPos(keyOf(node));
+			rbTreeRebalanceForErase(node, source.header().mHeader);
+			--source.header().mNodeCount;
+			insertNode(pos.first, pos.second, asNode(node));
+		}
+	}
+
+	// Checks the red-black invariants, for debugging.
+	NODISCARD bool verify() const
+	{
+		if (header().mNodeCount == 0)
+		{
+			return begin() == end() && header().mHeader.mLeft == endNode() && header().mHeader.mRight == endNode();
+		}
+
+		const STD size_t blackHeight = [&]
+		{
+			STD size_t height = 0;
+			for (ConstBasePtr node = header().mHeader.mLeft; node; node = node->mParent == endNode() ? nullptr : node->mParent)
+			{
+				height += node->mColor == RbColor::Black;
+			}
+
+			return height;
+		}();
+
+		for (auto it = begin(); it != end(); ++it)
+		{
+			ConstBasePtr node = it.mNode;
+			ConstBasePtr left = node->mLeft;
+			ConstBasePtr right = node->mRight;
+
+			if (node->mColor == RbColor::Red
+				&& ((left && left->mColor == RbColor::Red) || (right && right->mColor == RbColor::Red)))
+			{
+				return false;
+			}
+
+			if ((left && less(keyOf(node), keyOf(left))) || (right && less(keyOf(right), keyOf(node))))
+			{
+				return false;
+			}
+
+			if (!left && !right)
+			{
+				STD size_t height = 0;
+				for (ConstBasePtr up = node; up != endNode(); up = up->mParent)
+				{
+					height += up->mColor == RbColor::Black;
+				}
+
+				if (height != blackHeight)
+				{
+					return false;
+				}
+			}
+		}
+
+		return header().mHeader.mLeft == RbNodeBase::minimum(mutableRoot())
+			&& header().mHeader.mRight == RbNodeBase::maximum(mutableRoot());
+	}
+};
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+inline bool operator==(const RbTree<Key, Value, KeyOfValue, Compare, Alloc>& left,
+	const RbTree<Key, Value, KeyOfValue, Compare, Alloc>& right)
+{
+	return left.size() == right.size() && STD equal(left.begin(), left.end(), right.begin());
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+inline bool operator<(const RbTree<Key, Value, KeyOfValue, Compare, Alloc>& left,
+	const RbTree<Key, Value, KeyOfValue, Compare, Alloc>& right)
+{
+	return STD lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+class MultiMap;
+
+template <typename Key, typename Compare, typename Alloc>
+class MultiSet;
+
+/*
+* Ordered map with unique keys.
+*/
+template <typename Key, typename T, typename Compare = STD less<Key>, typename Alloc = STD allocator<STD pair<const Key, T>>>
+class Map : private RbTree<Key, STD pair<const Key, T>, SelectFirst, Compare, Alloc>
+{
+private:
+
+	using Base = RbTree<Key, STD pair<const Key, T>, SelectFirst, Compare, Alloc>;
+
+	template <typename, typename, typename, typename>
+	friend class Map;
+
+	template <typename, typename, typename, typename>
+	friend class MultiMap;
+
+public:
+
+	using mapped_type = T;
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::key_compare;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using typename Base::iterator;
+	using typename Base::const_iterator;
+	using typename Base::reverse_iterator;
+	using typename Base::const_reverse_iterator;
+	using typename Base::node_type;
+	using typename Base::insert_return_type;
+
+	class value_compare
+	{
+		friend class Map;
+
+	protected:
+
+		Compare comp;
+
+		value_compare(Compare c)
+			: comp(c) { }
+
+	public:
+
+		bool operator()(const value_type& left, const value_type& right) const
+		{
+			return comp(left.first, right.first);
+		}
+	};
+
+	Map() = default;
+
+	explicit Map(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc) { }
+
+	explicit Map(const allocator_type& alloc)
+		: Base(Compare(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	Map(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeUnique(first, last);
+	}
+
+	Map(STD initializer_list<value_type> ilist, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+	}
+
+	Map(const Map&) = default;
+
+	Map(Map&&) = default;
+
+	Map(const Map& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	Map(Map&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~Map() = default;
+
+	Map& operator=(const Map&) = default;
+
+	Map& operator=(Map&&) = default;
+
+	Map& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::key_comp;
+	using Base::begin;
+	using Base::end;
+	using Base::rbegin;
+	using Base::rend;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::crbegin;
+	using Base::crend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::clear;
+	using Base::find;
+	using Base::count;
+	using Base::contains;
+	using Base::lower_bound;
+	using Base::upper_bound;
+	using Base::equal_range;
+	using Base::extract;
+
+	NODISCARD value_compare value_comp() const
+	{
+		return value_compare(key_comp());
+	}
+
+	mapped_type& operator[](const key_type& key)
+	{
+		return this->tryEmplace(key).first->second;
+	}
+
+	mapped_type& operator[](key_type&& key)
+	{
+		return this->tryEmplace(STD move(key)).first->second;
+	}
+
+	NODISCARD mapped_type& at(const key_type& key)
+	{
+		const iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("Map::at: key not found");
+		}
+
+		return pos->second;
+	}
+
+	NODISCARD const mapped_type& at(const key_type& key) const
+	{
+		const const_iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("Map::at: key not found");
+		}
+
+		return pos->second;
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return this->insertUnique(value);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return this->insertUnique(STD move(value));
+	}
+
+	template <typename P, typename = STD enable_if_t<STD is_constructible_v<value_type, P&&>>>
+	STD pair<iterator, bool> insert(P&& value)
+	{
+		return this->emplaceUnique(STD forward<P>(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value)
+	{
+		return this->insertHintUnique(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value)
+	{
+		return this->insertHintUnique(hint, STD move(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRangeUnique(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+	}
+
+	insert_return_type insert(node_type&& node)
+	{
+		return this->reinsertNodeUnique(STD move(node));
+	}
+
+	iterator insert(const_iterator hint, node_type&& node)
+	{
+		return this->reinsertNodeHintUnique(hint, STD move(node));
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(const key_type& key, M&& value)
+	{
+		auto result = this->tryEmplace(key, STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first->second = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(key_type&& key, M&& value)
+	{
+		auto result = this->tryEmplace(STD move(key), STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first->second = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		return this->emplaceUnique(STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args)
+	{
+		return this->emplaceHintUnique(hint, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		return this->tryEmplace(key, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+	{
+		return this->tryEmplace(STD move(key), STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator try_emplace(const_iterator hint, const key_type& key, Args&&... args)
+	{
+		return this->tryEmplaceHint(hint, key, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator try_emplace(const_iterator hint, key_type&& key, Args&&... args)
+	{
+		return this->tryEmplaceHint(hint, STD move(key), STD forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		return Base::erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	template <typename Compare2>
+	void merge(Map<Key, T, Compare2, Alloc>& source)
+	{
+		this->mergeUnique(static_cast<typename Map<Key, T, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(Map<Key, T, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	template <typename Compare2>
+	void merge(MultiMap<Key, T, Compare2, Alloc>& source)
+	{
+		this->mergeUnique(static_cast<typename MultiMap<Key, T, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(MultiMap<Key, T, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	void swap(Map& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const Map& left, const Map& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const Map& left, const Map& right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const Map& left, const Map& right)
+	{
+		return static_cast<const Base&>(left) < static_cast<const Base&>(right);
+	}
+
+	friend void swap(Map& left, Map& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+/*
+* Ordered map that keeps every inserted element, equal keys in insertion order.
+*/
+template <typename Key, typename T, typename Compare = STD less<Key>, typename Alloc = STD allocator<STD pair<const Key, T>>>
+class MultiMap : private RbTree<Key, STD pair<const Key, T>, SelectFirst, Compare, Alloc>
+{
+private:
+
+	using Base = RbTree<Key, STD pair<const Key, T>, SelectFirst, Compare, Alloc>;
+
+	template <typename, typename, typename, typename>
+	friend class Map;
+
+	template <typename, typename, typename, typename>
+	friend class MultiMap;
+
+public:
+
+	using mapped_type = T;
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::key_compare;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using typename Base::iterator;
+	using typename Base::const_iterator;
+	using typename Base::reverse_iterator;
+	using typename Base::const_reverse_iterator;
+	using typename Base::node_type;
+
+	MultiMap() = default;
+
+	explicit MultiMap(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc) { }
+
+	explicit MultiMap(const allocator_type& alloc)
+		: Base(Compare(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	MultiMap(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeEqual(first, last);
+	}
+
+	MultiMap(STD initializer_list<value_type> ilist, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+	}
+
+	MultiMap(const MultiMap&) = default;
+
+	MultiMap(MultiMap&&) = default;
+
+	MultiMap(const MultiMap& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	MultiMap(MultiMap&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~MultiMap() = default;
+
+	MultiMap& operator=(const MultiMap&) = default;
+
+	MultiMap& operator=(MultiMap&&) = default;
+
+	MultiMap& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::key_comp;
+	using Base::begin;
+	using Base::end;
+	using Base::rbegin;
+	using Base::rend;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::crbegin;
+	using Base::crend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::clear;
+	using Base::find;
+	using Base::count;
+	using Base::contains;
+	using Base::lower_bound;
+	using Base::upper_bound;
+	using Base::equal_range;
+	using Base::extract;
+
+	iterator insert(const value_type& value)
+	{
+		return this->emplaceEqual(value);
+	}
+
+	iterator insert(value_type&& value)
+	{
+		return this->emplaceEqual(STD move(value));
+	}
+
+	template <typename P, typename = STD enable_if_t<STD is_constructible_v<value_type, P&&>>>
+	iterator insert(P&& value)
+	{
+		return this->emplaceEqual(STD forward<P>(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value)
+	{
+		return this->emplaceHintEqual(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value)
+	{
+		return this->emplaceHintEqual(hint, STD move(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRangeEqual(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+	}
+
+	iterator insert(node_type&& node)
+	{
+		return this->reinsertNodeEqual(STD move(node));
+	}
+
+	iterator insert(const_iterator hint, node_type&& node)
+	{
+		return this->reinsertNodeHintEqual(hint, STD move(node));
+	}
+
+	template <typename... Args>
+	iterator emplace(Args&&... args)
+	{
+		return this->emplaceEqual(STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args)
+	{
+		return this->emplaceHintEqual(hint, STD forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		return Base::erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	template <typename Compare2>
+	void merge(MultiMap<Key, T, Compare2, Alloc>& source)
+	{
+		this->mergeEqual(static_cast<typename MultiMap<Key, T, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(MultiMap<Key, T, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	template <typename Compare2>
+	void merge(Map<Key, T, Compare2, Alloc>& source)
+	{
+		this->mergeEqual(static_cast<typename Map<Key, T, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(Map<Key, T, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	void swap(MultiMap& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const MultiMap& left, const MultiMap& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const MultiMap& left, const MultiMap& right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const MultiMap& left, const MultiMap& right)
+	{
+		return static_cast<const Base&>(left) < static_cast<const Base&>(right);
+	}
+
+	friend void swap(MultiMap& left, MultiMap& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+/*
+* Ordered set of unique keys. Elements are const, iterator and const_iterator are the same.
+*/
+template <typename Key, typename Compare = STD less<Key>, typename Alloc = STD allocator<Key>>
+class Set : private RbTree<Key, Key, Identity, Compare, Alloc>
+{
+private:
+
+	using Base = RbTree<Key, Key, Identity, Compare, Alloc>;
+
+	template <typename, typename, typename>
+	friend class Set;
+
+	template <typename, typename, typename>
+	friend class MultiSet;
+
+public:
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::key_compare;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using typename Base::node_type;
+	using value_compare = Compare;
+	using iterator = typename Base::const_iterator;
+	using const_iterator = typename Base::const_iterator;
+	using reverse_iterator = typename Base::const_reverse_iterator;
+	using const_reverse_iterator = typename Base::const_reverse_iterator;
+	using insert_return_type = RbInsertReturn<iterator, node_type>;
+
+	Set() = default;
+
+	explicit Set(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc) { }
+
+	explicit Set(const allocator_type& alloc)
+		: Base(Compare(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	Set(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeUnique(first, last);
+	}
+
+	Set(STD initializer_list<value_type> ilist, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+	}
+
+	Set(const Set&) = default;
+
+	Set(Set&&) = default;
+
+	Set(const Set& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	Set(Set&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~Set() = default;
+
+	Set& operator=(const Set&) = default;
+
+	Set& operator=(Set&&) = default;
+
+	Set& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::key_comp;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::crbegin;
+	using Base::crend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::clear;
+	using Base::count;
+	using Base::contains;
+	using Base::extract;
+
+	NODISCARD value_compare value_comp() const
+	{
+		return key_comp();
+	}
+
+	NODISCARD iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return Base::begin();
+	}
+
+	NODISCARD iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return Base::end();
+	}
+
+	NODISCARD reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return Base::rbegin();
+	}
+
+	NODISCARD reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return Base::rend();
+	}
+
+	NODISCARD iterator find(const key_type& key) const
+	{
+		return Base::find(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator find(const K& key) const
+	{
+		return Base::find(key);
+	}
+
+	NODISCARD iterator lower_bound(const key_type& key) const
+	{
+		return Base::lower_bound(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key) const
+	{
+		return Base::lower_bound(key);
+	}
+
+	NODISCARD iterator upper_bound(const key_type& key) const
+	{
+		return Base::upper_bound(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key) const
+	{
+		return Base::upper_bound(key);
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const key_type& key) const
+	{
+		return Base::equal_range(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key) const
+	{
+		return Base::equal_range(key);
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return this->insertUnique(value);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return this->insertUnique(STD move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value)
+	{
+		return this->insertHintUnique(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value)
+	{
+		return this->insertHintUnique(hint, STD move(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRangeUnique(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRangeUnique(ilist.begin(), ilist.end());
+	}
+
+	insert_return_type insert(node_type&& node)
+	{
+		auto result = this->reinsertNodeUnique(STD move(node));
+		return { result.position, result.inserted, STD move(result.node) };
+	}
+
+	iterator insert(const_iterator hint, node_type&& node)
+	{
+		return this->reinsertNodeHintUnique(hint, STD move(node));
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		return this->emplaceUnique(STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args)
+	{
+		return this->emplaceHintUnique(hint, STD forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		return Base::erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	template <typename Compare2>
+	void merge(Set<Key, Compare2, Alloc>& source)
+	{
+		this->mergeUnique(static_cast<typename Set<Key, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(Set<Key, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	template <typename Compare2>
+	void merge(MultiSet<Key, Compare2, Alloc>& source)
+	{
+		this->mergeUnique(static_cast<typename MultiSet<Key, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(MultiSet<Key, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	void swap(Set& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const Set& left, const Set& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const Set& left, const Set& right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const Set& left, const Set& right)
+	{
+		return static_cast<const Base&>(left) < static_cast<const Base&>(right);
+	}
+
+	friend void swap(Set& left, Set& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+/*
+* Ordered set that keeps every inserted key, equal keys in insertion order.
+*/
+template <typename Key, typename Compare = STD less<Key>, typename Alloc = STD allocator<Key>>
+class MultiSet : private RbTree<Key, Key, Identity, Compare, Alloc>
+{
+private:
+
+	using Base = RbTree<Key, Key, Identity, Compare, Alloc>;
+
+	template <typename, typename, typename>
+	friend class Set;
+
+	template <typename, typename, typename>
+	friend class MultiSet;
+
+public:
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::key_compare;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using typename Base::node_type;
+	using value_compare = Compare;
+	using iterator = typename Base::const_iterator;
+	using const_iterator = typename Base::const_iterator;
+	using reverse_iterator = typename Base::const_reverse_iterator;
+	using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+	MultiSet() = default;
+
+	explicit MultiSet(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc) { }
+
+	explicit MultiSet(const allocator_type& alloc)
+		: Base(Compare(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	MultiSet(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeEqual(first, last);
+	}
+
+	MultiSet(STD initializer_list<value_type> ilist, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: Base(comp, alloc)
+	{
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+	}
+
+	MultiSet(const MultiSet&) = default;
+
+	MultiSet(MultiSet&&) = default;
+
+	MultiSet(const MultiSet& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	MultiSet(MultiSet&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~MultiSet() = default;
+
+	MultiSet& operator=(const MultiSet&) = default;
+
+	MultiSet& operator=(MultiSet&&) = default;
+
+	MultiSet& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::key_comp;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::crbegin;
+	using Base::crend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::clear;
+	using Base::count;
+	using Base::contains;
+	using Base::extract;
+
+	NODISCARD value_compare value_comp() const
+	{
+		return key_comp();
+	}
+
+	NODISCARD iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return Base::begin();
+	}
+
+	NODISCARD iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return Base::end();
+	}
+
+	NODISCARD reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return Base::rbegin();
+	}
+
+	NODISCARD reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return Base::rend();
+	}
+
+	NODISCARD iterator find(const key_type& key) const
+	{
+		return Base::find(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator find(const K& key) const
+	{
+		return Base::find(key);
+	}
+
+	NODISCARD iterator lower_bound(const key_type& key) const
+	{
+		return Base::lower_bound(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key) const
+	{
+		return Base::lower_bound(key);
+	}
+
+	NODISCARD iterator upper_bound(const key_type& key) const
+	{
+		return Base::upper_bound(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key) const
+	{
+		return Base::upper_bound(key);
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const key_type& key) const
+	{
+		return Base::equal_range(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key) const
+	{
+		return Base::equal_range(key);
+	}
+
+	iterator insert(const value_type& value)
+	{
+		return this->emplaceEqual(value);
+	}
+
+	iterator insert(value_type&& value)
+	{
+		return this->emplaceEqual(STD move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value)
+	{
+		return this->emplaceHintEqual(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value)
+	{
+		return this->emplaceHintEqual(hint, STD move(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRangeEqual(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRangeEqual(ilist.begin(), ilist.end());
+	}
+
+	iterator insert(node_type&& node)
+	{
+		return this->reinsertNodeEqual(STD move(node));
+	}
+
+	iterator insert(const_iterator hint, node_type&& node)
+	{
+		return this->reinsertNodeHintEqual(hint, STD move(node));
+	}
+
+	template <typename... Args>
+	iterator emplace(Args&&... args)
+	{
+		return this->emplaceEqual(STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args)
+	{
+		return this->emplaceHintEqual(hint, STD forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		return Base::erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	template <typename Compare2>
+	void merge(MultiSet<Key, Compare2, Alloc>& source)
+	{
+		this->mergeEqual(static_cast<typename MultiSet<Key, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(MultiSet<Key, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	template <typename Compare2>
+	void merge(Set<Key, Compare2, Alloc>& source)
+	{
+		this->mergeEqual(static_cast<typename Set<Key, Compare2, Alloc>::Base&>(source));
+	}
+
+	template <typename Compare2>
+	void merge(Set<Key, Compare2, Alloc>&& source)
+	{
+		merge(source);
+	}
+
+	void swap(MultiSet& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const MultiSet& left, const MultiSet& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const MultiSet& left, const MultiSet& right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const MultiSet& left, const MultiSet& right)
+	{
+		return static_cast<const Base&>(left) < static_cast<const Base&>(right);
+	}
+
+	friend void swap(MultiSet& left, MultiSet& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+JSTD_END
+
+#endif // !BRTREE
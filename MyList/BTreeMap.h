@@ -0,0 +1,1765 @@
+#pragma once
+#ifndef BTREE_MAP
+#define BTREE_MAP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "AlignedAllocator.h"
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+
+JSTD_START
+
+class BTreeNodeBase
+{
+public:
+
+	STD uint16_t mCount;
+
+	bool mLeaf;
+};
+
+/*
+* A leaf holds the elements, keys and values in separate arrays so the key search only
+* touches key bytes. Leaves are linked both ways, so a scan never goes back up the tree.
+*/
+template <typename Key, typename T, STD size_t Capacity>
+class alignas(cacheLineSize) BTreeLeafNode : public BTreeNodeBase
+{
+public:
+
+	using key_type = Key;
+	using mapped_type = T;
+
+	BTreeLeafNode* mPrev;
+
+	BTreeLeafNode* mNext;
+
+	BTreeLeafNode() JLIBCXX_NOEXCEPT
+		: BTreeNodeBase{ 0, true }, mPrev(nullptr), mNext(nullptr)
+	{ }
+
+	Key* keys() JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<Key*>(mKeys));
+	}
+
+	const Key* keys() const JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<const Key*>(mKeys));
+	}
+
+	T* values() JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<T*>(mValues));
+	}
+
+	const T* values() const JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<const T*>(mValues));
+	}
+
+private:
+
+	alignas(Key) unsigned char mKeys[sizeof(Key) * Capacity];
+
+	alignas(T) unsigned char mValues[sizeof(T) * Capacity];
+};
+
+/*
+* An internal node holds copies of separator keys: everything in mChildren[i] is less
+* than keys()[i], which is not greater than anything in mChildren[i + 1].
+*/
+template <typename Key, STD size_t Capacity>
+class alignas(cacheLineSize) BTreeInternalNode : public BTreeNodeBase
+{
+public:
+
+	BTreeNodeBase* mChildren[Capacity + 1];
+
+	BTreeInternalNode() JLIBCXX_NOEXCEPT
+		: BTreeNodeBase{ 0, false }
+	{ }
+
+	Key* keys() JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<Key*>(mKeys));
+	}
+
+	const Key* keys() const JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<const Key*>(mKeys));
+	}
+
+private:
+
+	alignas(Key) unsigned char mKeys[sizeof(Key) * Capacity];
+};
+
+/*
+* Position of an element: a leaf and an index into it. end() is one past the last element
+* of the rightmost leaf. Dereferencing yields a pair of references, like C++23 flat_map.
+*/
+template <typename Leaf, bool Const>
+class BTreeIterator
+{
+private:
+
+	using Key = typename Leaf::key_type;
+	using T = typename Leaf::mapped_type;
+	using LeafPtr = STD conditional_t<Const, const Leaf*, Leaf*>;
+
+public:
+
+	using iterator_concept = STD bidirectional_iterator_tag;
+	using iterator_category = STD input_iterator_tag;
+	using value_type = STD pair<const Key, T>;
+	using difference_type = STD ptrdiff_t;
+	using reference = STD pair<const Key&, STD conditional_t<Const, const T&, T&>>;
+
+	// operator-> has to hand out the address of something, so it keeps the pair alive.
+	class pointer
+	{
+	public:
+
+		explicit pointer(reference ref)
+			: mRef(ref)
+		{ }
+
+		reference* operator->() JLIBCXX_NOEXCEPT
+		{
+			return STD addressof(mRef);
+		}
+
+	private:
+
+		reference mRef;
+	};
+
+	BTreeIterator() JLIBCXX_NOEXCEPT
+		: mLeaf(nullptr), mIndex(0)
+	{ }
+
+	BTreeIterator(LeafPtr leaf, STD size_t index) JLIBCXX_NOEXCEPT
+		: mLeaf(leaf), mIndex(index)
+	{ }
+
+	template <bool OtherConst, typename = STD enable_if_t<Const && !OtherConst>>
+	BTreeIterator(const BTreeIterator<Leaf, OtherConst>& other) JLIBCXX_NOEXCEPT
+		: mLeaf(other.mLeaf), mIndex(other.mIndex)
+	{ }
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return reference(mLeaf->keys()[mIndex], mLeaf->values()[mIndex]);
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return pointer(**this);
+	}
+
+	const Key& key() const JLIBCXX_NOEXCEPT
+	{
+		return mLeaf->keys()[mIndex];
+	}
+
+	STD conditional_t<Const, const T&, T&> mapped() const JLIBCXX_NOEXCEPT
+	{
+		return mLeaf->values()[mIndex];
+	}
+
+	BTreeIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		if (++mIndex == mLeaf->mCount && mLeaf->mNext)
+		{
+			mLeaf = mLeaf->mNext;
+			mIndex = 0;
+		}
+
+		return *this;
+	}
+
+	BTreeIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		BTreeIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	BTreeIterator& operator--() JLIBCXX_NOEXCEPT
+	{
+		if (mIndex == 0)
+		{
+			mLeaf = mLeaf->mPrev;
+			mIndex = mLeaf->mCount;
+		}
+
+		--mIndex;
+		return *this;
+	}
+
+	BTreeIterator operator--(int) JLIBCXX_NOEXCEPT
+	{
+		BTreeIterator temp = *this;
+		--*this;
+		return temp;
+	}
+
+	friend bool operator==(const BTreeIterator& left, const BTreeIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mLeaf == right.mLeaf && left.mIndex == right.mIndex;
+	}
+
+	friend bool operator!=(const BTreeIterator& left, const BTreeIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return !(left == right);
+	}
+
+	LeafPtr mLeaf;
+
+	STD size_t mIndex;
+};
+
+/*
+* Ordered map stored as a B+ tree. Many keys fit in each cache-line-aligned node of about
+* NodeBytes bytes, so a lookup takes a handful of cache misses instead of one per level of
+* a red-black tree, and a scan walks the linked leaves.
+*
+* Unlike Map, any insert or erase may invalidate every iterator. Key must be copyable
+* (internal nodes keep separator copies), and Key and T must be nothrow movable.
+*
+* Filling an empty map from sorted input, through the range constructor, insert(first, last)
+* or a copy, builds the tree bottom up in O(n) with full nodes. Later keys larger than all
+* others are appended to the rightmost leaf, which then splits unevenly and stays full.
+*/
+template <typename Key, typename T, typename Compare = STD less<Key>,
+	typename Alloc = STD allocator<STD pair<const Key, T>>, STD size_t NodeBytes = 256>
+class BTreeMap
+{
+public:
+
+	static constexpr STD size_t leafCapacity = STD max<STD size_t>(3,
+		(NodeBytes - sizeof(BTreeNodeBase) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(T)));
+
+	static constexpr STD size_t internalCapacity = STD max<STD size_t>(3,
+		(NodeBytes - sizeof(BTreeNodeBase) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)));
+
+private:
+
+	static_assert(leafCapacity <= 0xFFFF && internalCapacity <= 0xFFFF, "jstd::BTreeMap node is too large.");
+	static_assert(STD is_copy_constructible_v<Key>, "jstd::BTreeMap needs copyable keys.");
+	static_assert(STD is_nothrow_move_constructible_v<Key> && STD is_nothrow_move_constructible_v<T>,
+		"jstd::BTreeMap needs nothrow movable keys and values.");
+
+	using Leaf = BTreeLeafNode<Key, T, leafCapacity>;
+	using Internal = BTreeInternalNode<Key, internalCapacity>;
+	using Leaf_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Leaf>::other;
+	using Leaf_Alloc_Traits = MyAlloctTraits<Leaf_Alloc_Type>;
+	using Internal_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Internal>::other;
+	using Internal_Alloc_Traits = MyAlloctTraits<Internal_Alloc_Type>;
+
+	static constexpr STD size_t leafMinimum = leafCapacity / 2;
+	static constexpr STD size_t internalMinimum = internalCapacity / 2;
+
+	// Every internal node has two children or more.
+	static constexpr STD size_t maxHeight = 64;
+
+	template <typename K, typename C = Compare>
+	using RequireTransparent = STD enable_if_t<IsTransparent<C>::value, K>;
+
+	struct PathEntry
+	{
+		Internal* node;
+		STD size_t index;
+	};
+
+	struct BTreeHeader
+	{
+		BTreeNodeBase* mRoot = nullptr;
+		Leaf* mLeftmost = nullptr;
+		Leaf* mRightmost = nullptr;
+		STD size_t mSize = 0;
+	};
+
+public:
+
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = STD pair<const Key, T>;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+	using iterator = BTreeIterator<Leaf, false>;
+	using const_iterator = BTreeIterator<Leaf, true>;
+	using reverse_iterator = STD reverse_iterator<iterator>;
+	using const_reverse_iterator = STD reverse_iterator<const_iterator>;
+	using reference = typename iterator::reference;
+	using const_reference = typename const_iterator::reference;
+
+private:
+
+	// The empty base optimization for the allocator.
+	struct BTreeImpl : public Leaf_Alloc_Type
+	{
+		CompressedPair<Compare, BTreeHeader> mData;
+
+		BTreeImpl() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<Leaf_Alloc_Type>
+			&& STD is_nothrow_default_constructible_v<Compare>)
+			: Leaf_Alloc_Type(), mData(ZeroThenVariadicArgsT{})
+		{ }
+
+		BTreeImpl(const Compare& comp, const Leaf_Alloc_Type& alloc)
+			: Leaf_Alloc_Type(alloc), mData(OneThenVariadicArgsT{}, comp)
+		{ }
+	};
+
+	BTreeImpl mImpl;
+
+	Leaf_Alloc_Type& getLeafAllocator() JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	const Leaf_Alloc_Type& getLeafAllocator() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	BTreeHeader& header() JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second;
+	}
+
+	const BTreeHeader& header() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second;
+	}
+
+	const Compare& comp() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.first();
+	}
+
+	Leaf* createLeaf()
+	{
+		Leaf* leaf = Leaf_Alloc_Traits::allocate(getLeafAllocator(), 1);
+		return ::new (static_cast<void*>(leaf)) Leaf();
+	}
+
+	void freeLeaf(Leaf* leaf) JLIBCXX_NOEXCEPT
+	{
+		Leaf_Alloc_Traits::deallocate(getLeafAllocator(), leaf, 1);
+	}
+
+	Internal* createInternal()
+	{
+		Internal_Alloc_Type alloc(getLeafAllocator());
+		Internal* node = Internal_Alloc_Traits::allocate(alloc, 1);
+		return ::new (static_cast<void*>(node)) Internal();
+	}
+
+	void freeInternal(Internal* node) JLIBCXX_NOEXCEPT
+	{
+		Internal_Alloc_Type alloc(getLeafAllocator());
+		Internal_Alloc_Traits::deallocate(alloc, node, 1);
+	}
+
+	template <typename U, typename... Args>
+	void constructSlot(U* slot, Args&&... args)
+	{
+		Leaf_Alloc_Traits::construct(getLeafAllocator(), slot, STD forward<Args>(args)...);
+	}
+
+	template <typename U>
+	void destroySlot(U* slot) JLIBCXX_NOEXCEPT
+	{
+		Leaf_Alloc_Traits::destroy(getLeafAllocator(), slot);
+	}
+
+	template <typename U>
+	void destroySlots(U* first, STD size_t n) JLIBCXX_NOEXCEPT
+	{
+		if constexpr (!STD is_trivially_destructible_v<U> || !is_default_construct_allocator<Leaf_Alloc_Type>::value)
+		{
+			for (STD size_t i = 0; i < n; ++i)
+			{
+				destroySlot(first + i);
+			}
+		}
+	}
+
+	// Move n live slots from from to to, the ranges may overlap either way.
+	template <typename U>
+	void relocateSlots(U* from, U* to, STD size_t n) JLIBCXX_NOEXCEPT
+	{
+		if (n == 0 || from == to)
+		{
+			return;
+		}
+
+		if constexpr (is_bitwise_relocatable_v<U, Leaf_Alloc_Type>)
+		{
+			STD memmove(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(U));
+		}
+		else if (to < from)
+		{
+			for (STD size_t i = 0; i < n; ++i)
+			{
+				constructSlot(to + i, STD move(from[i]));
+				destroySlot(from + i);
+			}
+		}
+		else
+		{
+			for (STD size_t i = n; i-- > 0;)
+			{
+				constructSlot(to + i, STD move(from[i]));
+				destroySlot(from + i);
+			}
+		}
+	}
+
+	void destroyTree(BTreeNodeBase* node) JLIBCXX_NOEXCEPT
+	{
+		if (node->mLeaf)
+		{
+			Leaf* leaf = static_cast<Leaf*>(node);
+			destroySlots(leaf->keys(), leaf->mCount);
+			destroySlots(leaf->values(), leaf->mCount);
+			freeLeaf(leaf);
+			return;
+		}
+
+		Internal* internal = static_cast<Internal*>(node);
+		for (STD size_t i = 0; i <= internal->mCount; ++i)
+		{
+			destroyTree(internal->mChildren[i]);
+		}
+
+		destroySlots(internal->keys(), internal->mCount);
+		freeInternal(internal);
+	}
+
+	void clearAll() JLIBCXX_NOEXCEPT
+	{
+		if (header().mRoot)
+		{
+			destroyTree(header().mRoot);
+		}
+
+		header() = BTreeHeader();
+	}
+
+	// One past the last element of a leaf means the first element of the next one.
+	template <typename LeafPtr>
+	static BTreeIterator<Leaf, STD is_const_v<STD remove_pointer_t<LeafPtr>>> makeIterator(LeafPtr leaf, STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		if (index == leaf->mCount && leaf->mNext)
+		{
+			return { leaf->mNext, 0 };
+		}
+
+		return { leaf, index };
+	}
+
+	// Walk down to the leaf whose range holds key, recording the way in path.
+	template <typename K>
+	Leaf* descend(const K& key, PathEntry* path, STD size_t& depth) const
+	{
+		BTreeNodeBase* node = header().mRoot;
+		depth = 0;
+		while (!node->mLeaf)
+		{
+			Internal* internal = static_cast<Internal*>(node);
+			const STD size_t index = branchlessUpperBound(internal->keys(), internal->mCount, key, comp());
+			if (path)
+			{
+				path[depth] = { internal, index };
+			}
+
+			++depth;
+			node = internal->mChildren[index];
+		}
+
+		return static_cast<Leaf*>(node);
+	}
+
+	// The rightmost leaf, recording the way in path.
+	Leaf* descendRightmost(PathEntry* path, STD size_t& depth) JLIBCXX_NOEXCEPT
+	{
+		BTreeNodeBase* node = header().mRoot;
+		depth = 0;
+		while (!node->mLeaf)
+		{
+			Internal* internal = static_cast<Internal*>(node);
+			path[depth++] = { internal, internal->mCount };
+			node = internal->mChildren[internal->mCount];
+		}
+
+		return static_cast<Leaf*>(node);
+	}
+
+	template <typename K>
+	STD pair<Leaf*, STD size_t> lowerBoundImpl(const K& key) const
+	{
+		if (!header().mRoot)
+		{
+			return { nullptr, 0 };
+		}
+
+		STD size_t depth;
+		Leaf* leaf = descend(key, nullptr, depth);
+		return { leaf, branchlessLowerBound(leaf->keys(), leaf->mCount, key, comp()) };
+	}
+
+	template <typename K>
+	STD pair<Leaf*, STD size_t> upperBoundImpl(const K& key) const
+	{
+		if (!header().mRoot)
+		{
+			return { nullptr, 0 };
+		}
+
+		STD size_t depth;
+		Leaf* leaf = descend(key, nullptr, depth);
+		return { leaf, branchlessUpperBound(leaf->keys(), leaf->mCount, key, comp()) };
+	}
+
+	// Keys to the right of the leaf descend() picks are all greater, so a miss there is final.
+	template <typename K>
+	STD pair<Leaf*, STD size_t> findImpl(const K& key) const
+	{
+		const auto pos = lowerBoundImpl(key);
+		if (pos.first && pos.second < pos.first->mCount && !comp()(key, pos.first->keys()[pos.second]))
+		{
+			return pos;
+		}
+
+		return { header().mRightmost, header().mRightmost ? header().mRightmost->mCount : 0 };
+	}
+
+	/*
+	* Insert key and the value built from args at index of leaf, splitting nodes up the path
+	* as needed. Every allocation and every copy happens before the tree is touched, so a
+	* throw leaves it as it was.
+	*/
+	template <typename K, typename... Args>
+	iterator insertAt(PathEntry* path, STD size_t depth, Leaf* leaf, STD size_t index, K&& key, Args&&... args)
+	{
+		if (leaf->mCount < leafCapacity)
+		{
+			relocateSlots(leaf->keys() + index, leaf->keys() + index + 1, leaf->mCount - index);
+			relocateSlots(leaf->values() + index, leaf->values() + index + 1, leaf->mCount - index);
+
+			TRY_START
+			constructSlot(leaf->keys() + index, STD forward<K>(key));
+			TRY_START
+			constructSlot(leaf->values() + index, STD forward<Args>(args)...);
+			CATCH_ALL
+			destroySlot(leaf->keys() + index);
+			THROW_AGAIN
+			END_CATCH
+			CATCH_ALL
+			relocateSlots(leaf->keys() + index + 1, leaf->keys() + index, leaf->mCount - index);
+			relocateSlots(leaf->values() + index + 1, leaf->values() + index, leaf->mCount - index);
+			THROW_AGAIN
+			END_CATCH
+
+			++leaf->mCount;
+			++header().mSize;
+			return iterator(leaf, index);
+		}
+
+		return splitAndInsert(path, depth, leaf, index, STD forward<K>(key), STD forward<Args>(args)...);
+	}
+
+	template <typename K, typename... Args>
+	iterator splitAndInsert(PathEntry* path, STD size_t depth, Leaf* leaf, STD size_t index, K&& key, Args&&... args)
+	{
+		Key newKey(STD forward<K>(key));
+		T newValue(STD forward<Args>(args)...);
+
+		// Appending at the right edge keeps the old leaf full and starts a new one.
+		const bool append = index == leaf->mCount && !leaf->mNext;
+		const STD size_t total = leafCapacity + 1;
+		const STD size_t leftCount = append ? leafCapacity : total / 2;
+
+		// The separator is the first key of the new right leaf.
+		const Key* firstRight = leftCount == index ? &newKey
+			: leaf->keys() + (leftCount < index ? leftCount : leftCount - 1);
+		Key separator(*firstRight);
+
+		Internal* spare[maxHeight + 1];
+		STD size_t spareCount = 0;
+		Leaf* right = nullptr;
+
+		TRY_START
+		right = createLeaf();
+		STD size_t level = depth;
+		while (level > 0 && path[level - 1].node->mCount == internalCapacity)
+		{
+			spare[spareCount++] = createInternal();
+			--level;
+		}
+
+		if (level == 0)
+		{
+			spare[spareCount++] = createInternal();
+		}
+		CATCH_ALL
+		while (spareCount > 0)
+		{
+			freeInternal(spare[--spareCount]);
+		}
+
+		if (right)
+		{
+			freeLeaf(right);
+		}
+		THROW_AGAIN
+		END_CATCH
+
+		Key* keys = leaf->keys();
+		T* values = leaf->values();
+		if (index >= leftCount)
+		{
+			const STD size_t before = index - leftCount;
+			relocateSlots(keys + leftCount, right->keys(), before);
+			relocateSlots(values + leftCount, right->values(), before);
+			constructSlot(right->keys() + before, STD move(newKey));
+			constructSlot(right->values() + before, STD move(newValue));
+			relocateSlots(keys + index, right->keys() + before + 1, leafCapacity - index);
+			relocateSlots(values + index, right->values() + before + 1, leafCapacity - index);
+		}
+		else
+		{
+			relocateSlots(keys + leftCount - 1, right->keys(), total - leftCount);
+			relocateSlots(values + leftCount - 1, right->values(), total - leftCount);
+			relocateSlots(keys + index, keys + index + 1, leftCount - 1 - index);
+			relocateSlots(values + index, values + index + 1, leftCount - 1 - index);
+			constructSlot(keys + index, STD move(newKey));
+			constructSlot(values + index, STD move(newValue));
+		}
+
+		leaf->mCount = static_cast<STD uint16_t>(leftCount);
+		right->mCount = static_cast<STD uint16_t>(total - leftCount);
+
+		right->mPrev = leaf;
+		right->mNext = leaf->mNext;
+		if (leaf->mNext)
+		{
+			leaf->mNext->mPrev = right;
+		}
+		else
+		{
+			header().mRightmost = right;
+		}
+
+		leaf->mNext = right;
+		++header().mSize;
+
+		insertIntoParent(path, depth, STD move(separator), right, append, spare, spareCount);
+		return index >= leftCount ? iterator(right, index - leftCount) : iterator(leaf, index);
+	}
+
+	// Hook right in after path[depth - 1], splitting full internal nodes with the spares.
+	void insertIntoParent(PathEntry* path, STD size_t depth, Key&& separator, BTreeNodeBase* right,
+		const bool append, Internal** spare, STD size_t& spareCount) JLIBCXX_NOEXCEPT
+	{
+		if (depth == 0)
+		{
+			Internal* root = spare[--spareCount];
+			constructSlot(root->keys(), STD move(separator));
+			root->mChildren[0] = header().mRoot;
+			root->mChildren[1] = right;
+			root->mCount = 1;
+			header().mRoot = root;
+			return;
+		}
+
+		Internal* node = path[depth - 1].node;
+		const STD size_t index = path[depth - 1].index;
+		Key* keys = node->keys();
+		BTreeNodeBase** children = node->mChildren;
+
+		if (node->mCount < internalCapacity)
+		{
+			relocateSlots(keys + index, keys + index + 1, node->mCount - index);
+			STD memmove(children + index + 2, children + index + 1, (node->mCount - index) * sizeof(BTreeNodeBase*));
+			constructSlot(keys + index, STD move(separator));
+			children[index + 1] = right;
+			++node->mCount;
+			return;
+		}
+
+		Internal* sibling = spare[--spareCount];
+		Key* siblingKeys = sibling->keys();
+		BTreeNodeBase** siblingChildren = sibling->mChildren;
+
+		// Of the capacity + 1 keys, mid go left, one goes up and the rest go right.
+		// On the right edge the new node starts with just the new separator.
+		const STD size_t mid = append ? internalCapacity - 1 : internalCapacity / 2;
+		const STD size_t rightCount = internalCapacity - mid;
+
+		if (index == mid)
+		{
+			relocateSlots(keys + mid, siblingKeys, rightCount);
+			siblingChildren[0] = right;
+			STD memcpy(siblingChildren + 1, children + mid + 1, rightCount * sizeof(BTreeNodeBase*));
+			node->mCount = static_cast<STD uint16_t>(mid);
+			sibling->mCount = static_cast<STD uint16_t>(rightCount);
+			insertIntoParent(path, depth - 1, STD move(separator), sibling, append, spare, spareCount);
+			return;
+		}
+
+		const STD size_t promotedIndex = index < mid ? mid - 1 : mid;
+		Key promoted(STD move(keys[promotedIndex]));
+		destroySlot(keys + promotedIndex);
+
+		if (index < mid)
+		{
+			relocateSlots(keys + mid, siblingKeys, rightCount);
+			STD memcpy(siblingChildren, children + mid, (rightCount + 1) * sizeof(BTreeNodeBase*));
+			relocateSlots(keys + index, keys + index + 1, mid - 1 - index);
+			STD memmove(children + index + 2, children + index + 1, (mid - 1 - index) * sizeof(BTreeNodeBase*));
+			constructSlot(keys + index, STD move(separator));
+			children[index + 1] = right;
+		}
+		else
+		{
+			const STD size_t before = index - mid - 1;
+			relocateSlots(keys + mid + 1, siblingKeys, before);
+			constructSlot(siblingKeys + before, STD move(separator));
+			relocateSlots(keys + index, siblingKeys + before + 1, internalCapacity - index);
+			STD memcpy(siblingChildren, children + mid + 1, (before + 1) * sizeof(BTreeNodeBase*));
+			siblingChildren[before + 1] = right;
+			STD memcpy(siblingChildren + before + 2, children + index + 1, (internalCapacity - index) * sizeof(BTreeNodeBase*));
+		}
+
+		node->mCount = static_cast<STD uint16_t>(mid);
+		sibling->mCount = static_cast<STD uint16_t>(rightCount);
+		insertIntoParent(path, depth - 1, STD move(promoted), sibling, append, spare, spareCount);
+	}
+
+	template <typename K, typename... Args>
+	STD pair<iterator, bool> tryEmplaceImpl(K&& key, Args&&... args)
+	{
+		PathEntry path[maxHeight];
+		STD size_t depth = 0;
+
+		if (!header().mRoot)
+		{
+			Leaf* leaf = createLeaf();
+			header().mRoot = leaf;
+			header().mLeftmost = leaf;
+			header().mRightmost = leaf;
+
+			TRY_START
+			return { insertAt(path, 0, leaf, 0, STD forward<K>(key), STD forward<Args>(args)...), true };
+			CATCH_ALL
+			freeLeaf(leaf);
+			header() = BTreeHeader();
+			THROW_AGAIN
+			END_CATCH
+		}
+
+		// Sorted input keeps landing after the last key, skip the searches.
+		Leaf* last = header().mRightmost;
+		if (comp()(last->keys()[last->mCount - 1], key))
+		{
+			descendRightmost(path, depth);
+			return { insertAt(path, depth, last, last->mCount, STD forward<K>(key), STD forward<Args>(args)...), true };
+		}
+
+		Leaf* leaf = descend(key, path, depth);
+		const STD size_t index = branchlessLowerBound(leaf->keys(), leaf->mCount, key, comp());
+		if (index < leaf->mCount && !comp()(key, leaf->keys()[index]))
+		{
+			return { iterator(leaf, index), false };
+		}
+
+		return { insertAt(path, depth, leaf, index, STD forward<K>(key), STD forward<Args>(args)...), true };
+	}
+
+	void eraseFromLeaf(Leaf* leaf, STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		destroySlot(leaf->keys() + index);
+		destroySlot(leaf->values() + index);
+		relocateSlots(leaf->keys() + index + 1, leaf->keys() + index, leaf->mCount - index - 1);
+		relocateSlots(leaf->values() + index + 1, leaf->values() + index, leaf->mCount - index - 1);
+		--leaf->mCount;
+		--header().mSize;
+	}
+
+	// Close the gap left by key index and child index + 1 of node.
+	void removeFromInternal(Internal* node, STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		relocateSlots(node->keys() + index + 1, node->keys() + index, node->mCount - index - 1);
+		STD memmove(node->mChildren + index + 1, node->mChildren + index + 2,
+			(node->mCount - index - 1) * sizeof(BTreeNodeBase*));
+		--node->mCount;
+	}
+
+	// Replace a separator without a throwing assignment, the copy is made by the caller.
+	void replaceSeparator(Key* slot, Key&& value) JLIBCXX_NOEXCEPT
+	{
+		destroySlot(slot);
+		constructSlot(slot, STD move(value));
+	}
+
+	/*
+	* Refill the underfull leaf at child index of parent from a sibling, or merge it with one.
+	* cursor follows the element it points at. Returns whether parent lost a key.
+	*/
+	bool fixLeaf(Internal* parent, STD size_t index, Leaf*& cursor, STD size_t& cursorIndex) JLIBCXX_NOEXCEPT
+	{
+		Leaf* child = static_cast<Leaf*>(parent->mChildren[index]);
+		Leaf* left = index > 0 ? static_cast<Leaf*>(parent->mChildren[index - 1]) : nullptr;
+		Leaf* right = index < parent->mCount ? static_cast<Leaf*>(parent->mChildren[index + 1]) : nullptr;
+
+		/*
+		* Borrowing needs a new separator. If copying the key throws, an underfull leaf is
+		* still valid, and an empty one fits into any sibling, so it is merged instead.
+		*/
+		if (left && left->mCount > leafMinimum)
+		{
+			TRY_START
+			Key separator(left->keys()[left->mCount - 1]);
+			relocateSlots(child->keys(), child->keys() + 1, child->mCount);
+			relocateSlots(child->values(), child->values() + 1, child->mCount);
+			relocateSlots(left->keys() + left->mCount - 1, child->keys(), 1);
+			relocateSlots(left->values() + left->mCount - 1, child->values(), 1);
+			--left->mCount;
+			++child->mCount;
+			replaceSeparator(parent->keys() + index - 1, STD move(separator));
+			if (cursor == child)
+			{
+				++cursorIndex;
+			}
+
+			return false;
+			CATCH_ALL
+			END_CATCH
+
+			if (child->mCount != 0)
+			{
+				return false;
+			}
+		}
+
+		if (right && right->mCount > leafMinimum)
+		{
+			TRY_START
+			Key separator(right->keys()[1]);
+			relocateSlots(right->keys(), child->keys() + child->mCount, 1);
+			relocateSlots(right->values(), child->values() + child->mCount, 1);
+			relocateSlots(right->keys() + 1, right->keys(), right->mCount - 1U);
+			relocateSlots(right->values() + 1, right->values(), right->mCount - 1U);
+			--right->mCount;
+			++child->mCount;
+			replaceSeparator(parent->keys() + index, STD move(separator));
+			return false;
+			CATCH_ALL
+			END_CATCH
+
+			if (child->mCount != 0)
+			{
+				return false;
+			}
+		}
+
+		if (left)
+		{
+			mergeLeaves(left, child);
+			if (cursor == child)
+			{
+				cursor = left;
+				cursorIndex += left->mCount - child->mCount;
+			}
+
+			destroySlot(parent->keys() + index - 1);
+			removeFromInternal(parent, index - 1);
+			freeLeaf(child);
+			return true;
+		}
+
+		mergeLeaves(child, right);
+		destroySlot(parent->keys() + index);
+		removeFromInternal(parent, index);
+		freeLeaf(right);
+		return true;
+	}
+
+	// Append the elements of right to left and unlink right. right keeps its count.
+	void mergeLeaves(Leaf* left, Leaf* right) JLIBCXX_NOEXCEPT
+	{
+		relocateSlots(right->keys(), left->keys() + left->mCount, right->mCount);
+		relocateSlots(right->values(), left->values() + left->mCount, right->mCount);
+		left->mCount = static_cast<STD uint16_t>(left->mCount + right->mCount);
+
+		left->mNext = right->mNext;
+		if (right->mNext)
+		{
+			right->mNext->mPrev = left;
+		}
+		else
+		{
+			header().mRightmost = left;
+		}
+	}
+
+	// As fixLeaf, for an internal child. Separators only move, nothing is copied.
+	bool fixInternal(Internal* parent, STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		Internal* child = static_cast<Internal*>(parent->mChildren[index]);
+		Internal* left = index > 0 ? static_cast<Internal*>(parent->mChildren[index - 1]) : nullptr;
+		Internal* right = index < parent->mCount ? static_cast<Internal*>(parent->mChildren[index + 1]) : nullptr;
+
+		if (left && left->mCount > internalMinimum)
+		{
+			relocateSlots(child->keys(), child->keys() + 1, child->mCount);
+			STD memmove(child->mChildren + 1, child->mChildren, (child->mCount + 1U) * sizeof(BTreeNodeBase*));
+			relocateSlots(parent->keys() + index - 1, child->keys(), 1);
+			child->mChildren[0] = left->mChildren[left->mCount];
+			relocateSlots(left->keys() + left->mCount - 1, parent->keys() + index - 1, 1);
+			--left->mCount;
+			++child->mCount;
+			return false;
+		}
+
+		if (right && right->mCount > internalMinimum)
+		{
+			relocateSlots(parent->keys() + index, child->keys() + child->mCount, 1);
+			child->mChildren[child->mCount + 1] = right->mChildren[0];
+			relocateSlots(right->keys(), parent->keys() + index, 1);
+			relocateSlots(right->keys() + 1, right->keys(), right->mCount - 1U);
+			STD memmove(right->mChildren, right->mChildren + 1, right->mCount * sizeof(BTreeNodeBase*));
+			--right->mCount;
+			++child->mCount;
+			return false;
+		}
+
+		if (!left)
+		{
+			left = child;
+			child = right;
+			++index;
+		}
+
+		// Pull the separator down between the two halves.
+		relocateSlots(parent->keys() + index - 1, left->keys() + left->mCount, 1);
+		relocateSlots(child->keys(), left->keys() + left->mCount + 1, child->mCount);
+		STD memcpy(left->mChildren + left->mCount + 1, child->mChildren, (child->mCount + 1U) * sizeof(BTreeNodeBase*));
+		left->mCount = static_cast<STD uint16_t>(left->mCount + child->mCount + 1);
+		removeFromInternal(parent, index - 1);
+		freeInternal(child);
+		return true;
+	}
+
+	// Walk back up after an erase, fixing underfull nodes until one is left alone.
+	void rebalance(PathEntry* path, STD size_t depth, Leaf*& cursor, STD size_t& cursorIndex) JLIBCXX_NOEXCEPT
+	{
+		BTreeNodeBase* child = path[depth - 1].node->mChildren[path[depth - 1].index];
+		for (STD size_t level = depth; level-- > 0;)
+		{
+			const STD size_t minimum = child->mLeaf ? leafMinimum : internalMinimum;
+			if (child->mCount >= minimum)
+			{
+				return;
+			}
+
+			Internal* parent = path[level].node;
+			const bool merged = child->mLeaf
+				? fixLeaf(parent, path[level].index, cursor, cursorIndex)
+				: fixInternal(parent, path[level].index);
+			if (!merged)
+			{
+				return;
+			}
+
+			child = parent;
+		}
+
+		// The root ran out of separators, its only child takes over.
+		Internal* root = static_cast<Internal*>(header().mRoot);
+		if (root->mCount == 0)
+		{
+			header().mRoot = root->mChildren[0];
+			freeInternal(root);
+		}
+	}
+
+	iterator eraseImpl(Leaf* leaf, STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		if (leaf == header().mRoot || leaf->mCount > leafMinimum)
+		{
+			eraseFromLeaf(leaf, index);
+			if (leaf->mCount == 0)
+			{
+				freeLeaf(leaf);
+				header() = BTreeHeader();
+				return end();
+			}
+
+			return makeIterator(leaf, index);
+		}
+
+		PathEntry path[maxHeight];
+		STD size_t depth;
+		descend(leaf->keys()[index], path, depth);
+
+		eraseFromLeaf(leaf, index);
+		rebalance(path, depth, leaf, index);
+		return makeIterator(leaf, index);
+	}
+
+	// Build key and value at index of leaf, which must be free. Nothing is left if either throws.
+	template <typename K, typename V>
+	void constructElement(Leaf* leaf, STD size_t index, K&& key, V&& value)
+	{
+		constructSlot(leaf->keys() + index, STD forward<K>(key));
+
+		TRY_START
+		constructSlot(leaf->values() + index, STD forward<V>(value));
+		CATCH_ALL
+		destroySlot(leaf->keys() + index);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	/*
+	* Hang node, whose smallest key is separator, to the right of everything on its level.
+	* open[level] is the rightmost internal node of each level above the leaves. A full one
+	* is not split, a new node with node as its only child takes over and goes one level up
+	* in turn, so each node costs O(1) amortized. All copies and allocations come first.
+	*/
+	void appendChild(Internal** open, STD size_t& height, const Key& separator, BTreeNodeBase* node)
+	{
+		STD size_t top = 0;
+		while (top < height && open[top]->mCount == internalCapacity)
+		{
+			++top;
+		}
+
+		Key key(separator);
+		Internal* spare[maxHeight + 1];
+		STD size_t spareCount = 0;
+		const STD size_t needed = top + (top == height ? 1 : 0);
+
+		TRY_START
+		while (spareCount < needed)
+		{
+			spare[spareCount++] = createInternal();
+		}
+		CATCH_ALL
+		while (spareCount > 0)
+		{
+			freeInternal(spare[--spareCount]);
+		}
+		THROW_AGAIN
+		END_CATCH
+
+		for (STD size_t level = 0; level < top; ++level)
+		{
+			Internal* fresh = spare[--spareCount];
+			fresh->mChildren[0] = node;
+			open[level] = fresh;
+			node = fresh;
+		}
+
+		if (top == height)
+		{
+			Internal* root = spare[--spareCount];
+			root->mChildren[0] = header().mRoot;
+			open[height++] = root;
+			header().mRoot = root;
+		}
+
+		Internal* parent = open[top];
+		constructSlot(parent->keys() + parent->mCount, STD move(key));
+		parent->mChildren[parent->mCount + 1] = node;
+		++parent->mCount;
+	}
+
+	/*
+	* After appendChild, the last node of each level may be short, down to a single child.
+	* Top them up from their full left neighbours, from the root down so every node on the
+	* right edge has a left neighbour by the time it is reached.
+	*/
+	void topUpRightEdge() JLIBCXX_NOEXCEPT
+	{
+		BTreeNodeBase* node = header().mRoot;
+		Leaf* cursor = nullptr;
+		STD size_t cursorIndex = 0;
+		while (node && !node->mLeaf)
+		{
+			Internal* parent = static_cast<Internal*>(node);
+			BTreeNodeBase* child = parent->mChildren[parent->mCount];
+			const STD size_t minimum = child->mLeaf ? leafMinimum : internalMinimum;
+			while (child->mCount < minimum && parent->mCount > 0)
+			{
+				// A borrow fails only if a separator copy throws, a short node is still valid.
+				const STD size_t before = child->mCount;
+				const bool merged = child->mLeaf
+					? fixLeaf(parent, parent->mCount, cursor, cursorIndex)
+					: fixInternal(parent, parent->mCount);
+				if (merged || child->mCount == before)
+				{
+					break;
+				}
+			}
+
+			node = parent->mChildren[parent->mCount];
+		}
+	}
+
+	/*
+	* Fill the empty tree bottom up from the strictly increasing prefix of [first, last): each
+	* leaf is filled before the next one starts, and is then handed to appendChild. Returns the
+	* first element not greater than the one before it, the caller inserts the rest one by one.
+	* The tree is whole after every element, so a throw leaves what was loaded so far.
+	*/
+	template <bool MoveValues, typename InputIterator>
+	InputIterator bulkLoad(InputIterator first, InputIterator last)
+	{
+		Internal* open[maxHeight];
+		STD size_t height = 0;
+
+		TRY_START
+		for (; first != last; ++first)
+		{
+			auto&& value = *first;
+			Leaf* leaf = header().mRightmost;
+			if (leaf && !comp()(leaf->keys()[leaf->mCount - 1], value.first))
+			{
+				break;
+			}
+
+			const auto place = [&](Leaf* target, const STD size_t index)
+			{
+				if constexpr (MoveValues)
+				{
+					constructElement(target, index, value.first, STD move(value.second));
+				}
+				else
+				{
+					constructElement(target, index, value.first, value.second);
+				}
+			};
+
+			if (leaf && leaf->mCount < leafCapacity)
+			{
+				place(leaf, leaf->mCount);
+				++leaf->mCount;
+				++header().mSize;
+				continue;
+			}
+
+			Leaf* next = createLeaf();
+
+			TRY_START
+			place(next, 0);
+			if (leaf)
+			{
+				TRY_START
+				appendChild(open, height, next->keys()[0], next);
+				CATCH_ALL
+				destroySlot(next->keys());
+				destroySlot(next->values());
+				THROW_AGAIN
+				END_CATCH
+			}
+			CATCH_ALL
+			freeLeaf(next);
+			THROW_AGAIN
+			END_CATCH
+
+			next->mCount = 1;
+			next->mPrev = leaf;
+			if (leaf)
+			{
+				leaf->mNext = next;
+			}
+			else
+			{
+				header().mRoot = next;
+				header().mLeftmost = next;
+			}
+
+			header().mRightmost = next;
+			++header().mSize;
+		}
+		CATCH_ALL
+		topUpRightEdge();
+		THROW_AGAIN
+		END_CATCH
+
+		topUpRightEdge();
+		return first;
+	}
+
+	template <typename InputIterator>
+	void insertRange(InputIterator first, InputIterator last)
+	{
+		if (!header().mRoot)
+		{
+			first = bulkLoad<false>(first, last);
+		}
+
+		for (; first != last; ++first)
+		{
+			const auto& value = *first;
+			tryEmplaceImpl(value.first, value.second);
+		}
+	}
+
+	// Only into an empty tree, other is already sorted.
+	template <bool MoveValues, typename Other>
+	void appendFrom(Other& other)
+	{
+		bulkLoad<MoveValues>(other.begin(), other.end());
+	}
+
+public:
+
+	BTreeMap() = default;
+
+	explicit BTreeMap(const Compare& comp, const allocator_type& alloc = allocator_type())
+		: mImpl(comp, Leaf_Alloc_Type(alloc))
+	{ }
+
+	explicit BTreeMap(const allocator_type& alloc)
+		: mImpl(Compare(), Leaf_Alloc_Type(alloc))
+	{ }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	BTreeMap(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: mImpl(comp, Leaf_Alloc_Type(alloc))
+	{
+		TRY_START
+		insertRange(first, last);
+		CATCH_ALL
+		clearAll();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	BTreeMap(STD initializer_list<value_type> ilist, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+		: BTreeMap(ilist.begin(), ilist.end(), comp, alloc)
+	{ }
+
+	BTreeMap(const BTreeMap& other)
+		: mImpl(other.comp(), Leaf_Alloc_Traits::select_on_container_copy_construction(other.getLeafAllocator()))
+	{
+		TRY_START
+		appendFrom<false>(other);
+		CATCH_ALL
+		clearAll();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	BTreeMap(const BTreeMap& other, const allocator_type& alloc)
+		: mImpl(other.comp(), Leaf_Alloc_Type(alloc))
+	{
+		TRY_START
+		appendFrom<false>(other);
+		CATCH_ALL
+		clearAll();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	BTreeMap(BTreeMap&& other) JLIBCXX_NOEXCEPT
+		: mImpl(other.comp(), STD move(other.getLeafAllocator()))
+	{
+		header() = other.header();
+		other.header() = BTreeHeader();
+	}
+
+	BTreeMap(BTreeMap&& other, const allocator_type& alloc)
+		: mImpl(other.comp(), Leaf_Alloc_Type(alloc))
+	{
+		if (Leaf_Alloc_Traits::always_equal_v() || getLeafAllocator() == other.getLeafAllocator())
+		{
+			header() = other.header();
+			other.header() = BTreeHeader();
+			return;
+		}
+
+		TRY_START
+		appendFrom<true>(other);
+		CATCH_ALL
+		clearAll();
+		THROW_AGAIN
+		END_CATCH
+
+		other.clear();
+	}
+
+	~BTreeMap() JLIBCXX_NOEXCEPT
+	{
+		clearAll();
+	}
+
+	BTreeMap& operator=(const BTreeMap& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		clear();
+		if constexpr (Leaf_Alloc_Traits::propagate_on_container_copy_assignment_v())
+		{
+			Leaf_Alloc_Traits::doCopy(getLeafAllocator(), other.getLeafAllocator());
+		}
+
+		mImpl.mData.first() = other.comp();
+		appendFrom<false>(other);
+		return *this;
+	}
+
+	BTreeMap& operator=(BTreeMap&& other) JLIBCXX_NOEXCEPT_IF(Leaf_Alloc_Traits::nothrow_move() && STD is_nothrow_move_assignable_v<Compare>)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		clear();
+		mImpl.mData.first() = STD move(other.mImpl.mData.first());
+
+		if constexpr (!Leaf_Alloc_Traits::nothrow_move())
+		{
+			if (getLeafAllocator() != other.getLeafAllocator())
+			{
+				appendFrom<true>(other);
+				other.clear();
+				return *this;
+			}
+		}
+
+		header() = other.header();
+		other.header() = BTreeHeader();
+		Leaf_Alloc_Traits::doMove(getLeafAllocator(), other.getLeafAllocator());
+		return *this;
+	}
+
+	BTreeMap& operator=(STD initializer_list<value_type> ilist)
+	{
+		clear();
+		insertRange(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	NODISCARD allocator_type get_allocator() const JLIBCXX_NOEXCEPT
+	{
+		return allocator_type(getLeafAllocator());
+	}
+
+	NODISCARD key_compare key_comp() const
+	{
+		return comp();
+	}
+
+	NODISCARD iterator begin() JLIBCXX_NOEXCEPT
+	{
+		return iterator(header().mLeftmost, 0);
+	}
+
+	NODISCARD const_iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return const_iterator(header().mLeftmost, 0);
+	}
+
+	NODISCARD iterator end() JLIBCXX_NOEXCEPT
+	{
+		Leaf* last = header().mRightmost;
+		return iterator(last, last ? last->mCount : 0);
+	}
+
+	NODISCARD const_iterator end() const JLIBCXX_NOEXCEPT
+	{
+		const Leaf* last = header().mRightmost;
+		return const_iterator(last, last ? last->mCount : 0);
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD reverse_iterator rbegin() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	NODISCARD const_reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(end());
+	}
+
+	NODISCARD reverse_iterator rend() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
+	NODISCARD const_reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return header().mSize == 0;
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return header().mSize;
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD numeric_limits<size_type>::max() / (sizeof(Key) + sizeof(T));
+	}
+
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		clearAll();
+	}
+
+	void swap(BTreeMap& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Compare>)
+	{
+		using STD swap;
+		swap(header(), other.header());
+		swap(mImpl.mData.first(), other.mImpl.mData.first());
+		Leaf_Alloc_Traits::doSwap(getLeafAllocator(), other.getLeafAllocator());
+	}
+
+	NODISCARD iterator find(const Key& key)
+	{
+		const auto pos = findImpl(key);
+		return iterator(pos.first, pos.second);
+	}
+
+	NODISCARD const_iterator find(const Key& key) const
+	{
+		const auto pos = findImpl(key);
+		return const_iterator(pos.first, pos.second);
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator find(const K& key)
+	{
+		const auto pos = findImpl(key);
+		return iterator(pos.first, pos.second);
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator find(const K& key) const
+	{
+		const auto pos = findImpl(key);
+		return const_iterator(pos.first, pos.second);
+	}
+
+	NODISCARD bool contains(const Key& key) const
+	{
+		return find(key) != end();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD bool contains(const K& key) const
+	{
+		return find(key) != end();
+	}
+
+	NODISCARD size_type count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD size_type count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	NODISCARD iterator lower_bound(const Key& key)
+	{
+		const auto pos = lowerBoundImpl(key);
+		return pos.first ? makeIterator(pos.first, pos.second) : end();
+	}
+
+	NODISCARD const_iterator lower_bound(const Key& key) const
+	{
+		const auto pos = lowerBoundImpl(key);
+		return pos.first ? makeIterator(static_cast<const Leaf*>(pos.first), pos.second) : end();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key)
+	{
+		const auto pos = lowerBoundImpl(key);
+		return pos.first ? makeIterator(pos.first, pos.second) : end();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator lower_bound(const K& key) const
+	{
+		const auto pos = lowerBoundImpl(key);
+		return pos.first ? makeIterator(static_cast<const Leaf*>(pos.first), pos.second) : end();
+	}
+
+	NODISCARD iterator upper_bound(const Key& key)
+	{
+		const auto pos = upperBoundImpl(key);
+		return pos.first ? makeIterator(pos.first, pos.second) : end();
+	}
+
+	NODISCARD const_iterator upper_bound(const Key& key) const
+	{
+		const auto pos = upperBoundImpl(key);
+		return pos.first ? makeIterator(static_cast<const Leaf*>(pos.first), pos.second) : end();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key)
+	{
+		const auto pos = upperBoundImpl(key);
+		return pos.first ? makeIterator(pos.first, pos.second) : end();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator upper_bound(const K& key) const
+	{
+		const auto pos = upperBoundImpl(key);
+		return pos.first ? makeIterator(static_cast<const Leaf*>(pos.first), pos.second) : end();
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const Key& key)
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const Key& key) const
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key)
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	NODISCARD T& at(const Key& key)
+	{
+		const iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("BTreeMap::at: key not found");
+		}
+
+		return pos.mapped();
+	}
+
+	NODISCARD const T& at(const Key& key) const
+	{
+		const const_iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("BTreeMap::at: key not found");
+		}
+
+		return pos.mapped();
+	}
+
+	T& operator[](const Key& key)
+	{
+		return tryEmplaceImpl(key).first.mapped();
+	}
+
+	T& operator[](Key&& key)
+	{
+		return tryEmplaceImpl(STD move(key)).first.mapped();
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+	{
+		return tryEmplaceImpl(key, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+	{
+		return tryEmplaceImpl(STD move(key), STD forward<Args>(args)...);
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+	{
+		auto result = tryEmplaceImpl(key, STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first.mapped() = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(Key&& key, M&& value)
+	{
+		auto result = tryEmplaceImpl(STD move(key), STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first.mapped() = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	// Keys and values live apart, so the pair is built first and taken apart.
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		STD pair<Key, T> value(STD forward<Args>(args)...);
+		return tryEmplaceImpl(STD move(value.first), STD move(value.second));
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return tryEmplaceImpl(value.first, value.second);
+	}
+
+	template <typename P, typename = STD enable_if_t<STD is_constructible_v<STD pair<Key, T>, P&&>>>
+	STD pair<iterator, bool> insert(P&& value)
+	{
+		return emplace(STD forward<P>(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		insertRange(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		insertRange(ilist.begin(), ilist.end());
+	}
+
+	iterator erase(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return eraseImpl(const_cast<Leaf*>(pos.mLeaf), pos.mIndex);
+	}
+
+	iterator erase(iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return eraseImpl(pos.mLeaf, pos.mIndex);
+	}
+
+	// Every erase may move elements, so count first and keep following the returned iterator.
+	iterator erase(const_iterator first, const_iterator last) JLIBCXX_NOEXCEPT
+	{
+		if (first == cbegin() && last == cend())
+		{
+			clear();
+			return end();
+		}
+
+		STD size_t count = 0;
+		for (const_iterator it = first; it != last; ++it)
+		{
+			++count;
+		}
+
+		iterator pos(const_cast<Leaf*>(first.mLeaf), first.mIndex);
+		while (count-- > 0)
+		{
+			pos = erase(pos);
+		}
+
+		return pos;
+	}
+
+	size_type erase(const Key& key)
+	{
+		const iterator pos = find(key);
+		if (pos == end())
+		{
+			return 0;
+		}
+
+		erase(pos);
+		return 1;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	size_type erase(const K& key)
+	{
+		const iterator pos = find(key);
+		if (pos == end())
+		{
+			return 0;
+		}
+
+		erase(pos);
+		return 1;
+	}
+
+	friend bool operator==(const BTreeMap& left, const BTreeMap& right)
+	{
+		return left.size() == right.size() && STD equal(left.begin(), left.end(), right.begin());
+	}
+
+	friend bool operator!=(const BTreeMap& left, const BTreeMap& right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const BTreeMap& left, const BTreeMap& right)
+	{
+		return STD lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+	}
+
+	friend void swap(BTreeMap& left, BTreeMap& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+JSTD_END
+
+#endif // !BTREE_MAP
@@ -23,6 +23,25 @@ JSTD_START
 #define JLIBCXX_USE_NOEXCEPT noexcept
 #define JLIBCXX_THROW(_EXC)
 
+/*
+* Geometric growth factor of jstd::Vector, as NUMERATOR / DENOMINATOR.
+* Default is 2x. Define them before including any header to change it, e.g. 3 / 2 for 1.5x.
+*/
+#ifndef JSTD_VECTOR_GROWTH_NUMERATOR
+#define JSTD_VECTOR_GROWTH_NUMERATOR 2
+#endif // !JSTD_VECTOR_GROWTH_NUMERATOR
+
+#ifndef JSTD_VECTOR_GROWTH_DENOMINATOR
+#define JSTD_VECTOR_GROWTH_DENOMINATOR 1
+#endif // !JSTD_VECTOR_GROWTH_DENOMINATOR
+
+/*
+* Bytes per block of jstd::Deque. Types larger than this get one element per block.
+*/
+#ifndef JSTD_DEQUE_BLOCK_BYTES
+#define JSTD_DEQUE_BLOCK_BYTES 512
+#endif // !JSTD_DEQUE_BLOCK_BYTES
+
 JSTD_END
 
 #endif // !CONFIG
@@ -0,0 +1,265 @@
+#pragma once
+#ifndef COUNTING_ALLOCATOR
+#define COUNTING_ALLOCATOR
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "Config.h"
+#include "Allocator.h"
+#include "Healper.h"
+#include "Utility.h"
+
+JSTD_START
+
+/*
+* Plain copy of an AllocationCounter at one point in time.
+*
+* histogram[i] counts allocations of [2^(i-1), 2^i) bytes, histogram[0] the empty ones.
+*/
+struct AllocationStats
+{
+	static constexpr STD size_t sizeClasses = 64;
+
+	STD size_t allocations = 0;
+	STD size_t deallocations = 0;
+	STD size_t bytesAllocated = 0;
+	STD size_t bytesLive = 0;
+	STD size_t peakBytes = 0;
+	STD size_t histogram[sizeClasses] = {};
+
+	NODISCARD STD size_t liveAllocations() const JLIBCXX_NOEXCEPT
+	{
+		return allocations - deallocations;
+	}
+};
+
+/*
+* Thread safe allocation statistics, fed by CountingAllocator.
+* Give each container its own counter, or let all allocators of a tag share one.
+*/
+class AllocationCounter
+{
+public:
+
+	AllocationCounter() = default;
+
+	AllocationCounter(const AllocationCounter&) = delete;
+
+	AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+	// The counter shared by every CountingAllocator with this Tag.
+	template <typename Tag>
+	NODISCARD static AllocationCounter& forTag() JLIBCXX_NOEXCEPT
+	{
+		static AllocationCounter counter;
+		return counter;
+	}
+
+	void recordAllocation(const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		mAllocations.fetch_add(1, STD memory_order_relaxed);
+		mBytesAllocated.fetch_add(bytes, STD memory_order_relaxed);
+		mHistogram[sizeClassOf(bytes)].fetch_add(1, STD memory_order_relaxed);
+
+		const STD size_t live = mBytesLive.fetch_add(bytes, STD memory_order_relaxed) + bytes;
+		STD size_t peak = mPeakBytes.load(STD memory_order_relaxed);
+		while (live > peak && !mPeakBytes.compare_exchange_weak(peak, live, STD memory_order_relaxed)) { }
+	}
+
+	void recordDeallocation(const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		mDeallocations.fetch_add(1, STD memory_order_relaxed);
+		mBytesLive.fetch_sub(bytes, STD memory_order_relaxed);
+	}
+
+	/*
+	* The fields are read one by one, so a snapshot taken while other threads
+	* allocate is not a consistent cut. Each field on its own is exact.
+	*/
+	NODISCARD AllocationStats snapshot() const JLIBCXX_NOEXCEPT
+	{
+		AllocationStats stats;
+		stats.allocations = mAllocations.load(STD memory_order_relaxed);
+		stats.deallocations = mDeallocations.load(STD memory_order_relaxed);
+		stats.bytesAllocated = mBytesAllocated.load(STD memory_order_relaxed);
+		stats.bytesLive = mBytesLive.load(STD memory_order_relaxed);
+		stats.peakBytes = mPeakBytes.load(STD memory_order_relaxed);
+		for (STD size_t i = 0; i < AllocationStats::sizeClasses; ++i)
+		{
+			stats.histogram[i] = mHistogram[i].load(STD memory_order_relaxed);
+		}
+
+		return stats;
+	}
+
+	// Start a new measurement. bytesLive is kept, the memory is still out there.
+	void reset() JLIBCXX_NOEXCEPT
+	{
+		mAllocations.store(0, STD memory_order_relaxed);
+		mDeallocations.store(0, STD memory_order_relaxed);
+		mBytesAllocated.store(0, STD memory_order_relaxed);
+		mPeakBytes.store(mBytesLive.load(STD memory_order_relaxed), STD memory_order_relaxed);
+		for (auto& bucket : mHistogram)
+		{
+			bucket.store(0, STD memory_order_relaxed);
+		}
+	}
+
+	NODISCARD static constexpr STD size_t sizeClassOf(const STD size_t bytes) JLIBCXX_NOEXCEPT
+	{
+		const auto width = static_cast<STD size_t>(STD bit_width(bytes));
+		return width < AllocationStats::sizeClasses ? width : AllocationStats::sizeClasses - 1;
+	}
+
+private:
+
+	STD atomic<STD size_t> mAllocations{ 0 };
+	STD atomic<STD size_t> mDeallocations{ 0 };
+	STD atomic<STD size_t> mBytesAllocated{ 0 };
+	STD atomic<STD size_t> mBytesLive{ 0 };
+	STD atomic<STD size_t> mPeakBytes{ 0 };
+	STD atomic<STD size_t> mHistogram[AllocationStats::sizeClasses] = {};
+};
+
+/*
+* Allocator adaptor that reports every allocate/deallocate of Upstream to an AllocationCounter.
+*
+* A default constructed allocator reports to AllocationCounter::forTag<Tag>(), pass a counter
+* to measure a single container:
+*
+*	AllocationCounter counter;
+*	Vector<int, CountingAllocator<int>> v(CountingAllocator<int>(counter));
+*	...
+*	AllocationStats stats = counter.snapshot();
+*
+* The counter follows the memory on assignment and swap. Equality is that of Upstream.
+*/
+template <typename T, typename Upstream = AllocatorBase<T>, typename Tag = void>
+class CountingAllocator
+{
+private:
+
+	using Upstream_Type = typename MyAlloctTraits<Upstream>:: template rebind<T>::other;
+	using Upstream_Traits = MyAlloctTraits<Upstream_Type>;
+
+	template <typename, typename, typename>
+	friend class CountingAllocator;
+
+public:
+
+	using value_type = T;
+	using size_type = typename Upstream_Traits::size_type;
+	using difference_type = typename Upstream_Traits::difference_type;
+	using pointer = typename Upstream_Traits::pointer;
+	using const_pointer = typename Upstream_Traits::const_pointer;
+
+	using propagate_on_container_copy_assignment = STD true_type;
+	using propagate_on_container_move_assignment = STD true_type;
+	using propagate_on_container_swap = STD true_type;
+	using is_always_equal = typename Upstream_Traits::is_always_equal;
+
+	template <typename T2>
+	struct rebind
+	{
+		using other = CountingAllocator<T2, typename MyAlloctTraits<Upstream>:: template rebind<T2>::other, Tag>;
+	};
+
+	CountingAllocator() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<Upstream_Type>)
+		: mUpstream(), mCounter(STD addressof(AllocationCounter::forTag<Tag>()))
+	{ }
+
+	explicit CountingAllocator(AllocationCounter& counter, const Upstream_Type& upstream = Upstream_Type())
+		: mUpstream(upstream), mCounter(STD addressof(counter))
+	{ }
+
+	CountingAllocator(const CountingAllocator&) = default;
+
+	template <typename T2, typename Upstream2>
+	CountingAllocator(const CountingAllocator<T2, Upstream2, Tag>& other)
+		: mUpstream(other.mUpstream), mCounter(other.mCounter)
+	{ }
+
+	CountingAllocator& operator=(const CountingAllocator&) = default;
+
+	~CountingAllocator() = default;
+
+	NODISCARD pointer allocate(size_type n)
+	{
+		pointer result = Upstream_Traits::allocate(mUpstream, n); // Throw
+		mCounter->recordAllocation(n * sizeof(T));
+		return result;
+	}
+
+	void deallocate(pointer ptr, size_type n) JLIBCXX_NOEXCEPT
+	{
+		mCounter->recordDeallocation(n * sizeof(T));
+		Upstream_Traits::deallocate(mUpstream, ptr, n);
+	}
+
+	template <typename Type, typename... Args>
+	void construct(Type* ptr, Args&&... args)
+	{
+		Upstream_Traits::construct(mUpstream, ptr, STD forward<Args>(args)...);
+	}
+
+	template <typename Type>
+	void destroy(Type* ptr)
+	{
+		Upstream_Traits::destroy(mUpstream, ptr);
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return Upstream_Traits::max_size(mUpstream);
+	}
+
+	NODISCARD CountingAllocator select_on_container_copy_construction() const
+	{
+		return CountingAllocator(*mCounter, Upstream_Traits::select_on_container_copy_construction(mUpstream));
+	}
+
+	NODISCARD AllocationCounter& counter() const JLIBCXX_NOEXCEPT
+	{
+		return *mCounter;
+	}
+
+	NODISCARD AllocationStats stats() const JLIBCXX_NOEXCEPT
+	{
+		return mCounter->snapshot();
+	}
+
+	NODISCARD const Upstream_Type& upstream() const JLIBCXX_NOEXCEPT
+	{
+		return mUpstream;
+	}
+
+	template <typename T2, typename Upstream2>
+	friend bool operator==(const CountingAllocator& left, const CountingAllocator<T2, Upstream2, Tag>& right) JLIBCXX_NOEXCEPT
+	{
+		if constexpr (is_always_equal::value)
+		{
+			return true;
+		}
+		else
+		{
+			return left.upstream() == right.upstream();
+		}
+	}
+
+private:
+
+	Upstream_Type mUpstream;
+	AllocationCounter* mCounter;
+};
+
+template <typename T, typename Upstream, typename Tag>
+struct is_default_construct_allocator<CountingAllocator<T, Upstream, Tag>>
+	: is_default_construct_allocator<typename MyAlloctTraits<Upstream>:: template rebind<T>::other> {};
+
+JSTD_END
+
+#endif // !COUNTING_ALLOCATOR
@@ -1 +1,1607 @@
 #pragma once
+#ifndef DEQUE
+#define DEQUE
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+
+JSTD_START
+
+// Elements per block of a Deque<T>, see JSTD_DEQUE_BLOCK_BYTES.
+template <typename T>
+NODISCARD constexpr STD size_t dequeBlockSize() JLIBCXX_NOEXCEPT
+{
+	return sizeof(T) < JSTD_DEQUE_BLOCK_BYTES ? JSTD_DEQUE_BLOCK_BYTES / sizeof(T) : 1;
+}
+
+/*
+* Random access iterator over the blocks of a Deque.
+* mCur is the element, [mFirst, mLast) its block and mNode the block's slot in the map.
+*/
+template <typename T, typename Ref, typename Ptr>
+class DequeIterator
+{
+public:
+
+	using iterator_category = STD random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = STD ptrdiff_t;
+	using reference = Ref;
+	using pointer = Ptr;
+	using MapPointer = T**;
+
+	using Iterator = DequeIterator<T, T&, T*>;
+	using ConstIterator = DequeIterator<T, const T&, const T*>;
+
+	T* mCur;
+	T* mFirst;
+	T* mLast;
+	MapPointer mNode;
+
+	NODISCARD static constexpr difference_type blockSize() JLIBCXX_NOEXCEPT
+	{
+		return static_cast<difference_type>(dequeBlockSize<T>());
+	}
+
+	DequeIterator() JLIBCXX_NOEXCEPT
+		: mCur(), mFirst(), mLast(), mNode()
+	{ }
+
+	DequeIterator(T* cur, MapPointer node) JLIBCXX_NOEXCEPT
+		: mCur(cur), mFirst(*node), mLast(*node + blockSize()), mNode(node)
+	{ }
+
+	// iterator to const_iterator.
+	template <typename Iter, typename = STD enable_if_t<
+		STD is_same_v<DequeIterator, ConstIterator> && STD is_same_v<Iter, Iterator>>>
+	DequeIterator(const Iter& other) JLIBCXX_NOEXCEPT
+		: mCur(other.mCur), mFirst(other.mFirst), mLast(other.mLast), mNode(other.mNode)
+	{ }
+
+	NODISCARD Iterator constCast() const JLIBCXX_NOEXCEPT
+	{
+		Iterator result;
+		result.mCur = mCur;
+		result.mFirst = mFirst;
+		result.mLast = mLast;
+		result.mNode = mNode;
+		return result;
+	}
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return *mCur;
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return mCur;
+	}
+
+	DequeIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		++mCur;
+		if (mCur == mLast)
+		{
+			setNode(mNode + 1);
+			mCur = mFirst;
+		}
+
+		return *this;
+	}
+
+	DequeIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		DequeIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	DequeIterator& operator--() JLIBCXX_NOEXCEPT
+	{
+		if (mCur == mFirst)
+		{
+			setNode(mNode - 1);
+			mCur = mLast;
+		}
+
+		--mCur;
+		return *this;
+	}
+
+	DequeIterator operator--(int) JLIBCXX_NOEXCEPT
+	{
+		DequeIterator temp = *this;
+		--*this;
+		return temp;
+	}
+
+	DequeIterator& operator+=(const difference_type n) JLIBCXX_NOEXCEPT
+	{
+		const difference_type offset = n + (mCur - mFirst);
+		if (offset >= 0 && offset < blockSize())
+		{
+			mCur += n;
+			return *this;
+		}
+
+		const difference_type nodeOffset = offset > 0
+			? offset / blockSize()
+			: -((-offset - 1) / blockSize()) - 1;
+		setNode(mNode + nodeOffset);
+		mCur = mFirst + (offset - nodeOffset * blockSize());
+		return *this;
+	}
+
+	DequeIterator& operator-=(const difference_type n) JLIBCXX_NOEXCEPT
+	{
+		return *this += -n;
+	}
+
+	NODISCARD DequeIterator operator+(const difference_type n) const JLIBCXX_NOEXCEPT
+	{
+		DequeIterator temp = *this;
+		return temp += n;
+	}
+
+	NODISCARD DequeIterator operator-(const difference_type n) const JLIBCXX_NOEXCEPT
+	{
+		DequeIterator temp = *this;
+		return temp -= n;
+	}
+
+	reference operator[](const difference_type n) const JLIBCXX_NOEXCEPT
+	{
+		return *(*this + n);
+	}
+
+	void setNode(const MapPointer newNode) JLIBCXX_NOEXCEPT
+	{
+		mNode = newNode;
+		mFirst = *newNode;
+		mLast = mFirst + blockSize();
+	}
+};
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator==(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return lhs.mCur == rhs.mCur;
+}
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator!=(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return lhs.mCur != rhs.mCur;
+}
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator<(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return lhs.mNode == rhs.mNode ? lhs.mCur < rhs.mCur : lhs.mNode < rhs.mNode;
+}
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator>(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return rhs < lhs;
+}
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator<=(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return !(rhs < lhs);
+}
+
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline bool operator>=(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	return !(lhs < rhs);
+}
+
+// Also right for the null iterators of a Deque that has no map yet.
+template <typename T, typename RefL, typename PtrL, typename RefR, typename PtrR>
+inline typename DequeIterator<T, RefL, PtrL>::difference_type
+operator-(const DequeIterator<T, RefL, PtrL>& lhs, const DequeIterator<T, RefR, PtrR>& rhs) JLIBCXX_NOEXCEPT
+{
+	using Diff = typename DequeIterator<T, RefL, PtrL>::difference_type;
+	return DequeIterator<T, RefL, PtrL>::blockSize() * (lhs.mNode - rhs.mNode - Diff(lhs.mNode != nullptr))
+		+ (lhs.mCur - lhs.mFirst)
+		+ (rhs.mLast - rhs.mCur);
+}
+
+template <typename T, typename Ref, typename Ptr>
+inline DequeIterator<T, Ref, Ptr>
+operator+(const typename DequeIterator<T, Ref, Ptr>::difference_type n, const DequeIterator<T, Ref, Ptr>& itr) JLIBCXX_NOEXCEPT
+{
+	return itr + n;
+}
+
+/*
+* Owns the map and the blocks of a Deque, the elements are managed by Deque.
+*
+* The map is an array of block pointers, the used slots are [mStart.mNode, mFinish.mNode].
+* mFinish.mCur never sits on the end of its block, so the block of end() always exists.
+* A default constructed or moved-from Deque has no map at all and null iterators.
+*
+* Freed blocks are kept in a small cache, a Deque used as a queue reuses the
+* block it just emptied at the front when it needs a new one at the back.
+*/
+template <typename T, typename Alloc>
+class DequeBase
+{
+public:
+
+	using T_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<T>::other;
+	using Alloc_Traits = MyAlloctTraits<T_Alloc_Type>;
+	using Map_Alloc_Type = typename Alloc_Traits:: template rebind<T*>::other;
+	using Map_Alloc_Traits = MyAlloctTraits<Map_Alloc_Type>;
+	using allocator_type = Alloc;
+
+	using iterator = DequeIterator<T, T&, T*>;
+	using const_iterator = DequeIterator<T, const T&, const T*>;
+	using MapPointer = T**;
+
+	static_assert(STD is_pointer_v<typename Alloc_Traits::pointer>, "jstd::Deque needs an allocator with raw pointers.");
+
+	static constexpr STD size_t blockSize = dequeBlockSize<T>();
+	static constexpr STD size_t initialMapSize = 8;
+	static constexpr STD size_t blockCacheCapacity = 4;
+
+	class DequeImplData
+	{
+	public:
+		MapPointer mMap = nullptr;
+		STD size_t mMapSize = 0;
+		iterator mStart;
+		iterator mFinish;
+		T* mCache[blockCacheCapacity] = {};
+		STD size_t mCacheCount = 0;
+
+		DequeImplData() = default;
+
+		DequeImplData(DequeImplData&& other) JLIBCXX_NOEXCEPT
+		{
+			swapData(other);
+		}
+
+		void swapData(DequeImplData& other) JLIBCXX_NOEXCEPT
+		{
+			using STD swap;
+			swap(mMap, other.mMap);
+			swap(mMapSize, other.mMapSize);
+			swap(mStart, other.mStart);
+			swap(mFinish, other.mFinish);
+			swap(mCache, other.mCache);
+			swap(mCacheCount, other.mCacheCount);
+		}
+	};
+
+	class DequeImpl : public T_Alloc_Type, public DequeImplData
+	{
+	public:
+
+		DequeImpl() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<T_Alloc_Type>)
+			: T_Alloc_Type()
+		{ }
+
+		DequeImpl(const T_Alloc_Type& alloc) JLIBCXX_NOEXCEPT
+			: T_Alloc_Type(alloc)
+		{ }
+
+		DequeImpl(DequeImpl&& other) JLIBCXX_NOEXCEPT
+			: T_Alloc_Type(STD move(other)), DequeImplData(STD move(other))
+		{ }
+	};
+
+	DequeImpl mImpl;
+
+	T_Alloc_Type& getTAllocator() JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	NODISCARD const T_Alloc_Type& getTAllocator() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	NODISCARD allocator_type get_allocator() const JLIBCXX_NOEXCEPT
+	{
+		return allocator_type(getTAllocator());
+	}
+
+	DequeBase() = default;
+
+	DequeBase(DequeBase&&) = default;
+
+	DequeBase(const allocator_type& alloc) JLIBCXX_NOEXCEPT
+		: mImpl(T_Alloc_Type(alloc))
+	{ }
+
+	DequeBase(const allocator_type& alloc, const STD size_t numElements)
+		: mImpl(T_Alloc_Type(alloc))
+	{
+		initializeMap(numElements);
+	}
+
+	~DequeBase() JLIBCXX_NOEXCEPT
+	{
+		if (mImpl.mMap)
+		{
+			destroyBlocks(mImpl.mStart.mNode, mImpl.mFinish.mNode + 1);
+			deallocateMap(mImpl.mMap, mImpl.mMapSize);
+		}
+
+		releaseCache();
+	}
+
+	// Blocks come from the cache first.
+	T* allocateBlock()
+	{
+		if (mImpl.mCacheCount)
+		{
+			return mImpl.mCache[--mImpl.mCacheCount];
+		}
+
+		return Alloc_Traits::allocate(mImpl, blockSize);
+	}
+
+	void deallocateBlock(T* block) JLIBCXX_NOEXCEPT
+	{
+		if (mImpl.mCacheCount < blockCacheCapacity)
+		{
+			mImpl.mCache[mImpl.mCacheCount++] = block;
+			return;
+		}
+
+		Alloc_Traits::deallocate(mImpl, block, blockSize);
+	}
+
+	void releaseCache() JLIBCXX_NOEXCEPT
+	{
+		for (; mImpl.mCacheCount; --mImpl.mCacheCount)
+		{
+			Alloc_Traits::deallocate(mImpl, mImpl.mCache[mImpl.mCacheCount - 1], blockSize);
+		}
+	}
+
+	MapPointer allocateMap(const STD size_t n)
+	{
+		Map_Alloc_Type mapAlloc(getTAllocator());
+		return Map_Alloc_Traits::allocate(mapAlloc, n);
+	}
+
+	void deallocateMap(MapPointer map, const STD size_t n) JLIBCXX_NOEXCEPT
+	{
+		Map_Alloc_Type mapAlloc(getTAllocator());
+		Map_Alloc_Traits::deallocate(mapAlloc, map, n);
+	}
+
+	void createBlocks(MapPointer first, MapPointer last)
+	{
+		MapPointer current = first;
+		TRY_START
+		for (; current < last; ++current)
+		{
+			*current = allocateBlock();
+		}
+		CATCH_ALL
+		destroyBlocks(first, current);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	void destroyBlocks(MapPointer first, MapPointer last) JLIBCXX_NOEXCEPT
+	{
+		for (; first < last; ++first)
+		{
+			deallocateBlock(*first);
+		}
+	}
+
+	// Room for numElements, centred in the map so both ends can grow.
+	void initializeMap(const STD size_t numElements)
+	{
+		const STD size_t numNodes = numElements / blockSize + 1;
+		mImpl.mMapSize = STD max(initialMapSize, numNodes + 2);
+		mImpl.mMap = allocateMap(mImpl.mMapSize);
+
+		const MapPointer nodeStart = mImpl.mMap + (mImpl.mMapSize - numNodes) / 2;
+		const MapPointer nodeFinish = nodeStart + numNodes;
+
+		TRY_START
+		createBlocks(nodeStart, nodeFinish);
+		CATCH_ALL
+		deallocateMap(mImpl.mMap, mImpl.mMapSize);
+		mImpl.mMap = MapPointer();
+		mImpl.mMapSize = 0;
+		THROW_AGAIN
+		END_CATCH
+
+		mImpl.mStart.setNode(nodeStart);
+		mImpl.mFinish.setNode(nodeFinish - 1);
+		mImpl.mStart.mCur = mImpl.mStart.mFirst;
+		mImpl.mFinish.mCur = mImpl.mFinish.mFirst + numElements % blockSize;
+	}
+
+	void swapStorage(DequeBase& other) JLIBCXX_NOEXCEPT
+	{
+		mImpl.swapData(other.mImpl);
+	}
+};
+
+/*
+* Double ended queue made of fixed size blocks.
+*
+* push and pop at both ends are O(1) and never move elements, references stay valid
+* unless the element is erased. Insertion in the middle moves the shorter side.
+*/
+template <typename T, typename Alloc = STD allocator<T>>
+class Deque : protected DequeBase<T, Alloc>
+{
+private:
+
+	static_assert(STD is_same_v<typename STD remove_cv_t<T>, T>,
+		"jstd::Deque must have a non-const, non-volatile value_type");
+
+	using Base = DequeBase<T, Alloc>;
+	using T_Alloc_Type = typename Base::T_Alloc_Type;
+	using Alloc_Traits = typename Base::Alloc_Traits;
+	using MapPointer = typename Base::MapPointer;
+
+	using Base::blockSize;
+	using Base::mImpl;
+	using Base::getTAllocator;
+	using Base::allocateBlock;
+	using Base::deallocateBlock;
+	using Base::destroyBlocks;
+	using Base::initializeMap;
+
+public:
+
+	using value_type = T;
+	using pointer = typename Alloc_Traits::pointer;
+	using const_pointer = typename Alloc_Traits::const_pointer;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using iterator = typename Base::iterator;
+	using const_iterator = typename Base::const_iterator;
+	using const_reverse_iterator = STD reverse_iterator<const_iterator>;
+	using reverse_iterator = STD reverse_iterator<iterator>;
+	using size_type = typename Alloc_Traits::size_type;
+	using difference_type = typename Alloc_Traits::difference_type;
+	using allocator_type = Alloc;
+
+	using Base::get_allocator;
+
+private:
+
+	static size_type maxSize(const T_Alloc_Type& alloc) JLIBCXX_NOEXCEPT
+	{
+		constexpr STD size_t diffMax = STD numeric_limits<STD ptrdiff_t>::max() / sizeof(T);
+		const STD size_t allocMax = Alloc_Traits::max_size(alloc);
+		return STD min(diffMax, allocMax);
+	}
+
+	[[noreturn]] static void throwLengthError(const char* str)
+	{
+		throw STD runtime_error(str);
+	}
+
+	NODISCARD static size_type checkLength(size_type n, const allocator_type& alloc)
+	{
+		if (n > maxSize(T_Alloc_Type(alloc)))
+		{
+			throwLengthError("cannot create jstd::Deque larger than max_size()");
+		}
+
+		return n;
+	}
+
+	void rangeCheck(size_type n) const
+	{
+		if (n >= size())
+		{
+			throw STD logic_error(myFormat(
+				"Deque::rangeCheck: n "
+				"(which is %zu) >= size() "
+				"(which is %zu)",
+				n,
+				size()));
+		}
+	}
+
+	void ensureMap()
+	{
+		if (!mImpl.mMap)
+		{
+			initializeMap(0);
+		}
+	}
+
+	/*
+	* Make room for nodesToAdd more blocks at one end of the map.
+	* Recentres the used slots if the map is less than half full, otherwise allocates a bigger map.
+	* Only block pointers move, iterators into the elements stay valid apart from their mNode.
+	*/
+	void reallocateMap(const size_type nodesToAdd, const bool addAtFront)
+	{
+		const size_type oldNumNodes = mImpl.mFinish.mNode - mImpl.mStart.mNode + 1;
+		const size_type newNumNodes = oldNumNodes + nodesToAdd;
+
+		MapPointer newStart;
+		if (mImpl.mMapSize > 2 * newNumNodes)
+		{
+			newStart = mImpl.mMap + (mImpl.mMapSize - newNumNodes) / 2 + (addAtFront ? nodesToAdd : 0);
+			if (newStart < mImpl.mStart.mNode)
+			{
+				STD copy(mImpl.mStart.mNode, mImpl.mFinish.mNode + 1, newStart);
+			}
+			else
+			{
+				STD copy_backward(mImpl.mStart.mNode, mImpl.mFinish.mNode + 1, newStart + oldNumNodes);
+			}
+		}
+		else
+		{
+			const size_type newMapSize = mImpl.mMapSize + STD max(mImpl.mMapSize, nodesToAdd) + 2;
+			const MapPointer newMap = this->allocateMap(newMapSize);
+			newStart = newMap + (newMapSize - newNumNodes) / 2 + (addAtFront ? nodesToAdd : 0);
+			STD copy(mImpl.mStart.mNode, mImpl.mFinish.mNode + 1, newStart);
+			this->deallocateMap(mImpl.mMap, mImpl.mMapSize);
+
+			mImpl.mMap = newMap;
+			mImpl.mMapSize = newMapSize;
+		}
+
+		mImpl.mStart.setNode(newStart);
+		mImpl.mFinish.setNode(newStart + oldNumNodes - 1);
+	}
+
+	void reserveMapAtBack(const size_type nodesToAdd = 1)
+	{
+		if (nodesToAdd + 1 > mImpl.mMapSize - (mImpl.mFinish.mNode - mImpl.mMap))
+		{
+			reallocateMap(nodesToAdd, false);
+		}
+	}
+
+	void reserveMapAtFront(const size_type nodesToAdd = 1)
+	{
+		if (nodesToAdd > size_type(mImpl.mStart.mNode - mImpl.mMap))
+		{
+			reallocateMap(nodesToAdd, true);
+		}
+	}
+
+	void newElementsAtBack(const size_type newElements)
+	{
+		if (max_size() - size() < newElements)
+		{
+			throwLengthError("Deque::newElementsAtBack");
+		}
+
+		const size_type newNodes = (newElements + blockSize - 1) / blockSize;
+		reserveMapAtBack(newNodes);
+		this->createBlocks(mImpl.mFinish.mNode + 1, mImpl.mFinish.mNode + 1 + newNodes);
+	}
+
+	void newElementsAtFront(const size_type newElements)
+	{
+		if (max_size() - size() < newElements)
+		{
+			throwLengthError("Deque::newElementsAtFront");
+		}
+
+		const size_type newNodes = (newElements + blockSize - 1) / blockSize;
+		reserveMapAtFront(newNodes);
+		this->createBlocks(mImpl.mStart.mNode - newNodes, mImpl.mStart.mNode);
+	}
+
+	// Blocks for n more elements after end(). Returns the future end().
+	iterator reserveElementsAtBack(const size_type n)
+	{
+		ensureMap();
+		const size_type vacancies = (mImpl.mFinish.mLast - mImpl.mFinish.mCur) - 1;
+		if (n > vacancies)
+		{
+			newElementsAtBack(n - vacancies);
+		}
+
+		return mImpl.mFinish + difference_type(n);
+	}
+
+	// Blocks for n more elements before begin(). Returns the future begin().
+	iterator reserveElementsAtFront(const size_type n)
+	{
+		ensureMap();
+		const size_type vacancies = mImpl.mStart.mCur - mImpl.mStart.mFirst;
+		if (n > vacancies)
+		{
+			newElementsAtFront(n - vacancies);
+		}
+
+		return mImpl.mStart - difference_type(n);
+	}
+
+	// Give back blocks that reserveElementsAt* took but that received no element.
+	void releaseBlocksAfter(const iterator& newFinish) JLIBCXX_NOEXCEPT
+	{
+		destroyBlocks(mImpl.mFinish.mNode + 1, newFinish.mNode + 1);
+	}
+
+	void releaseBlocksBefore(const iterator& newStart) JLIBCXX_NOEXCEPT
+	{
+		destroyBlocks(newStart.mNode, mImpl.mStart.mNode);
+	}
+
+	// Destroy [first, last) one block at a time.
+	void destroyData(iterator first, iterator last) JLIBCXX_NOEXCEPT
+	{
+		auto& alloc = getTAllocator();
+		if (first.mNode == last.mNode)
+		{
+			myDestroy(first.mCur, last.mCur, alloc);
+			return;
+		}
+
+		for (MapPointer node = first.mNode + 1; node < last.mNode; ++node)
+		{
+			myDestroy(*node, *node + blockSize, alloc);
+		}
+
+		myDestroy(first.mCur, first.mLast, alloc);
+		myDestroy(last.mFirst, last.mCur, alloc);
+	}
+
+	void eraseAtEnd(iterator pos) JLIBCXX_NOEXCEPT
+	{
+		destroyData(pos, mImpl.mFinish);
+		destroyBlocks(pos.mNode + 1, mImpl.mFinish.mNode + 1);
+		mImpl.mFinish = pos;
+	}
+
+	void eraseAtBegin(iterator pos) JLIBCXX_NOEXCEPT
+	{
+		destroyData(mImpl.mStart, pos);
+		destroyBlocks(mImpl.mStart.mNode, pos.mNode);
+		mImpl.mStart = pos;
+	}
+
+	/*
+	* Copy n elements from first into the uninitialized slots from dest on, one block at a time,
+	* so contiguous sources of trivially copyable T become one memmove per block.
+	*/
+	template <typename ForwardIterator>
+	iterator copyIntoBlocks(ForwardIterator first, size_type n, iterator dest)
+	{
+		auto& alloc = getTAllocator();
+		const iterator start = dest;
+
+		TRY_START
+		while (n)
+		{
+			const size_type chunk = STD min(n, size_type(dest.mLast - dest.mCur));
+			uninitializedCopyNAllocated(first, chunk, dest.mCur, alloc);
+			STD advance(first, chunk);
+			dest += difference_type(chunk);
+			n -= chunk;
+		}
+
+		return dest;
+		CATCH_ALL
+		destroyData(start, dest);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	template <typename... Args>
+	iterator constructInBlocks(iterator dest, size_type n, const Args&... args)
+	{
+		auto& alloc = getTAllocator();
+		const iterator start = dest;
+
+		TRY_START
+		for (; n; --n, ++dest)
+		{
+			Alloc_Traits::construct(alloc, dest.mCur, args...);
+		}
+
+		return dest;
+		CATCH_ALL
+		destroyData(start, dest);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	template <typename InputIterator>
+	void rangeInitialize(InputIterator first, InputIterator last, STD input_iterator_tag)
+	{
+		TRY_START
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+		CATCH_ALL
+		clear();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	template <typename ForwardIterator>
+	void rangeInitialize(ForwardIterator first, ForwardIterator last, STD forward_iterator_tag)
+	{
+		const size_type n = checkLength(static_cast<size_type>(myDistance(first, last)), get_allocator());
+		initializeMap(n);
+		copyIntoBlocks(first, n, mImpl.mStart);
+	}
+
+	template <typename... Args>
+	void pushBackAux(Args&&... args)
+	{
+		ensureMap();
+		if (mImpl.mFinish.mLast - mImpl.mFinish.mCur > 1)
+		{
+			Alloc_Traits::construct(getTAllocator(), mImpl.mFinish.mCur, STD forward<Args>(args)...);
+			++mImpl.mFinish.mCur;
+			return;
+		}
+
+		if (size() == max_size())
+		{
+			throwLengthError("cannot create jstd::Deque larger than max_size()");
+		}
+
+		reserveMapAtBack();
+		*(mImpl.mFinish.mNode + 1) = allocateBlock();
+
+		TRY_START
+		Alloc_Traits::construct(getTAllocator(), mImpl.mFinish.mCur, STD forward<Args>(args)...);
+		CATCH_ALL
+		deallocateBlock(*(mImpl.mFinish.mNode + 1));
+		THROW_AGAIN
+		END_CATCH
+
+		mImpl.mFinish.setNode(mImpl.mFinish.mNode + 1);
+		mImpl.mFinish.mCur = mImpl.mFinish.mFirst;
+	}
+
+	template <typename... Args>
+	void pushFrontAux(Args&&... args)
+	{
+		if (size() == max_size())
+		{
+			throwLengthError("cannot create jstd::Deque larger than max_size()");
+		}
+
+		ensureMap();
+		reserveMapAtFront();
+		*(mImpl.mStart.mNode - 1) = allocateBlock();
+
+		TRY_START
+		Alloc_Traits::construct(getTAllocator(), *(mImpl.mStart.mNode - 1) + (blockSize - 1), STD forward<Args>(args)...);
+		CATCH_ALL
+		deallocateBlock(*(mImpl.mStart.mNode - 1));
+		THROW_AGAIN
+		END_CATCH
+
+		mImpl.mStart.setNode(mImpl.mStart.mNode - 1);
+		mImpl.mStart.mCur = mImpl.mStart.mLast - 1;
+	}
+
+	// Insert one element in the middle, moving the shorter side by one.
+	template <typename... Args>
+	iterator insertAux(iterator pos, Args&&... args)
+	{
+		// The arguments may refer to an element that is about to move.
+		value_type copy(STD forward<Args>(args)...);
+
+		const difference_type index = pos - mImpl.mStart;
+		if (size_type(index) < size() / 2)
+		{
+			emplace_front(STD move(front()));
+			iterator front1 = mImpl.mStart + 1;
+			iterator front2 = front1 + 1;
+			pos = mImpl.mStart + index;
+			STD move(front2, pos + 1, front1);
+		}
+		else
+		{
+			emplace_back(STD move(back()));
+			iterator back1 = mImpl.mFinish - 1;
+			iterator back2 = back1 - 1;
+			pos = mImpl.mStart + index;
+			STD move_backward(pos, back2, back1);
+		}
+
+		*pos = STD move(copy);
+		return pos;
+	}
+
+	/*
+	* Open a gap of n slots before pos on the shorter side and fill it from first.
+	* The part of the gap beyond the old ends is constructed, the rest assigned.
+	*/
+	template <typename ForwardIterator>
+	iterator insertCounted(const_iterator position, ForwardIterator first, const size_type n)
+	{
+		const difference_type elementsBefore = position - mImpl.mStart;
+		if (n == 0)
+		{
+			return mImpl.mStart + elementsBefore;
+		}
+
+		auto& alloc = getTAllocator();
+		const size_type length = size();
+
+		if (size_type(elementsBefore) < length / 2)
+		{
+			const iterator newStart = reserveElementsAtFront(n);
+			const iterator oldStart = mImpl.mStart;
+			const iterator pos = mImpl.mStart + elementsBefore;
+
+			TRY_START
+			if (size_type(elementsBefore) >= n)
+			{
+				const iterator startN = mImpl.mStart + difference_type(n);
+				uninitializedMoveAllocated(mImpl.mStart, startN, newStart, alloc);
+				mImpl.mStart = newStart;
+				STD move(startN, pos, oldStart);
+				STD copy_n(first, n, pos - difference_type(n));
+			}
+			else
+			{
+				ForwardIterator mid = first;
+				STD advance(mid, difference_type(n) - elementsBefore);
+				const iterator moved = uninitializedMoveAllocated(mImpl.mStart, pos, newStart, alloc);
+				TRY_START
+				copyIntoBlocks(first, n - elementsBefore, moved);
+				CATCH_ALL
+				destroyData(newStart, moved);
+				THROW_AGAIN
+				END_CATCH
+				mImpl.mStart = newStart;
+				STD copy(mid, STD next(mid, elementsBefore), oldStart);
+			}
+			CATCH_ALL
+			if (mImpl.mStart != newStart)
+			{
+				releaseBlocksBefore(newStart);
+			}
+			THROW_AGAIN
+			END_CATCH
+		}
+		else
+		{
+			const iterator newFinish = reserveElementsAtBack(n);
+			const iterator oldFinish = mImpl.mFinish;
+			const difference_type elementsAfter = difference_type(length) - elementsBefore;
+			const iterator pos = mImpl.mFinish - elementsAfter;
+
+			TRY_START
+			if (size_type(elementsAfter) > n)
+			{
+				const iterator finishN = mImpl.mFinish - difference_type(n);
+				uninitializedMoveAllocated(finishN, mImpl.mFinish, mImpl.mFinish, alloc);
+				mImpl.mFinish = newFinish;
+				STD move_backward(pos, finishN, oldFinish);
+				STD copy_n(first, n, pos);
+			}
+			else
+			{
+				ForwardIterator mid = first;
+				STD advance(mid, elementsAfter);
+				const iterator copied = copyIntoBlocks(mid, n - elementsAfter, mImpl.mFinish);
+				TRY_START
+				uninitializedMoveAllocated(pos, mImpl.mFinish, copied, alloc);
+				CATCH_ALL
+				destroyData(mImpl.mFinish, copied);
+				THROW_AGAIN
+				END_CATCH
+				mImpl.mFinish = newFinish;
+				STD copy(first, mid, pos);
+			}
+			CATCH_ALL
+			if (mImpl.mFinish != newFinish)
+			{
+				releaseBlocksAfter(newFinish);
+			}
+			THROW_AGAIN
+			END_CATCH
+		}
+
+		return mImpl.mStart + elementsBefore;
+	}
+
+	// Same as insertCounted with n copies of value.
+	iterator insertFill(const_iterator position, const size_type n, const value_type& value)
+	{
+		const difference_type elementsBefore = position - mImpl.mStart;
+		if (n == 0)
+		{
+			return mImpl.mStart + elementsBefore;
+		}
+
+		// value may refer to an element that is about to move.
+		const value_type copy(value);
+		auto& alloc = getTAllocator();
+		const size_type length = size();
+
+		if (size_type(elementsBefore) < length / 2)
+		{
+			const iterator newStart = reserveElementsAtFront(n);
+			const iterator oldStart = mImpl.mStart;
+			const iterator pos = mImpl.mStart + elementsBefore;
+
+			TRY_START
+			if (size_type(elementsBefore) >= n)
+			{
+				const iterator startN = mImpl.mStart + difference_type(n);
+				uninitializedMoveAllocated(mImpl.mStart, startN, newStart, alloc);
+				mImpl.mStart = newStart;
+				STD move(startN, pos, oldStart);
+				STD fill(pos - difference_type(n), pos, copy);
+			}
+			else
+			{
+				const iterator moved = uninitializedMoveAllocated(mImpl.mStart, pos, newStart, alloc);
+				TRY_START
+				constructInBlocks(moved, n - elementsBefore, copy);
+				CATCH_ALL
+				destroyData(newStart, moved);
+				THROW_AGAIN
+				END_CATCH
+				mImpl.mStart = newStart;
+				STD fill(oldStart, pos, copy);
+			}
+			CATCH_ALL
+			if (mImpl.mStart != newStart)
+			{
+				releaseBlocksBefore(newStart);
+			}
+			THROW_AGAIN
+			END_CATCH
+		}
+		else
+		{
+			const iterator newFinish = reserveElementsAtBack(n);
+			const iterator oldFinish = mImpl.mFinish;
+			const difference_type elementsAfter = difference_type(length) - elementsBefore;
+			const iterator pos = mImpl.mFinish - elementsAfter;
+
+			TRY_START
+			if (size_type(elementsAfter) > n)
+			{
+				const iterator finishN = mImpl.mFinish - difference_type(n);
+				uninitializedMoveAllocated(finishN, mImpl.mFinish, mImpl.mFinish, alloc);
+				mImpl.mFinish = newFinish;
+				STD move_backward(pos, finishN, oldFinish);
+				STD fill(pos, pos + difference_type(n), copy);
+			}
+			else
+			{
+				const iterator filled = constructInBlocks(mImpl.mFinish, n - elementsAfter, copy);
+				TRY_START
+				uninitializedMoveAllocated(pos, mImpl.mFinish, filled, alloc);
+				CATCH_ALL
+				destroyData(mImpl.mFinish, filled);
+				THROW_AGAIN
+				END_CATCH
+				mImpl.mFinish = newFinish;
+				STD fill(pos, oldFinish, copy);
+			}
+			CATCH_ALL
+			if (mImpl.mFinish != newFinish)
+			{
+				releaseBlocksAfter(newFinish);
+			}
+			THROW_AGAIN
+			END_CATCH
+		}
+
+		return mImpl.mStart + elementsBefore;
+	}
+
+	// Single pass ranges are appended directly or buffered first.
+	template <typename InputIterator>
+	iterator insertRange(const_iterator pos, InputIterator first, InputIterator last, STD input_iterator_tag)
+	{
+		if (pos == cend())
+		{
+			const difference_type index = pos - cbegin();
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+
+			return begin() + index;
+		}
+
+		Deque temp(first, last, get_allocator());
+		return insertCounted(pos, STD make_move_iterator(temp.begin()), temp.size());
+	}
+
+	template <typename ForwardIterator>
+	iterator insertRange(const_iterator pos, ForwardIterator first, ForwardIterator last, STD forward_iterator_tag)
+	{
+		return insertCounted(pos, first, static_cast<size_type>(myDistance(first, last)));
+	}
+
+	template <typename InputIterator>
+	void assignRange(InputIterator first, InputIterator last, STD input_iterator_tag)
+	{
+		iterator current = begin();
+		for (; first != last && current != end(); ++current, ++first)
+		{
+			*current = *first;
+		}
+
+		if (first == last)
+		{
+			eraseAtEnd(current);
+			return;
+		}
+
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+	}
+
+	template <typename ForwardIterator>
+	void assignRange(ForwardIterator first, ForwardIterator last, STD forward_iterator_tag)
+	{
+		const size_type n = static_cast<size_type>(myDistance(first, last));
+		if (n > size())
+		{
+			ForwardIterator mid = first;
+			STD advance(mid, size());
+			STD copy(first, mid, begin());
+			insertCounted(cend(), mid, n - size());
+			return;
+		}
+
+		eraseAtEnd(STD copy(first, last, begin()));
+	}
+
+public:
+
+	Deque() = default;
+
+	explicit Deque(const allocator_type& alloc) JLIBCXX_NOEXCEPT
+		: Base(alloc)
+	{ }
+
+	explicit Deque(size_type n, const allocator_type& alloc = allocator_type())
+		: Base(alloc, checkLength(n, alloc))
+	{
+		constructInBlocks(mImpl.mStart, n);
+	}
+
+	Deque(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+		: Base(alloc, checkLength(n, alloc))
+	{
+		constructInBlocks(mImpl.mStart, n, value);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	Deque(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+		: Base(alloc)
+	{
+		rangeInitialize(first, last, iterator_category_t<InputIterator>{});
+	}
+
+	Deque(STD initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+		: Base(alloc)
+	{
+		rangeInitialize(ilist.begin(), ilist.end(), STD random_access_iterator_tag{});
+	}
+
+	Deque(const Deque& other)
+		: Base(Alloc_Traits::select_on_container_copy_construction(other.getTAllocator()))
+	{
+		rangeInitialize(other.begin(), other.end(), STD random_access_iterator_tag{});
+	}
+
+	Deque(const Deque& other, const allocator_type& alloc)
+		: Base(alloc)
+	{
+		rangeInitialize(other.begin(), other.end(), STD random_access_iterator_tag{});
+	}
+
+	// Takes the map and the blocks, other is left without a map.
+	Deque(Deque&&) = default;
+
+	Deque(Deque&& other, const allocator_type& alloc)
+		: Base(alloc)
+	{
+		if (Alloc_Traits::always_equal_v() || getTAllocator() == other.getTAllocator())
+		{
+			this->swapStorage(other);
+			return;
+		}
+
+		rangeInitialize(STD make_move_iterator(other.begin()), STD make_move_iterator(other.end()),
+			STD random_access_iterator_tag{});
+		other.clear();
+	}
+
+	~Deque() JLIBCXX_NOEXCEPT
+	{
+		destroyData(mImpl.mStart, mImpl.mFinish);
+	}
+
+	Deque& operator=(const Deque& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		if constexpr (Alloc_Traits::propagate_on_container_copy_assignment_v())
+		{
+			if (!Alloc_Traits::always_equal_v() && getTAllocator() != other.getTAllocator())
+			{
+				// Everything has to go back to the allocator it came from.
+				Deque(get_allocator()).swapStorage(*this);
+			}
+
+			Alloc_Traits::doCopy(getTAllocator(), other.getTAllocator());
+		}
+
+		assignRange(other.begin(), other.end(), STD random_access_iterator_tag{});
+		return *this;
+	}
+
+	Deque& operator=(Deque&& other) JLIBCXX_NOEXCEPT_IF(Alloc_Traits::nothrow_move())
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		if constexpr (!Alloc_Traits::nothrow_move())
+		{
+			if (getTAllocator() != other.getTAllocator())
+			{
+				assignRange(STD make_move_iterator(other.begin()), STD make_move_iterator(other.end()),
+					STD random_access_iterator_tag{});
+				other.clear();
+				return *this;
+			}
+		}
+
+		// The old storage is released by temp, with the allocator it came from.
+		Deque temp(get_allocator());
+		this->swapStorage(temp);
+		this->swapStorage(other);
+		Alloc_Traits::doMove(getTAllocator(), other.getTAllocator());
+		return *this;
+	}
+
+	Deque& operator=(STD initializer_list<value_type> ilist)
+	{
+		assign(ilist);
+		return *this;
+	}
+
+	void assign(size_type n, const value_type& value)
+	{
+		if (n > size())
+		{
+			STD fill(begin(), end(), value);
+			insertFill(cend(), n - size(), value);
+			return;
+		}
+
+		eraseAtEnd(begin() + difference_type(n));
+		STD fill(begin(), end(), value);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void assign(InputIterator first, InputIterator last)
+	{
+		assignRange(first, last, iterator_category_t<InputIterator>{});
+	}
+
+	void assign(STD initializer_list<value_type> ilist)
+	{
+		assignRange(ilist.begin(), ilist.end(), STD random_access_iterator_tag{});
+	}
+
+	NODISCARD iterator begin() JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mStart;
+	}
+
+	NODISCARD const_iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mStart;
+	}
+
+	NODISCARD iterator end() JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mFinish;
+	}
+
+	NODISCARD const_iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mFinish;
+	}
+
+	NODISCARD reverse_iterator rbegin() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	NODISCARD const_reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(end());
+	}
+
+	NODISCARD reverse_iterator rend() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
+	NODISCARD const_reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD const_reverse_iterator crbegin() const JLIBCXX_NOEXCEPT
+	{
+		return rbegin();
+	}
+
+	NODISCARD const_reverse_iterator crend() const JLIBCXX_NOEXCEPT
+	{
+		return rend();
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return size_type(mImpl.mFinish - mImpl.mStart);
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return maxSize(getTAllocator());
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mFinish == mImpl.mStart;
+	}
+
+	void resize(size_type n)
+	{
+		const size_type length = size();
+		if (n > length)
+		{
+			const iterator newFinish = reserveElementsAtBack(n - length);
+			TRY_START
+			constructInBlocks(mImpl.mFinish, n - length);
+			CATCH_ALL
+			releaseBlocksAfter(newFinish);
+			THROW_AGAIN
+			END_CATCH
+			mImpl.mFinish = newFinish;
+		}
+		else if (n < length)
+		{
+			eraseAtEnd(mImpl.mStart + difference_type(n));
+		}
+	}
+
+	void resize(size_type n, const value_type& value)
+	{
+		const size_type length = size();
+		if (n > length)
+		{
+			insertFill(cend(), n - length, value);
+		}
+		else if (n < length)
+		{
+			eraseAtEnd(mImpl.mStart + difference_type(n));
+		}
+	}
+
+	// Frees the cached blocks, and the map too if there are no elements.
+	void shrink_to_fit() JLIBCXX_NOEXCEPT
+	{
+		if (empty())
+		{
+			Deque(get_allocator()).swapStorage(*this);
+		}
+
+		this->releaseCache();
+	}
+
+	NODISCARD reference operator[](size_type n) JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mStart[difference_type(n)];
+	}
+
+	NODISCARD const_reference operator[](size_type n) const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mStart[difference_type(n)];
+	}
+
+	NODISCARD reference at(size_type n)
+	{
+		rangeCheck(n);
+		return (*this)[n];
+	}
+
+	NODISCARD const_reference at(size_type n) const
+	{
+		rangeCheck(n);
+		return (*this)[n];
+	}
+
+	NODISCARD reference front() JLIBCXX_NOEXCEPT
+	{
+		return *begin();
+	}
+
+	NODISCARD const_reference front() const JLIBCXX_NOEXCEPT
+	{
+		return *begin();
+	}
+
+	NODISCARD reference back() JLIBCXX_NOEXCEPT
+	{
+		return *(end() - 1);
+	}
+
+	NODISCARD const_reference back() const JLIBCXX_NOEXCEPT
+	{
+		return *(end() - 1);
+	}
+
+	template <typename... Args>
+	reference emplace_back(Args&&... args)
+	{
+		// Null iterators give 0 here, a Deque without a map takes the slow path.
+		if (mImpl.mFinish.mLast - mImpl.mFinish.mCur > 1)
+		{
+			Alloc_Traits::construct(getTAllocator(), mImpl.mFinish.mCur, STD forward<Args>(args)...);
+			++mImpl.mFinish.mCur;
+		}
+		else
+		{
+			pushBackAux(STD forward<Args>(args)...);
+		}
+
+		return back();
+	}
+
+	template <typename... Args>
+	reference emplace_front(Args&&... args)
+	{
+		if (mImpl.mStart.mCur != mImpl.mStart.mFirst)
+		{
+			Alloc_Traits::construct(getTAllocator(), mImpl.mStart.mCur - 1, STD forward<Args>(args)...);
+			--mImpl.mStart.mCur;
+		}
+		else
+		{
+			pushFrontAux(STD forward<Args>(args)...);
+		}
+
+		return front();
+	}
+
+	void push_back(const value_type& value)
+	{
+		emplace_back(value);
+	}
+
+	void push_back(value_type&& value)
+	{
+		emplace_back(STD move(value));
+	}
+
+	void push_front(const value_type& value)
+	{
+		emplace_front(value);
+	}
+
+	void push_front(value_type&& value)
+	{
+		emplace_front(STD move(value));
+	}
+
+	void pop_back() JLIBCXX_NOEXCEPT
+	{
+		if (mImpl.mFinish.mCur != mImpl.mFinish.mFirst)
+		{
+			--mImpl.mFinish.mCur;
+			Alloc_Traits::destroy(getTAllocator(), mImpl.mFinish.mCur);
+			return;
+		}
+
+		deallocateBlock(mImpl.mFinish.mFirst);
+		mImpl.mFinish.setNode(mImpl.mFinish.mNode - 1);
+		mImpl.mFinish.mCur = mImpl.mFinish.mLast - 1;
+		Alloc_Traits::destroy(getTAllocator(), mImpl.mFinish.mCur);
+	}
+
+	void pop_front() JLIBCXX_NOEXCEPT
+	{
+		Alloc_Traits::destroy(getTAllocator(), mImpl.mStart.mCur);
+		if (mImpl.mStart.mCur != mImpl.mStart.mLast - 1)
+		{
+			++mImpl.mStart.mCur;
+			return;
+		}
+
+		deallocateBlock(mImpl.mStart.mFirst);
+		mImpl.mStart.setNode(mImpl.mStart.mNode + 1);
+		mImpl.mStart.mCur = mImpl.mStart.mFirst;
+	}
+
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args)
+	{
+		if (pos == cbegin())
+		{
+			emplace_front(STD forward<Args>(args)...);
+			return begin();
+		}
+
+		if (pos == cend())
+		{
+			emplace_back(STD forward<Args>(args)...);
+			return end() - 1;
+		}
+
+		return insertAux(pos.constCast(), STD forward<Args>(args)...);
+	}
+
+	iterator insert(const_iterator pos, const value_type& value)
+	{
+		return emplace(pos, value);
+	}
+
+	iterator insert(const_iterator pos, value_type&& value)
+	{
+		return emplace(pos, STD move(value));
+	}
+
+	iterator insert(const_iterator pos, size_type n, const value_type& value)
+	{
+		return insertFill(pos, n, value);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+	{
+		return insertRange(pos, first, last, iterator_category_t<InputIterator>{});
+	}
+
+	iterator insert(const_iterator pos, STD initializer_list<value_type> ilist)
+	{
+		return insertCounted(pos, ilist.begin(), ilist.size());
+	}
+
+	iterator erase(const_iterator position)
+	{
+		const iterator pos = position.constCast();
+		const iterator next = pos + 1;
+		const difference_type index = pos - mImpl.mStart;
+
+		if (size_type(index) < size() / 2)
+		{
+			STD move_backward(mImpl.mStart, pos, next);
+			pop_front();
+		}
+		else
+		{
+			STD move(next, mImpl.mFinish, pos);
+			pop_back();
+		}
+
+		return mImpl.mStart + index;
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		if (first == last)
+		{
+			return last.constCast();
+		}
+
+		if (first == cbegin() && last == cend())
+		{
+			clear();
+			return end();
+		}
+
+		const difference_type n = last - first;
+		const difference_type elementsBefore = first - cbegin();
+		if (size_type(elementsBefore) < (size() - n) / 2)
+		{
+			STD move_backward(mImpl.mStart, first.constCast(), last.constCast());
+			eraseAtBegin(mImpl.mStart + n);
+		}
+		else
+		{
+			STD move(last.constCast(), mImpl.mFinish, first.constCast());
+			eraseAtEnd(mImpl.mFinish - n);
+		}
+
+		return mImpl.mStart + elementsBefore;
+	}
+
+	// Keeps the map and one block.
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		eraseAtEnd(mImpl.mStart);
+	}
+
+	void swap(Deque& other) JLIBCXX_NOEXCEPT
+	{
+		this->swapStorage(other);
+		Alloc_Traits::doSwap(getTAllocator(), other.getTAllocator());
+	}
+};
+
+template <typename T, typename Alloc>
+inline bool operator==(const Deque<T, Alloc>& lhs, const Deque<T, Alloc>& rhs)
+{
+	return lhs.size() == rhs.size() && STD equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Alloc>
+inline bool operator!=(const Deque<T, Alloc>& lhs, const Deque<T, Alloc>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc>
+inline bool operator<(const Deque<T, Alloc>& lhs, const Deque<T, Alloc>& rhs)
+{
+	return STD lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Alloc>
+inline void swap(Deque<T, Alloc>& lhs, Deque<T, Alloc>& rhs) JLIBCXX_NOEXCEPT
+{
+	lhs.swap(rhs);
+}
+
+template<typename InputIterator, typename T
+	= typename STD iterator_traits<InputIterator>::value_type,
+	typename Allocator = STD allocator<T>,
+	typename = RequireInputIter<InputIterator>,
+	typename = RequireAllocator<Allocator>>
+	Deque(InputIterator, InputIterator, Allocator = Allocator())
+->Deque<T, Allocator>;
+
+JSTD_END
+
+#endif // !DEQUE
@@ -0,0 +1,1613 @@
+#pragma once
+#ifndef FLAT_HASH_MAP
+#define FLAT_HASH_MAP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSTD_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+
+JSTD_START
+
+/*
+* One control byte per slot. A full slot stores the low 7 bits of its hash (0 to 127), the
+* other states are negative, so "is it full" is a sign test and a group can be scanned for
+* a hash, for empties, or for empty-or-deleted with a single compare each.
+*/
+using FlatHashCtrl = signed char;
+
+inline constexpr FlatHashCtrl flatHashEmpty = -128;
+inline constexpr FlatHashCtrl flatHashDeleted = -2;
+inline constexpr FlatHashCtrl flatHashSentinel = -1;
+
+// Bits set for the matching bytes of a group. Each byte takes 1 << Shift bits.
+template <typename T, int Shift>
+class FlatHashBitMask
+{
+public:
+
+	explicit FlatHashBitMask(T mask) JLIBCXX_NOEXCEPT
+		: mMask(mask)
+	{ }
+
+	explicit operator bool() const JLIBCXX_NOEXCEPT
+	{
+		return mMask != 0;
+	}
+
+	STD size_t lowestBitSet() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<STD size_t>(STD countr_zero(mMask)) >> Shift;
+	}
+
+	STD size_t trailingZeros() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<STD size_t>(STD countr_zero(mMask)) >> Shift;
+	}
+
+	STD size_t leadingZeros(const STD size_t width) const JLIBCXX_NOEXCEPT
+	{
+		constexpr int extraBits = static_cast<int>(sizeof(T) * 8) - (Shift == 0 ? 16 : 64);
+		return STD min(static_cast<STD size_t>(STD countl_zero(static_cast<T>(mMask << extraBits))) >> Shift, width);
+	}
+
+	// Walk the set bytes from the lowest.
+	FlatHashBitMask begin() const JLIBCXX_NOEXCEPT
+	{
+		return *this;
+	}
+
+	FlatHashBitMask end() const JLIBCXX_NOEXCEPT
+	{
+		return FlatHashBitMask(0);
+	}
+
+	STD size_t operator*() const JLIBCXX_NOEXCEPT
+	{
+		return lowestBitSet();
+	}
+
+	FlatHashBitMask& operator++() JLIBCXX_NOEXCEPT
+	{
+		mMask &= mMask - 1;
+		return *this;
+	}
+
+	friend bool operator!=(const FlatHashBitMask& left, const FlatHashBitMask& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mMask != right.mMask;
+	}
+
+private:
+
+	T mMask;
+};
+
+#ifdef JSTD_FLAT_HASH_SSE2
+
+// Sixteen control bytes compared at once with SSE2.
+class FlatHashGroup
+{
+public:
+
+	static constexpr STD size_t width = 16;
+
+	using BitMask = FlatHashBitMask<STD uint32_t, 0>;
+
+	explicit FlatHashGroup(const FlatHashCtrl* pos) JLIBCXX_NOEXCEPT
+		: mCtrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+	{ }
+
+	BitMask match(const FlatHashCtrl hash) const JLIBCXX_NOEXCEPT
+	{
+		return BitMask(static_cast<STD uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), mCtrl))));
+	}
+
+	BitMask matchEmpty() const JLIBCXX_NOEXCEPT
+	{
+		return match(flatHashEmpty);
+	}
+
+	BitMask matchEmptyOrDeleted() const JLIBCXX_NOEXCEPT
+	{
+		return BitMask(static_cast<STD uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flatHashSentinel), mCtrl))));
+	}
+
+	STD size_t countLeadingEmptyOrDeleted() const JLIBCXX_NOEXCEPT
+	{
+		const auto mask = static_cast<STD uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flatHashSentinel), mCtrl)));
+		return static_cast<STD size_t>(STD countr_zero(mask + 1));
+	}
+
+private:
+
+	__m128i mCtrl;
+};
+
+#else
+
+// Eight control bytes compared at once in a 64-bit word. Assumes little endian.
+class FlatHashGroup
+{
+public:
+
+	static constexpr STD size_t width = 8;
+
+	using BitMask = FlatHashBitMask<STD uint64_t, 3>;
+
+	explicit FlatHashGroup(const FlatHashCtrl* pos) JLIBCXX_NOEXCEPT
+	{
+		STD memcpy(&mCtrl, pos, sizeof(mCtrl));
+	}
+
+	// May report a byte that differs by the high bit only. Callers compare the keys anyway.
+	BitMask match(const FlatHashCtrl hash) const JLIBCXX_NOEXCEPT
+	{
+		const STD uint64_t x = mCtrl ^ (lsbs * static_cast<unsigned char>(hash));
+		return BitMask((x - lsbs) & ~x & msbs);
+	}
+
+	BitMask matchEmpty() const JLIBCXX_NOEXCEPT
+	{
+		return BitMask((mCtrl & (~mCtrl << 6)) & msbs);
+	}
+
+	BitMask matchEmptyOrDeleted() const JLIBCXX_NOEXCEPT
+	{
+		return BitMask((mCtrl & (~mCtrl << 7)) & msbs);
+	}
+
+	STD size_t countLeadingEmptyOrDeleted() const JLIBCXX_NOEXCEPT
+	{
+		constexpr STD uint64_t gaps = 0x00FEFEFEFEFEFEFEULL;
+		return static_cast<STD size_t>(STD countr_zero(((~mCtrl & (mCtrl >> 7)) | gaps) + 1)) >> 3;
+	}
+
+private:
+
+	static constexpr STD uint64_t lsbs = 0x0101010101010101ULL;
+	static constexpr STD uint64_t msbs = 0x8080808080808080ULL;
+
+	STD uint64_t mCtrl;
+};
+
+#endif // JSTD_FLAT_HASH_SSE2
+
+// What an empty table points at, so lookups on it need no special case.
+alignas(16) inline constexpr FlatHashCtrl flatHashEmptyGroup[16] = {
+	flatHashSentinel, flatHashEmpty, flatHashEmpty, flatHashEmpty,
+	flatHashEmpty, flatHashEmpty, flatHashEmpty, flatHashEmpty,
+	flatHashEmpty, flatHashEmpty, flatHashEmpty, flatHashEmpty,
+	flatHashEmpty, flatHashEmpty, flatHashEmpty, flatHashEmpty
+};
+
+template <typename Value, bool Const>
+class FlatHashIterator
+{
+private:
+
+	using SlotPtr = STD conditional_t<Const, const Value*, Value*>;
+
+public:
+
+	using iterator_category = STD forward_iterator_tag;
+	using value_type = Value;
+	using difference_type = STD ptrdiff_t;
+	using reference = STD conditional_t<Const, const Value&, Value&>;
+	using pointer = SlotPtr;
+
+	FlatHashIterator() JLIBCXX_NOEXCEPT
+		: mCtrl(nullptr), mSlot(nullptr)
+	{ }
+
+	FlatHashIterator(const FlatHashCtrl* ctrl, SlotPtr slot) JLIBCXX_NOEXCEPT
+		: mCtrl(ctrl), mSlot(slot)
+	{ }
+
+	template <bool OtherConst, typename = STD enable_if_t<Const && !OtherConst>>
+	FlatHashIterator(const FlatHashIterator<Value, OtherConst>& other) JLIBCXX_NOEXCEPT
+		: mCtrl(other.mCtrl), mSlot(other.mSlot)
+	{ }
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return *mSlot;
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return mSlot;
+	}
+
+	FlatHashIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		++mCtrl;
+		++mSlot;
+		skipEmptyOrDeleted();
+		return *this;
+	}
+
+	FlatHashIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		FlatHashIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	friend bool operator==(const FlatHashIterator& left, const FlatHashIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mCtrl == right.mCtrl;
+	}
+
+	friend bool operator!=(const FlatHashIterator& left, const FlatHashIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mCtrl != right.mCtrl;
+	}
+
+	// The sentinel after the last slot stops the walk.
+	void skipEmptyOrDeleted() JLIBCXX_NOEXCEPT
+	{
+		while (*mCtrl < flatHashSentinel)
+		{
+			const STD size_t shift = FlatHashGroup(mCtrl).countLeadingEmptyOrDeleted();
+			mCtrl += shift;
+			mSlot += shift;
+		}
+	}
+
+	const FlatHashCtrl* mCtrl;
+
+	SlotPtr mSlot;
+};
+
+/*
+* Open addressing hash table in the Swiss table layout: a control byte array, cloned at the
+* end so a group can be loaded at any slot, followed by the slots in the same allocation.
+*
+* A lookup hashes once, then probes groups quadratically; inside a group the 7-bit hash
+* tags of all slots are compared in one instruction, so the keys of other elements are
+* almost never touched. The load factor is at most 7/8.
+*
+* Erase leaves a tombstone only when the slot sat in a window that was full, the one case
+* where a probe might have passed through it; otherwise the slot goes back to empty.
+*
+* Any insert may rehash and invalidate every iterator and reference.
+*/
+template <typename Key, typename Value, typename KeyOfValue, typename Hash, typename KeyEqual, typename Alloc>
+class FlatHashTable
+{
+protected:
+
+	using Value_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Value>::other;
+	using Value_Alloc_Traits = MyAlloctTraits<Value_Alloc_Type>;
+
+	// The allocation unit, aligned for the slots that follow the control bytes.
+	struct alignas(Value) Unit
+	{
+		unsigned char mBytes[alignof(Value)];
+	};
+
+	using Unit_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Unit>::other;
+	using Unit_Alloc_Traits = MyAlloctTraits<Unit_Alloc_Type>;
+
+	static constexpr STD size_t groupWidth = FlatHashGroup::width;
+	static constexpr STD size_t clonedBytes = groupWidth - 1;
+
+	template <typename K, typename H = Hash, typename E = KeyEqual>
+	using RequireTransparent = STD enable_if_t<IsTransparent<H>::value && IsTransparent<E>::value, K>;
+
+	struct FlatHashHeader
+	{
+		FlatHashCtrl* mCtrl = const_cast<FlatHashCtrl*>(flatHashEmptyGroup);
+		Value* mSlots = nullptr;
+		STD size_t mSize = 0;
+		STD size_t mCapacity = 0;
+		STD size_t mGrowthLeft = 0;
+	};
+
+	// Visits groups at offsets h, h + w, h + 3w, h + 6w, ..., which covers every group once.
+	class ProbeSequence
+	{
+	public:
+
+		ProbeSequence(STD size_t hash, STD size_t mask) JLIBCXX_NOEXCEPT
+			: mMask(mask), mOffset(hash & mask), mIndex(0)
+		{ }
+
+		STD size_t offset() const JLIBCXX_NOEXCEPT
+		{
+			return mOffset;
+		}
+
+		STD size_t offset(STD size_t i) const JLIBCXX_NOEXCEPT
+		{
+			return (mOffset + i) & mMask;
+		}
+
+		void next() JLIBCXX_NOEXCEPT
+		{
+			mIndex += groupWidth;
+			mOffset = (mOffset + mIndex) & mMask;
+		}
+
+	private:
+
+		STD size_t mMask;
+		STD size_t mOffset;
+		STD size_t mIndex;
+	};
+
+public:
+
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Alloc;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+
+	using iterator = FlatHashIterator<Value, false>;
+	using const_iterator = FlatHashIterator<Value, true>;
+
+protected:
+
+	// The empty base optimization for the allocator, the hasher and the key equality.
+	struct FlatHashImpl : public Value_Alloc_Type
+	{
+		CompressedPair<Hash, CompressedPair<KeyEqual, FlatHashHeader>> mData;
+
+		FlatHashImpl() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<Value_Alloc_Type>
+			&& STD is_nothrow_default_constructible_v<Hash> && STD is_nothrow_default_constructible_v<KeyEqual>)
+			: Value_Alloc_Type(), mData(ZeroThenVariadicArgsT{}, ZeroThenVariadicArgsT{})
+		{ }
+
+		FlatHashImpl(const Hash& hash, const KeyEqual& equal, const Value_Alloc_Type& alloc)
+			: Value_Alloc_Type(alloc), mData(OneThenVariadicArgsT{}, hash, OneThenVariadicArgsT{}, equal)
+		{ }
+	};
+
+	FlatHashImpl mImpl;
+
+	Value_Alloc_Type& getValueAllocator() JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	const Value_Alloc_Type& getValueAllocator() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl;
+	}
+
+	FlatHashHeader& header() JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second.second;
+	}
+
+	const FlatHashHeader& header() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second.second;
+	}
+
+	const Hash& hashFunction() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.first();
+	}
+
+	const KeyEqual& keyEqual() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mData.second.first();
+	}
+
+	// Smallest 2^k - 1 not below n.
+	static STD size_t normalizeCapacity(STD size_t n) JLIBCXX_NOEXCEPT
+	{
+		return n ? ~STD size_t() >> STD countl_zero(n) : 1;
+	}
+
+	static STD size_t capacityToGrowth(STD size_t capacity) JLIBCXX_NOEXCEPT
+	{
+		if (groupWidth == 8 && capacity == 7)
+		{
+			return 6;
+		}
+
+		return capacity - capacity / 8;
+	}
+
+	static STD size_t growthToLowerboundCapacity(STD size_t growth) JLIBCXX_NOEXCEPT
+	{
+		if (groupWidth == 8 && growth == 7)
+		{
+			return 8;
+		}
+
+		return growth + static_cast<STD size_t>((static_cast<STD int64_t>(growth) - 1) / 7);
+	}
+
+	static STD size_t slotOffset(STD size_t capacity) JLIBCXX_NOEXCEPT
+	{
+		const STD size_t ctrlBytes = capacity + 1 + clonedBytes;
+		return (ctrlBytes + alignof(Value) - 1) & ~(alignof(Value) - 1);
+	}
+
+	static STD size_t allocationUnits(STD size_t capacity) JLIBCXX_NOEXCEPT
+	{
+		return (slotOffset(capacity) + capacity * sizeof(Value) + sizeof(Unit) - 1) / sizeof(Unit);
+	}
+
+	// Standard hashes of integers are the identity, so mix the bits before splitting them.
+	template <typename K>
+	STD size_t hashOf(const K& key) const
+	{
+		STD size_t hash = static_cast<STD size_t>(hashFunction()(key));
+		if constexpr (sizeof(STD size_t) == 8)
+		{
+			hash ^= hash >> 33;
+			hash *= 0xFF51AFD7ED558CCDULL;
+			hash ^= hash >> 33;
+		}
+		else
+		{
+			hash ^= hash >> 16;
+			hash *= 0x85EBCA6BU;
+			hash ^= hash >> 13;
+		}
+
+		return hash;
+	}
+
+	// The probe start also depends on the table address, so copying one table into another in
+	// iteration order does not cluster.
+	STD size_t probeStart(STD size_t hash) const JLIBCXX_NOEXCEPT
+	{
+		return (hash >> 7) ^ (reinterpret_cast<STD uintptr_t>(header().mCtrl) >> 12);
+	}
+
+	static FlatHashCtrl hashTag(STD size_t hash) JLIBCXX_NOEXCEPT
+	{
+		return static_cast<FlatHashCtrl>(hash & 0x7F);
+	}
+
+	static const Key& keyOf(const Value& value) JLIBCXX_NOEXCEPT
+	{
+		return KeyOfValue()(value);
+	}
+
+	// Writes the byte and its clone, so groups loaded near the end see the table's start.
+	void setCtrl(STD size_t index, FlatHashCtrl value) JLIBCXX_NOEXCEPT
+	{
+		const STD size_t capacity = header().mCapacity;
+		header().mCtrl[index] = value;
+		header().mCtrl[((index - clonedBytes) & capacity) + (clonedBytes & capacity)] = value;
+	}
+
+	void resetCtrl() JLIBCXX_NOEXCEPT
+	{
+		const STD size_t capacity = header().mCapacity;
+		STD memset(header().mCtrl, flatHashEmpty, capacity + 1 + clonedBytes);
+		header().mCtrl[capacity] = flatHashSentinel;
+		header().mGrowthLeft = capacityToGrowth(capacity) - header().mSize;
+	}
+
+	template <typename... Args>
+	void constructSlot(Value* slot, Args&&... args)
+	{
+		Value_Alloc_Traits::construct(getValueAllocator(), slot, STD forward<Args>(args)...);
+	}
+
+	void destroySlot(Value* slot) JLIBCXX_NOEXCEPT
+	{
+		Value_Alloc_Traits::destroy(getValueAllocator(), slot);
+	}
+
+	/*
+	* Move a slot's value to new storage and end the old one. The key of a map is const, but
+	* the element is about to be destroyed, so moving it is safe in the same way a node
+	* handle's key() is.
+	*/
+	void relocateSlot(Value* from, Value* to) JLIBCXX_NOEXCEPT
+	{
+		if constexpr (is_bitwise_relocatable_v<Value, Value_Alloc_Type>)
+		{
+			STD memcpy(static_cast<void*>(to), static_cast<const void*>(from), sizeof(Value));
+		}
+		else
+		{
+			constructSlot(to, STD move(*const_cast<STD remove_const_t<Value>*>(from)));
+			destroySlot(from);
+		}
+	}
+
+	// First empty or deleted slot on the probe sequence of hash.
+	STD size_t findFirstNonFull(STD size_t hash) const JLIBCXX_NOEXCEPT
+	{
+		ProbeSequence seq(probeStart(hash), header().mCapacity);
+		while (true)
+		{
+			const FlatHashGroup group(header().mCtrl + seq.offset());
+			const auto mask = group.matchEmptyOrDeleted();
+			if (mask)
+			{
+				return seq.offset(mask.lowestBitSet());
+			}
+
+			seq.next();
+		}
+	}
+
+	// Index of the element equal to key, or the capacity if there is none.
+	template <typename K>
+	STD size_t findIndex(const K& key, STD size_t hash) const
+	{
+		const FlatHashHeader& head = header();
+		ProbeSequence seq(probeStart(hash), head.mCapacity);
+		const FlatHashCtrl tag = hashTag(hash);
+		while (true)
+		{
+			const FlatHashGroup group(head.mCtrl + seq.offset());
+			for (const STD size_t i : group.match(tag))
+			{
+				const STD size_t index = seq.offset(i);
+				if (keyEqual()(keyOf(head.mSlots[index]), key))
+				{
+					return index;
+				}
+			}
+
+			if (group.matchEmpty())
+			{
+				return head.mCapacity;
+			}
+
+			seq.next();
+		}
+	}
+
+	void allocateTable(STD size_t capacity)
+	{
+		Unit_Alloc_Type alloc(getValueAllocator());
+		Unit* memory = Unit_Alloc_Traits::allocate(alloc, allocationUnits(capacity));
+		header().mCtrl = reinterpret_cast<FlatHashCtrl*>(memory);
+		header().mSlots = reinterpret_cast<Value*>(reinterpret_cast<unsigned char*>(memory) + slotOffset(capacity));
+		header().mCapacity = capacity;
+		resetCtrl();
+	}
+
+	void deallocateTable(FlatHashCtrl* ctrl, STD size_t capacity) JLIBCXX_NOEXCEPT
+	{
+		if (capacity)
+		{
+			Unit_Alloc_Type alloc(getValueAllocator());
+			Unit_Alloc_Traits::deallocate(alloc, reinterpret_cast<Unit*>(ctrl), allocationUnits(capacity));
+		}
+	}
+
+	void destroySlots() JLIBCXX_NOEXCEPT
+	{
+		if constexpr (!STD is_trivially_destructible_v<Value> || !is_default_construct_allocator<Value_Alloc_Type>::value)
+		{
+			const FlatHashHeader& head = header();
+			for (STD size_t i = 0; i < head.mCapacity; ++i)
+			{
+				if (head.mCtrl[i] >= 0)
+				{
+					destroySlot(head.mSlots + i);
+				}
+			}
+		}
+	}
+
+	void destroyAll() JLIBCXX_NOEXCEPT
+	{
+		destroySlots();
+		deallocateTable(header().mCtrl, header().mCapacity);
+		header() = FlatHashHeader();
+	}
+
+	// Move every element into a new table of capacity slots. Hashing may throw; nothing moves before it.
+	void resize(STD size_t capacity)
+	{
+		const FlatHashHeader old = header();
+		const STD size_t size = old.mSize;
+
+		header().mSize = 0;
+		TRY_START
+		allocateTable(capacity);
+		CATCH_ALL
+		header() = old;
+		THROW_AGAIN
+		END_CATCH
+
+		header().mSize = size;
+		header().mGrowthLeft -= size;
+		if (size == 0)
+		{
+			deallocateTable(old.mCtrl, old.mCapacity);
+			return;
+		}
+
+		// A hasher that may throw runs over every key once before anything moves, so a throw
+		// leaves the old table intact.
+		if constexpr (!STD is_nothrow_invocable_v<const Hash&, const Key&>)
+		{
+			TRY_START
+			for (STD size_t i = 0; i < old.mCapacity; ++i)
+			{
+				if (old.mCtrl[i] >= 0)
+				{
+					static_cast<void>(hashOf(keyOf(old.mSlots[i])));
+				}
+			}
+			CATCH_ALL
+			deallocateTable(header().mCtrl, header().mCapacity);
+			header() = old;
+			THROW_AGAIN
+			END_CATCH
+		}
+
+		for (STD size_t i = 0; i < old.mCapacity; ++i)
+		{
+			if (old.mCtrl[i] >= 0)
+			{
+				const STD size_t hash = hashOf(keyOf(old.mSlots[i]));
+				const STD size_t target = findFirstNonFull(hash);
+				setCtrl(target, hashTag(hash));
+				relocateSlot(old.mSlots + i, header().mSlots + target);
+			}
+		}
+
+		deallocateTable(old.mCtrl, old.mCapacity);
+	}
+
+	// Out of room: squeeze tombstones out if they take enough space, otherwise double.
+	void rehashAndGrowIfNecessary()
+	{
+		const STD size_t capacity = header().mCapacity;
+		if (capacity > groupWidth && header().mSize * 32 <= capacity * 25)
+		{
+			resize(capacity);
+			return;
+		}
+
+		resize(capacity * 2 + 1);
+	}
+
+	// Claim a slot for a new element with this hash. Its control byte is already set.
+	STD size_t prepareInsert(STD size_t hash)
+	{
+		STD size_t target = findFirstNonFull(hash);
+		if (header().mGrowthLeft == 0 && header().mCtrl[target] != flatHashDeleted)
+		{
+			rehashAndGrowIfNecessary();
+			target = findFirstNonFull(hash);
+		}
+
+		++header().mSize;
+		header().mGrowthLeft -= header().mCtrl[target] == flatHashEmpty;
+		setCtrl(target, hashTag(hash));
+		return target;
+	}
+
+	/*
+	* A slot can go back to empty if the windows before and after it had an empty between them,
+	* since then no probe ever found this group full and moved past it.
+	*/
+	void eraseMetaOnly(STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		--header().mSize;
+		const STD size_t before = (index - groupWidth) & header().mCapacity;
+		const auto emptyAfter = FlatHashGroup(header().mCtrl + index).matchEmpty();
+		const auto emptyBefore = FlatHashGroup(header().mCtrl + before).matchEmpty();
+		const bool wasNeverFull = emptyBefore && emptyAfter
+			&& emptyAfter.trailingZeros() + emptyBefore.leadingZeros(groupWidth) < groupWidth;
+
+		setCtrl(index, wasNeverFull ? flatHashEmpty : flatHashDeleted);
+		header().mGrowthLeft += wasNeverFull;
+	}
+
+	template <typename... Args>
+	void constructAt(STD size_t index, Args&&... args)
+	{
+		TRY_START
+		constructSlot(header().mSlots + index, STD forward<Args>(args)...);
+		CATCH_ALL
+		eraseMetaOnly(index);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	// { index, true } for a fresh slot the caller must construct, { index, false } if key exists.
+	template <typename K>
+	STD pair<STD size_t, bool> findOrPrepareInsert(const K& key)
+	{
+		const STD size_t hash = hashOf(key);
+		const STD size_t index = findIndex(key, hash);
+		if (index != header().mCapacity)
+		{
+			return { index, false };
+		}
+
+		return { prepareInsert(hash), true };
+	}
+
+	iterator iteratorAt(STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		return iterator(header().mCtrl + index, header().mSlots + index);
+	}
+
+	const_iterator iteratorAt(STD size_t index) const JLIBCXX_NOEXCEPT
+	{
+		return const_iterator(header().mCtrl + index, header().mSlots + index);
+	}
+
+	template <typename Arg>
+	STD pair<iterator, bool> insertUnique(Arg&& value)
+	{
+		const auto pos = findOrPrepareInsert(keyOf(value));
+		if (pos.second)
+		{
+			constructAt(pos.first, STD forward<Arg>(value));
+		}
+
+		return { iteratorAt(pos.first), pos.second };
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplaceUnique(Args&&... args)
+	{
+		if constexpr (sizeof...(Args) == 1 && (STD is_same_v<STD remove_cvref_t<Args>, Value> && ...))
+		{
+			return insertUnique(STD forward<Args>(args)...);
+		}
+		else
+		{
+			Value value(STD forward<Args>(args)...);
+			return insertUnique(STD move(value));
+		}
+	}
+
+	// Only builds the value if key is missing. For FlatHashMap::try_emplace and operator[].
+	template <typename K, typename... Args>
+	STD pair<iterator, bool> tryEmplace(K&& key, Args&&... args)
+	{
+		const auto pos = findOrPrepareInsert(key);
+		if (pos.second)
+		{
+			constructAt(pos.first, STD piecewise_construct,
+				STD forward_as_tuple(STD forward<K>(key)), STD forward_as_tuple(STD forward<Args>(args)...));
+		}
+
+		return { iteratorAt(pos.first), pos.second };
+	}
+
+	template <typename InputIterator>
+	void insertRange(InputIterator first, InputIterator last)
+	{
+		if constexpr (STD is_base_of_v<STD forward_iterator_tag, iterator_category_t<InputIterator>>)
+		{
+			reserve(size() + static_cast<STD size_t>(STD distance(first, last)));
+		}
+
+		for (; first != last; ++first)
+		{
+			emplaceUnique(*first);
+		}
+	}
+
+	// Elements of other are known to be unique, so no key is compared.
+	template <bool MoveValues, typename Table>
+	void copyFrom(Table& other)
+	{
+		reserve(other.size());
+		for (auto it = other.begin(); it != other.end(); ++it)
+		{
+			const STD size_t hash = hashOf(keyOf(*it));
+			const STD size_t index = prepareInsert(hash);
+			if constexpr (MoveValues)
+			{
+				constructAt(index, STD move(const_cast<Value&>(*it)));
+			}
+			else
+			{
+				constructAt(index, *it);
+			}
+		}
+	}
+
+	template <typename K>
+	size_type eraseKey(const K& key)
+	{
+		const STD size_t index = findIndex(key, hashOf(key));
+		if (index == header().mCapacity)
+		{
+			return 0;
+		}
+
+		destroySlot(header().mSlots + index);
+		eraseMetaOnly(index);
+		return 1;
+	}
+
+public:
+
+	FlatHashTable() = default;
+
+	explicit FlatHashTable(STD size_t bucketCount, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+		const allocator_type& alloc = allocator_type())
+		: mImpl(hash, equal, Value_Alloc_Type(alloc))
+	{
+		reserve(bucketCount);
+	}
+
+	FlatHashTable(const FlatHashTable& other)
+		: mImpl(other.hashFunction(), other.keyEqual(),
+			Value_Alloc_Traits::select_on_container_copy_construction(other.getValueAllocator()))
+	{
+		TRY_START
+		copyFrom<false>(other);
+		CATCH_ALL
+		destroyAll();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	FlatHashTable(const FlatHashTable& other, const allocator_type& alloc)
+		: mImpl(other.hashFunction(), other.keyEqual(), Value_Alloc_Type(alloc))
+	{
+		TRY_START
+		copyFrom<false>(other);
+		CATCH_ALL
+		destroyAll();
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	FlatHashTable(FlatHashTable&& other) JLIBCXX_NOEXCEPT
+		: mImpl(other.hashFunction(), other.keyEqual(), STD move(other.getValueAllocator()))
+	{
+		header() = other.header();
+		other.header() = FlatHashHeader();
+	}
+
+	FlatHashTable(FlatHashTable&& other, const allocator_type& alloc)
+		: mImpl(other.hashFunction(), other.keyEqual(), Value_Alloc_Type(alloc))
+	{
+		if (Value_Alloc_Traits::always_equal_v() || getValueAllocator() == other.getValueAllocator())
+		{
+			header() = other.header();
+			other.header() = FlatHashHeader();
+			return;
+		}
+
+		TRY_START
+		copyFrom<true>(other);
+		CATCH_ALL
+		destroyAll();
+		THROW_AGAIN
+		END_CATCH
+
+		other.clear();
+	}
+
+	~FlatHashTable() JLIBCXX_NOEXCEPT
+	{
+		destroyAll();
+	}
+
+	FlatHashTable& operator=(const FlatHashTable& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		destroyAll();
+		if constexpr (Value_Alloc_Traits::propagate_on_container_copy_assignment_v())
+		{
+			Value_Alloc_Traits::doCopy(getValueAllocator(), other.getValueAllocator());
+		}
+
+		mImpl.mData.first() = other.hashFunction();
+		mImpl.mData.second.first() = other.keyEqual();
+		copyFrom<false>(other);
+		return *this;
+	}
+
+	FlatHashTable& operator=(FlatHashTable&& other) JLIBCXX_NOEXCEPT_IF(Value_Alloc_Traits::nothrow_move()
+		&& STD is_nothrow_move_assignable_v<Hash> && STD is_nothrow_move_assignable_v<KeyEqual>)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		destroyAll();
+		mImpl.mData.first() = STD move(other.mImpl.mData.first());
+		mImpl.mData.second.first() = STD move(other.mImpl.mData.second.first());
+
+		if constexpr (!Value_Alloc_Traits::nothrow_move())
+		{
+			if (getValueAllocator() != other.getValueAllocator())
+			{
+				copyFrom<true>(other);
+				other.clear();
+				return *this;
+			}
+		}
+
+		header() = other.header();
+		other.header() = FlatHashHeader();
+		Value_Alloc_Traits::doMove(getValueAllocator(), other.getValueAllocator());
+		return *this;
+	}
+
+	NODISCARD allocator_type get_allocator() const JLIBCXX_NOEXCEPT
+	{
+		return allocator_type(getValueAllocator());
+	}
+
+	NODISCARD hasher hash_function() const
+	{
+		return hashFunction();
+	}
+
+	NODISCARD key_equal key_eq() const
+	{
+		return keyEqual();
+	}
+
+	NODISCARD iterator begin() JLIBCXX_NOEXCEPT
+	{
+		iterator it(header().mCtrl, header().mSlots);
+		it.skipEmptyOrDeleted();
+		return it;
+	}
+
+	NODISCARD const_iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		const_iterator it(header().mCtrl, header().mSlots);
+		it.skipEmptyOrDeleted();
+		return it;
+	}
+
+	NODISCARD iterator end() JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(header().mCapacity);
+	}
+
+	NODISCARD const_iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(header().mCapacity);
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return header().mSize == 0;
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return header().mSize;
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD numeric_limits<size_type>::max() / (sizeof(Value) + 1) / 2;
+	}
+
+	NODISCARD size_type capacity() const JLIBCXX_NOEXCEPT
+	{
+		return header().mCapacity;
+	}
+
+	NODISCARD float load_factor() const JLIBCXX_NOEXCEPT
+	{
+		return header().mCapacity ? static_cast<float>(header().mSize) / static_cast<float>(header().mCapacity) : 0.0f;
+	}
+
+	NODISCARD float max_load_factor() const JLIBCXX_NOEXCEPT
+	{
+		return 7.0f / 8.0f;
+	}
+
+	// Keeps the table; only the elements and tombstones go.
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		destroySlots();
+		header().mSize = 0;
+		if (header().mCapacity)
+		{
+			resetCtrl();
+		}
+	}
+
+	// Make room for count elements without another rehash.
+	void reserve(STD size_t count)
+	{
+		if (count > size() + header().mGrowthLeft)
+		{
+			resize(normalizeCapacity(growthToLowerboundCapacity(count)));
+		}
+	}
+
+	// rehash(0) shrinks the table to fit, down to no allocation at all when empty.
+	void rehash(STD size_t count)
+	{
+		if (count == 0 && header().mCapacity == 0)
+		{
+			return;
+		}
+
+		if (count == 0 && size() == 0)
+		{
+			destroyAll();
+			return;
+		}
+
+		const STD size_t capacity = normalizeCapacity(STD max(count, growthToLowerboundCapacity(size())));
+		if (count == 0 || capacity > header().mCapacity)
+		{
+			resize(capacity);
+		}
+	}
+
+	void swap(FlatHashTable& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_swappable_v<Hash> && STD is_nothrow_swappable_v<KeyEqual>)
+	{
+		using STD swap;
+		swap(header(), other.header());
+		swap(mImpl.mData.first(), other.mImpl.mData.first());
+		swap(mImpl.mData.second.first(), other.mImpl.mData.second.first());
+		Value_Alloc_Traits::doSwap(getValueAllocator(), other.getValueAllocator());
+	}
+
+	NODISCARD iterator find(const Key& key)
+	{
+		return iteratorAt(findIndex(key, hashOf(key)));
+	}
+
+	NODISCARD const_iterator find(const Key& key) const
+	{
+		return iteratorAt(findIndex(key, hashOf(key)));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator find(const K& key)
+	{
+		return iteratorAt(findIndex(key, hashOf(key)));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator find(const K& key) const
+	{
+		return iteratorAt(findIndex(key, hashOf(key)));
+	}
+
+	NODISCARD bool contains(const Key& key) const
+	{
+		return findIndex(key, hashOf(key)) != header().mCapacity;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD bool contains(const K& key) const
+	{
+		return findIndex(key, hashOf(key)) != header().mCapacity;
+	}
+
+	NODISCARD size_type count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD size_type count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	iterator erase(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		const STD size_t index = static_cast<STD size_t>(pos.mCtrl - header().mCtrl);
+		destroySlot(header().mSlots + index);
+		eraseMetaOnly(index);
+
+		iterator next = iteratorAt(index + 1);
+		next.skipEmptyOrDeleted();
+		return next;
+	}
+
+	iterator erase(iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return erase(const_iterator(pos));
+	}
+
+	iterator erase(const_iterator first, const_iterator last) JLIBCXX_NOEXCEPT
+	{
+		if (first == cbegin() && last == cend())
+		{
+			clear();
+			return end();
+		}
+
+		while (first != last)
+		{
+			first = erase(first);
+		}
+
+		return iteratorAt(static_cast<STD size_t>(last.mCtrl - header().mCtrl));
+	}
+
+	size_type erase(const Key& key)
+	{
+		return eraseKey(key);
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	size_type erase(const K& key)
+	{
+		return eraseKey(key);
+	}
+
+	// Same elements, whatever the order. Each element of left is looked up in right.
+	friend bool operator==(const FlatHashTable& left, const FlatHashTable& right)
+	{
+		if (left.size() != right.size())
+		{
+			return false;
+		}
+
+		for (const Value& value : left)
+		{
+			const auto it = right.find(keyOf(value));
+			if (it == right.end() || !(*it == value))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	friend bool operator!=(const FlatHashTable& left, const FlatHashTable& right)
+	{
+		return !(left == right);
+	}
+};
+
+/*
+* Unordered map with unique keys, stored inline in a Swiss table. See FlatHashTable.
+*/
+template <typename Key, typename T, typename Hash = STD hash<Key>, typename KeyEqual = STD equal_to<Key>,
+	typename Alloc = STD allocator<STD pair<const Key, T>>>
+class FlatHashMap : private FlatHashTable<Key, STD pair<const Key, T>, SelectFirst, Hash, KeyEqual, Alloc>
+{
+private:
+
+	using Base = FlatHashTable<Key, STD pair<const Key, T>, SelectFirst, Hash, KeyEqual, Alloc>;
+
+public:
+
+	using mapped_type = T;
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::hasher;
+	using typename Base::key_equal;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using typename Base::iterator;
+	using typename Base::const_iterator;
+
+	FlatHashMap() = default;
+
+	explicit FlatHashMap(size_type bucketCount, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+		const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc) { }
+
+	explicit FlatHashMap(const allocator_type& alloc)
+		: Base(0, Hash(), KeyEqual(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatHashMap(InputIterator first, InputIterator last, size_type bucketCount = 0, const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual(), const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc)
+	{
+		this->insertRange(first, last);
+	}
+
+	FlatHashMap(STD initializer_list<value_type> ilist, size_type bucketCount = 0, const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual(), const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc)
+	{
+		this->insertRange(ilist.begin(), ilist.end());
+	}
+
+	FlatHashMap(const FlatHashMap&) = default;
+
+	FlatHashMap(FlatHashMap&&) = default;
+
+	FlatHashMap(const FlatHashMap& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	FlatHashMap(FlatHashMap&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~FlatHashMap() = default;
+
+	FlatHashMap& operator=(const FlatHashMap&) = default;
+
+	FlatHashMap& operator=(FlatHashMap&&) = default;
+
+	FlatHashMap& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRange(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::hash_function;
+	using Base::key_eq;
+	using Base::begin;
+	using Base::end;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::capacity;
+	using Base::load_factor;
+	using Base::max_load_factor;
+	using Base::clear;
+	using Base::reserve;
+	using Base::rehash;
+	using Base::find;
+	using Base::contains;
+	using Base::count;
+	using Base::erase;
+
+	NODISCARD mapped_type& at(const key_type& key)
+	{
+		const iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("FlatHashMap::at: key not found");
+		}
+
+		return pos->second;
+	}
+
+	NODISCARD const mapped_type& at(const key_type& key) const
+	{
+		const const_iterator pos = find(key);
+		if (pos == end())
+		{
+			throw STD out_of_range("FlatHashMap::at: key not found");
+		}
+
+		return pos->second;
+	}
+
+	mapped_type& operator[](const key_type& key)
+	{
+		return this->tryEmplace(key).first->second;
+	}
+
+	mapped_type& operator[](key_type&& key)
+	{
+		return this->tryEmplace(STD move(key)).first->second;
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return this->insertUnique(value);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return this->insertUnique(STD move(value));
+	}
+
+	template <typename P, typename = STD enable_if_t<STD is_constructible_v<value_type, P&&>>>
+	STD pair<iterator, bool> insert(P&& value)
+	{
+		return this->emplaceUnique(STD forward<P>(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRange(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRange(ilist.begin(), ilist.end());
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(const key_type& key, M&& value)
+	{
+		auto result = this->tryEmplace(key, STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first->second = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(key_type&& key, M&& value)
+	{
+		auto result = this->tryEmplace(STD move(key), STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first->second = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		return this->emplaceUnique(STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		return this->tryEmplace(key, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+	{
+		return this->tryEmplace(STD move(key), STD forward<Args>(args)...);
+	}
+
+	void swap(FlatHashMap& other) JLIBCXX_NOEXCEPT_IF(noexcept(STD declval<Base&>().swap(other)))
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const FlatHashMap& left, const FlatHashMap& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const FlatHashMap& left, const FlatHashMap& right)
+	{
+		return !(left == right);
+	}
+
+	friend void swap(FlatHashMap& left, FlatHashMap& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+/*
+* Unordered set, stored inline in a Swiss table. Elements are const, iterator and
+* const_iterator are the same.
+*/
+template <typename Key, typename Hash = STD hash<Key>, typename KeyEqual = STD equal_to<Key>,
+	typename Alloc = STD allocator<Key>>
+class FlatHashSet : private FlatHashTable<Key, Key, Identity, Hash, KeyEqual, Alloc>
+{
+private:
+
+	using Base = FlatHashTable<Key, Key, Identity, Hash, KeyEqual, Alloc>;
+
+public:
+
+	using typename Base::key_type;
+	using typename Base::value_type;
+	using typename Base::size_type;
+	using typename Base::difference_type;
+	using typename Base::hasher;
+	using typename Base::key_equal;
+	using typename Base::allocator_type;
+	using typename Base::reference;
+	using typename Base::const_reference;
+	using typename Base::pointer;
+	using typename Base::const_pointer;
+	using iterator = typename Base::const_iterator;
+	using const_iterator = typename Base::const_iterator;
+
+	FlatHashSet() = default;
+
+	explicit FlatHashSet(size_type bucketCount, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+		const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc) { }
+
+	explicit FlatHashSet(const allocator_type& alloc)
+		: Base(0, Hash(), KeyEqual(), alloc) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatHashSet(InputIterator first, InputIterator last, size_type bucketCount = 0, const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual(), const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc)
+	{
+		this->insertRange(first, last);
+	}
+
+	FlatHashSet(STD initializer_list<value_type> ilist, size_type bucketCount = 0, const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual(), const allocator_type& alloc = allocator_type())
+		: Base(bucketCount, hash, equal, alloc)
+	{
+		this->insertRange(ilist.begin(), ilist.end());
+	}
+
+	FlatHashSet(const FlatHashSet&) = default;
+
+	FlatHashSet(FlatHashSet&&) = default;
+
+	FlatHashSet(const FlatHashSet& other, const allocator_type& alloc)
+		: Base(other, alloc) { }
+
+	FlatHashSet(FlatHashSet&& other, const allocator_type& alloc)
+		: Base(STD move(other), alloc) { }
+
+	~FlatHashSet() = default;
+
+	FlatHashSet& operator=(const FlatHashSet&) = default;
+
+	FlatHashSet& operator=(FlatHashSet&&) = default;
+
+	FlatHashSet& operator=(STD initializer_list<value_type> ilist)
+	{
+		this->clear();
+		this->insertRange(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	using Base::get_allocator;
+	using Base::hash_function;
+	using Base::key_eq;
+	using Base::cbegin;
+	using Base::cend;
+	using Base::empty;
+	using Base::size;
+	using Base::max_size;
+	using Base::capacity;
+	using Base::load_factor;
+	using Base::max_load_factor;
+	using Base::clear;
+	using Base::reserve;
+	using Base::rehash;
+	using Base::contains;
+	using Base::count;
+
+	NODISCARD iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return Base::begin();
+	}
+
+	NODISCARD iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return Base::end();
+	}
+
+	NODISCARD iterator find(const key_type& key) const
+	{
+		return Base::find(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	NODISCARD iterator find(const K& key) const
+	{
+		return Base::find(key);
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return this->insertUnique(value);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return this->insertUnique(STD move(value));
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		this->insertRange(first, last);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		this->insertRange(ilist.begin(), ilist.end());
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		return this->emplaceUnique(STD forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return Base::erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) JLIBCXX_NOEXCEPT
+	{
+		return Base::erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	template <typename K, typename = typename Base:: template RequireTransparent<K>>
+	size_type erase(const K& key)
+	{
+		return this->eraseKey(key);
+	}
+
+	void swap(FlatHashSet& other) JLIBCXX_NOEXCEPT_IF(noexcept(STD declval<Base&>().swap(other)))
+	{
+		Base::swap(other);
+	}
+
+	friend bool operator==(const FlatHashSet& left, const FlatHashSet& right)
+	{
+		return static_cast<const Base&>(left) == static_cast<const Base&>(right);
+	}
+
+	friend bool operator!=(const FlatHashSet& left, const FlatHashSet& right)
+	{
+		return !(left == right);
+	}
+
+	friend void swap(FlatHashSet& left, FlatHashSet& right) JLIBCXX_NOEXCEPT_IF(noexcept(left.swap(right)))
+	{
+		left.swap(right);
+	}
+};
+
+JSTD_END
+
+#endif // !FLAT_HASH_MAP
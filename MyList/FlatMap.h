@@ -0,0 +1,1496 @@
+#pragma once
+#ifndef FLAT_MAP
+#define FLAT_MAP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+#include "Vector.h"
+
+JSTD_START
+
+// Tag for constructors and inserts whose input is already sorted and free of duplicates.
+struct SortedUniqueT
+{
+	explicit SortedUniqueT() = default;
+};
+
+inline constexpr SortedUniqueT sortedUnique{};
+
+/*
+* Walks the key and value containers of a FlatMap side by side. Dereferencing yields a pair
+* of references, like BTreeIterator.
+*/
+template <typename KeyIter, typename MappedIter>
+class FlatMapIterator
+{
+private:
+
+	using Key = STD iter_value_t<KeyIter>;
+	using T = STD iter_value_t<MappedIter>;
+	using MappedRef = STD iter_reference_t<MappedIter>;
+
+public:
+
+	using iterator_concept = STD random_access_iterator_tag;
+	using iterator_category = STD input_iterator_tag;
+	using value_type = STD pair<Key, T>;
+	using difference_type = STD ptrdiff_t;
+	using reference = STD pair<const Key&, MappedRef>;
+
+	// operator-> has to hand out the address of something, so it keeps the pair alive.
+	class pointer
+	{
+	public:
+
+		explicit pointer(reference ref)
+			: mRef(ref)
+		{ }
+
+		reference* operator->() JLIBCXX_NOEXCEPT
+		{
+			return STD addressof(mRef);
+		}
+
+	private:
+
+		reference mRef;
+	};
+
+	FlatMapIterator() = default;
+
+	FlatMapIterator(KeyIter key, MappedIter mapped) JLIBCXX_NOEXCEPT
+		: mKey(key), mMapped(mapped)
+	{ }
+
+	template <typename OtherMapped, typename = STD enable_if_t<!STD is_same_v<OtherMapped, MappedIter>
+		&& STD is_convertible_v<OtherMapped, MappedIter>>>
+	FlatMapIterator(const FlatMapIterator<KeyIter, OtherMapped>& other) JLIBCXX_NOEXCEPT
+		: mKey(other.mKey), mMapped(other.mMapped)
+	{ }
+
+	reference operator*() const JLIBCXX_NOEXCEPT
+	{
+		return reference(*mKey, *mMapped);
+	}
+
+	pointer operator->() const JLIBCXX_NOEXCEPT
+	{
+		return pointer(**this);
+	}
+
+	reference operator[](difference_type n) const JLIBCXX_NOEXCEPT
+	{
+		return *(*this + n);
+	}
+
+	const Key& key() const JLIBCXX_NOEXCEPT
+	{
+		return *mKey;
+	}
+
+	MappedRef mapped() const JLIBCXX_NOEXCEPT
+	{
+		return *mMapped;
+	}
+
+	FlatMapIterator& operator++() JLIBCXX_NOEXCEPT
+	{
+		++mKey;
+		++mMapped;
+		return *this;
+	}
+
+	FlatMapIterator operator++(int) JLIBCXX_NOEXCEPT
+	{
+		FlatMapIterator temp = *this;
+		++*this;
+		return temp;
+	}
+
+	FlatMapIterator& operator--() JLIBCXX_NOEXCEPT
+	{
+		--mKey;
+		--mMapped;
+		return *this;
+	}
+
+	FlatMapIterator operator--(int) JLIBCXX_NOEXCEPT
+	{
+		FlatMapIterator temp = *this;
+		--*this;
+		return temp;
+	}
+
+	FlatMapIterator& operator+=(difference_type n) JLIBCXX_NOEXCEPT
+	{
+		mKey += n;
+		mMapped += n;
+		return *this;
+	}
+
+	FlatMapIterator& operator-=(difference_type n) JLIBCXX_NOEXCEPT
+	{
+		mKey -= n;
+		mMapped -= n;
+		return *this;
+	}
+
+	friend FlatMapIterator operator+(FlatMapIterator it, difference_type n) JLIBCXX_NOEXCEPT
+	{
+		return it += n;
+	}
+
+	friend FlatMapIterator operator+(difference_type n, FlatMapIterator it) JLIBCXX_NOEXCEPT
+	{
+		return it += n;
+	}
+
+	friend FlatMapIterator operator-(FlatMapIterator it, difference_type n) JLIBCXX_NOEXCEPT
+	{
+		return it -= n;
+	}
+
+	friend difference_type operator-(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return static_cast<difference_type>(left.mKey - right.mKey);
+	}
+
+	friend bool operator==(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mKey == right.mKey;
+	}
+
+	friend bool operator!=(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return !(left == right);
+	}
+
+	friend bool operator<(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return left.mKey < right.mKey;
+	}
+
+	friend bool operator>(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return right < left;
+	}
+
+	friend bool operator<=(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return !(right < left);
+	}
+
+	friend bool operator>=(const FlatMapIterator& left, const FlatMapIterator& right) JLIBCXX_NOEXCEPT
+	{
+		return !(left < right);
+	}
+
+	KeyIter mKey;
+
+	MappedIter mMapped;
+};
+
+/*
+* Ordered map kept as two sorted, parallel Vectors: one of keys, one of values. Lookups are a
+* branchless binary search over the keys alone, iteration is a linear scan, and there is no
+* per-element allocation, which makes it the choice for tables that are built once and read
+* many times. A single insert or erase shifts the tail, O(n); load in bulk instead.
+*
+* Bulk construction and insert(first, last) append everything, sort the new part once and
+* merge it in. When keys repeat the first one wins, as with repeated insert. merge_sorted
+* skips the sort for input that is already in order.
+*
+* Any insert or erase invalidates every iterator. The containers must be random access with
+* contiguous keys; use the container constructor to give them an allocator.
+*/
+template <typename Key, typename T, typename Compare = STD less<Key>,
+	typename KeyContainer = Vector<Key>, typename MappedContainer = Vector<T>>
+class FlatMap
+{
+public:
+
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = STD pair<Key, T>;
+	using key_compare = Compare;
+	using reference = STD pair<const Key&, T&>;
+	using const_reference = STD pair<const Key&, const T&>;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using key_container_type = KeyContainer;
+	using mapped_container_type = MappedContainer;
+	using iterator = FlatMapIterator<typename KeyContainer::const_iterator, typename MappedContainer::iterator>;
+	using const_iterator = FlatMapIterator<typename KeyContainer::const_iterator, typename MappedContainer::const_iterator>;
+	using reverse_iterator = STD reverse_iterator<iterator>;
+	using const_reverse_iterator = STD reverse_iterator<const_iterator>;
+
+	// What extract() hands out and replace() takes.
+	struct containers
+	{
+		key_container_type keys;
+		mapped_container_type values;
+	};
+
+private:
+
+	static_assert(STD is_same_v<typename KeyContainer::value_type, Key>,
+		"jstd::FlatMap must have the same key_type as its key container.");
+	static_assert(STD is_same_v<typename MappedContainer::value_type, T>,
+		"jstd::FlatMap must have the same mapped_type as its mapped container.");
+
+	template <typename K, typename C = Compare>
+	using RequireTransparent = STD enable_if_t<IsTransparent<C>::value, K>;
+
+	CompressedPair<Compare, containers> mData;
+
+	KeyContainer& keyContainer() JLIBCXX_NOEXCEPT
+	{
+		return mData.second.keys;
+	}
+
+	const KeyContainer& keyContainer() const JLIBCXX_NOEXCEPT
+	{
+		return mData.second.keys;
+	}
+
+	MappedContainer& valueContainer() JLIBCXX_NOEXCEPT
+	{
+		return mData.second.values;
+	}
+
+	const MappedContainer& valueContainer() const JLIBCXX_NOEXCEPT
+	{
+		return mData.second.values;
+	}
+
+	const Compare& comp() const JLIBCXX_NOEXCEPT
+	{
+		return mData.first();
+	}
+
+	iterator iteratorAt(size_type index) JLIBCXX_NOEXCEPT
+	{
+		return iterator(keyContainer().cbegin() + static_cast<difference_type>(index),
+			valueContainer().begin() + static_cast<difference_type>(index));
+	}
+
+	const_iterator iteratorAt(size_type index) const JLIBCXX_NOEXCEPT
+	{
+		return const_iterator(keyContainer().cbegin() + static_cast<difference_type>(index),
+			valueContainer().cbegin() + static_cast<difference_type>(index));
+	}
+
+	template <typename K>
+	size_type lowerIndex(const K& key) const
+	{
+		return branchlessLowerBound(keyContainer().data(), size(), key, comp());
+	}
+
+	template <typename K>
+	size_type upperIndex(const K& key) const
+	{
+		return branchlessUpperBound(keyContainer().data(), size(), key, comp());
+	}
+
+	template <typename K>
+	size_type findIndex(const K& key) const
+	{
+		const size_type index = lowerIndex(key);
+		return index != size() && !comp()(key, keyContainer()[index]) ? index : size();
+	}
+
+	// Put key and a value built from args at index. If the value throws, the key goes again.
+	template <typename K, typename... Args>
+	iterator insertAt(size_type index, K&& key, Args&&... args)
+	{
+		const auto offset = static_cast<difference_type>(index);
+		keyContainer().emplace(keyContainer().cbegin() + offset, STD forward<K>(key));
+
+		TRY_START
+		valueContainer().emplace(valueContainer().cbegin() + offset, STD forward<Args>(args)...);
+		CATCH_ALL
+		keyContainer().erase(keyContainer().cbegin() + offset);
+		THROW_AGAIN
+		END_CATCH
+
+		return iteratorAt(index);
+	}
+
+	template <typename K, typename... Args>
+	STD pair<iterator, bool> tryEmplace(K&& key, Args&&... args)
+	{
+		const size_type index = lowerIndex(key);
+		if (index != size() && !comp()(key, keyContainer()[index]))
+		{
+			return { iteratorAt(index), false };
+		}
+
+		return { insertAt(index, STD forward<K>(key), STD forward<Args>(args)...), true };
+	}
+
+	template <typename InputIterator>
+	void appendRange(InputIterator first, InputIterator last)
+	{
+		if constexpr (STD is_base_of_v<STD forward_iterator_tag, iterator_category_t<InputIterator>>)
+		{
+			const auto count = static_cast<size_type>(STD distance(first, last));
+			keyContainer().reserve(size() + count);
+			valueContainer().reserve(size() + count);
+		}
+
+		for (; first != last; ++first)
+		{
+			auto&& element = *first;
+			keyContainer().emplace_back(element.first);
+			valueContainer().emplace_back(element.second);
+		}
+	}
+
+	/*
+	* Stable sort of the elements from n on. The keys are sorted through a permutation, which
+	* is then applied to both containers in place by following its cycles.
+	*/
+	void sortTail(size_type n)
+	{
+		KeyContainer& keys = keyContainer();
+		MappedContainer& values = valueContainer();
+		const size_type count = size() - n;
+		const auto keysFirst = keys.begin() + static_cast<difference_type>(n);
+		if (count < 2 || STD is_sorted(keysFirst, keys.end(), comp()))
+		{
+			return;
+		}
+
+		Vector<size_type> order(count);
+		STD iota(order.begin(), order.end(), size_type(0));
+		STD stable_sort(order.begin(), order.end(),
+			[&](size_type left, size_type right)
+			{
+				return comp()(keys[n + left], keys[n + right]);
+			});
+
+		for (size_type i = 0; i < count; ++i)
+		{
+			if (order[i] == i)
+			{
+				continue;
+			}
+
+			Key key(STD move(keys[n + i]));
+			T value(STD move(values[n + i]));
+			size_type hole = i;
+			while (order[hole] != i)
+			{
+				const size_type next = order[hole];
+				keys[n + hole] = STD move(keys[n + next]);
+				values[n + hole] = STD move(values[n + next]);
+				order[hole] = hole;
+				hole = next;
+			}
+
+			keys[n + hole] = STD move(key);
+			values[n + hole] = STD move(value);
+			order[hole] = hole;
+		}
+	}
+
+	// Drop the repeats from n on, keeping the first of each. [0, n) must stay as it is.
+	void dedupeFrom(size_type n)
+	{
+		KeyContainer& keys = keyContainer();
+		MappedContainer& values = valueContainer();
+		const size_type total = size();
+		size_type write = n;
+		for (size_type read = n; read < total; ++read)
+		{
+			if (write != 0 && !comp()(keys[write - 1], keys[read]))
+			{
+				continue;
+			}
+
+			if (write != read)
+			{
+				keys[write] = STD move(keys[read]);
+				values[write] = STD move(values[read]);
+			}
+
+			++write;
+		}
+
+		keys.erase(keys.cbegin() + static_cast<difference_type>(write), keys.cend());
+		values.erase(values.cbegin() + static_cast<difference_type>(write), values.cend());
+	}
+
+	/*
+	* [0, n) is sorted and unique, [n, size()) is sorted. New keys that all go after the old
+	* ones are deduplicated in place; otherwise both runs merge into new containers, so the old
+	* elements are untouched until the merge has succeeded. Old keys win over equal new ones.
+	*
+	* Key and value are moved or copied together: once a key has been moved out, nothing after
+	* it may throw, so the merge moves only when both moves and the comparison are nothrow.
+	* Move-only elements are moved anyway, as STD move_if_noexcept would.
+	*/
+	void mergeTail(size_type n)
+	{
+		constexpr bool mergeMoves = (STD is_nothrow_move_constructible_v<Key>
+			&& STD is_nothrow_move_constructible_v<T>
+			&& STD is_nothrow_invocable_v<const Compare&, const Key&, const Key&>)
+			|| !STD is_copy_constructible_v<Key>
+			|| !STD is_copy_constructible_v<T>;
+
+		KeyContainer& keys = keyContainer();
+		MappedContainer& values = valueContainer();
+		const size_type total = size();
+		if (n == total)
+		{
+			return;
+		}
+
+		if (n == 0 || comp()(keys[n - 1], keys[n]))
+		{
+			dedupeFrom(n);
+			return;
+		}
+
+		containers merged{ KeyContainer(keys.get_allocator()), MappedContainer(values.get_allocator()) };
+		merged.keys.reserve(total);
+		merged.values.reserve(total);
+
+		size_type i = 0;
+		size_type j = n;
+		while (i != n || j != total)
+		{
+			const bool takeOld = j == total || (i != n && !comp()(keys[j], keys[i]));
+			const size_type from = takeOld ? i++ : j++;
+			if (!merged.keys.empty() && !comp()(merged.keys.back(), keys[from]))
+			{
+				continue;
+			}
+
+			if constexpr (mergeMoves)
+			{
+				merged.keys.emplace_back(STD move(keys[from]));
+				merged.values.emplace_back(STD move(values[from]));
+			}
+			else
+			{
+				merged.keys.emplace_back(STD as_const(keys[from]));
+				merged.values.emplace_back(STD as_const(values[from]));
+			}
+		}
+
+		using STD swap;
+		swap(keys, merged.keys);
+		swap(values, merged.values);
+	}
+
+	// Only the appended elements are touched until the end, so a throw just cuts them off again.
+	template <typename InputIterator>
+	void insertBulk(InputIterator first, InputIterator last, bool sorted)
+	{
+		const size_type oldSize = size();
+
+		TRY_START
+		appendRange(first, last);
+		if (!sorted)
+		{
+			sortTail(oldSize);
+		}
+
+		mergeTail(oldSize);
+		CATCH_ALL
+		keyContainer().erase(keyContainer().cbegin() + static_cast<difference_type>(oldSize), keyContainer().cend());
+		valueContainer().erase(valueContainer().cbegin() + static_cast<difference_type>(oldSize), valueContainer().cend());
+		THROW_AGAIN
+		END_CATCH
+	}
+
+public:
+
+	FlatMap()
+		: mData(ZeroThenVariadicArgsT{})
+	{ }
+
+	explicit FlatMap(const Compare& comp)
+		: mData(OneThenVariadicArgsT{}, comp)
+	{ }
+
+	// Takes the containers as they are, then sorts and deduplicates them. Sizes must match.
+	FlatMap(key_container_type keys, mapped_container_type values, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp, containers{ STD move(keys), STD move(values) })
+	{
+		sortTail(0);
+		mergeTail(0);
+	}
+
+	FlatMap(SortedUniqueT, key_container_type keys, mapped_container_type values, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp, containers{ STD move(keys), STD move(values) })
+	{ }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatMap(InputIterator first, InputIterator last, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp)
+	{
+		insertBulk(first, last, false);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatMap(SortedUniqueT, InputIterator first, InputIterator last, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp)
+	{
+		appendRange(first, last);
+	}
+
+	FlatMap(STD initializer_list<value_type> ilist, const Compare& comp = Compare())
+		: FlatMap(ilist.begin(), ilist.end(), comp)
+	{ }
+
+	FlatMap(SortedUniqueT, STD initializer_list<value_type> ilist, const Compare& comp = Compare())
+		: FlatMap(sortedUnique, ilist.begin(), ilist.end(), comp)
+	{ }
+
+	FlatMap(const FlatMap&) = default;
+
+	FlatMap(FlatMap&&) = default;
+
+	~FlatMap() = default;
+
+	FlatMap& operator=(const FlatMap&) = default;
+
+	FlatMap& operator=(FlatMap&&) = default;
+
+	FlatMap& operator=(STD initializer_list<value_type> ilist)
+	{
+		clear();
+		insertBulk(ilist.begin(), ilist.end(), false);
+		return *this;
+	}
+
+	NODISCARD iterator begin() JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(0);
+	}
+
+	NODISCARD const_iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(0);
+	}
+
+	NODISCARD iterator end() JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(size());
+	}
+
+	NODISCARD const_iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return iteratorAt(size());
+	}
+
+	NODISCARD reverse_iterator rbegin() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	NODISCARD const_reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(end());
+	}
+
+	NODISCARD reverse_iterator rend() JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
+	NODISCARD const_reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD const_reverse_iterator crbegin() const JLIBCXX_NOEXCEPT
+	{
+		return rbegin();
+	}
+
+	NODISCARD const_reverse_iterator crend() const JLIBCXX_NOEXCEPT
+	{
+		return rend();
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().empty();
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<size_type>(keyContainer().size());
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD min<size_type>(keyContainer().max_size(), valueContainer().max_size());
+	}
+
+	void reserve(size_type n)
+	{
+		keyContainer().reserve(n);
+		valueContainer().reserve(n);
+	}
+
+	void shrink_to_fit()
+	{
+		keyContainer().shrink_to_fit();
+		valueContainer().shrink_to_fit();
+	}
+
+	NODISCARD key_compare key_comp() const
+	{
+		return comp();
+	}
+
+	NODISCARD const key_container_type& keys() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer();
+	}
+
+	NODISCARD const mapped_container_type& values() const JLIBCXX_NOEXCEPT
+	{
+		return valueContainer();
+	}
+
+	mapped_type& operator[](const key_type& key)
+	{
+		return tryEmplace(key).first.mapped();
+	}
+
+	mapped_type& operator[](key_type&& key)
+	{
+		return tryEmplace(STD move(key)).first.mapped();
+	}
+
+	NODISCARD mapped_type& at(const key_type& key)
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			throw STD out_of_range("FlatMap::at: key not found");
+		}
+
+		return valueContainer()[index];
+	}
+
+	NODISCARD const mapped_type& at(const key_type& key) const
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			throw STD out_of_range("FlatMap::at: key not found");
+		}
+
+		return valueContainer()[index];
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		value_type value(STD forward<Args>(args)...);
+		return tryEmplace(STD move(value.first), STD move(value.second));
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return tryEmplace(value.first, value.second);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return tryEmplace(STD move(value.first), STD move(value.second));
+	}
+
+	template <typename P, typename = STD enable_if_t<STD is_constructible_v<value_type, P&&>>>
+	STD pair<iterator, bool> insert(P&& value)
+	{
+		return emplace(STD forward<P>(value));
+	}
+
+	// Appends the range, sorts it once and merges it in.
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, false);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(SortedUniqueT, InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, true);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		insertBulk(ilist.begin(), ilist.end(), false);
+	}
+
+	/*
+	* Batch insert of a range sorted by key, without the sort: one linear merge. Repeated keys
+	* are allowed, the first one wins. O(size() + distance(first, last)).
+	*/
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void merge_sorted(InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, true);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		return tryEmplace(key, STD forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+	{
+		return tryEmplace(STD move(key), STD forward<Args>(args)...);
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(const key_type& key, M&& value)
+	{
+		auto result = tryEmplace(key, STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first.mapped() = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	template <typename M>
+	STD pair<iterator, bool> insert_or_assign(key_type&& key, M&& value)
+	{
+		auto result = tryEmplace(STD move(key), STD forward<M>(value));
+		if (!result.second)
+		{
+			result.first.mapped() = STD forward<M>(value);
+		}
+
+		return result;
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		const auto offset = pos.mKey - keyContainer().cbegin();
+		keyContainer().erase(keyContainer().cbegin() + offset);
+		valueContainer().erase(valueContainer().cbegin() + offset);
+		return iteratorAt(static_cast<size_type>(offset));
+	}
+
+	iterator erase(iterator pos)
+	{
+		return erase(const_iterator(pos));
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		const auto from = first.mKey - keyContainer().cbegin();
+		const auto to = last.mKey - keyContainer().cbegin();
+		keyContainer().erase(keyContainer().cbegin() + from, keyContainer().cbegin() + to);
+		valueContainer().erase(valueContainer().cbegin() + from, valueContainer().cbegin() + to);
+		return iteratorAt(static_cast<size_type>(from));
+	}
+
+	size_type erase(const key_type& key)
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			return 0;
+		}
+
+		erase(iteratorAt(index));
+		return 1;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	size_type erase(const K& key)
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			return 0;
+		}
+
+		erase(iteratorAt(index));
+		return 1;
+	}
+
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		keyContainer().clear();
+		valueContainer().clear();
+	}
+
+	// Moves both containers out and leaves the map empty.
+	NODISCARD containers extract() &&
+	{
+		containers result = STD move(mData.second);
+		clear();
+		return result;
+	}
+
+	// The inverse of extract. keys must be sorted and unique and the sizes must match.
+	void replace(key_container_type&& keys, mapped_container_type&& values)
+	{
+		keyContainer() = STD move(keys);
+		valueContainer() = STD move(values);
+	}
+
+	void swap(FlatMap& other) JLIBCXX_NOEXCEPT
+	{
+		using STD swap;
+		swap(mData.first(), other.mData.first());
+		swap(keyContainer(), other.keyContainer());
+		swap(valueContainer(), other.valueContainer());
+	}
+
+	NODISCARD iterator find(const key_type& key)
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	NODISCARD const_iterator find(const key_type& key) const
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator find(const K& key)
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator find(const K& key) const
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	NODISCARD bool contains(const key_type& key) const
+	{
+		return findIndex(key) != size();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD bool contains(const K& key) const
+	{
+		return findIndex(key) != size();
+	}
+
+	NODISCARD size_type count(const key_type& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD size_type count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	NODISCARD iterator lower_bound(const key_type& key)
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	NODISCARD const_iterator lower_bound(const key_type& key) const
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key)
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator lower_bound(const K& key) const
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	NODISCARD iterator upper_bound(const key_type& key)
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	NODISCARD const_iterator upper_bound(const key_type& key) const
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key)
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD const_iterator upper_bound(const K& key) const
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const key_type& key)
+	{
+		const size_type index = lowerIndex(key);
+		const size_type next = index != size() && !comp()(key, keyContainer()[index]) ? index + 1 : index;
+		return { iteratorAt(index), iteratorAt(next) };
+	}
+
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+	{
+		const size_type index = lowerIndex(key);
+		const size_type next = index != size() && !comp()(key, keyContainer()[index]) ? index + 1 : index;
+		return { iteratorAt(index), iteratorAt(next) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key)
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	friend bool operator==(const FlatMap& left, const FlatMap& right)
+	{
+		return left.size() == right.size()
+			&& STD equal(left.keys().begin(), left.keys().end(), right.keys().begin())
+			&& STD equal(left.values().begin(), left.values().end(), right.values().begin());
+	}
+
+	friend bool operator!=(const FlatMap& left, const FlatMap& right)
+	{
+		return !(left == right);
+	}
+
+	friend void swap(FlatMap& left, FlatMap& right) JLIBCXX_NOEXCEPT
+	{
+		left.swap(right);
+	}
+};
+
+/*
+* Ordered set kept as one sorted Vector. Same trade-offs as FlatMap: branchless lookup,
+* linear iteration, O(n) single inserts, bulk loads sorted once. Elements are const,
+* iterator and const_iterator are the same.
+*/
+template <typename Key, typename Compare = STD less<Key>, typename KeyContainer = Vector<Key>>
+class FlatSet
+{
+public:
+
+	using key_type = Key;
+	using value_type = Key;
+	using key_compare = Compare;
+	using value_compare = Compare;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using container_type = KeyContainer;
+	using iterator = typename KeyContainer::const_iterator;
+	using const_iterator = typename KeyContainer::const_iterator;
+	using reverse_iterator = STD reverse_iterator<iterator>;
+	using const_reverse_iterator = STD reverse_iterator<const_iterator>;
+
+private:
+
+	static_assert(STD is_same_v<typename KeyContainer::value_type, Key>,
+		"jstd::FlatSet must have the same key_type as its container.");
+
+	template <typename K, typename C = Compare>
+	using RequireTransparent = STD enable_if_t<IsTransparent<C>::value, K>;
+
+	CompressedPair<Compare, KeyContainer> mData;
+
+	KeyContainer& keyContainer() JLIBCXX_NOEXCEPT
+	{
+		return mData.second;
+	}
+
+	const KeyContainer& keyContainer() const JLIBCXX_NOEXCEPT
+	{
+		return mData.second;
+	}
+
+	const Compare& comp() const JLIBCXX_NOEXCEPT
+	{
+		return mData.first();
+	}
+
+	iterator iteratorAt(size_type index) const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().cbegin() + static_cast<difference_type>(index);
+	}
+
+	template <typename K>
+	size_type lowerIndex(const K& key) const
+	{
+		return branchlessLowerBound(keyContainer().data(), size(), key, comp());
+	}
+
+	template <typename K>
+	size_type upperIndex(const K& key) const
+	{
+		return branchlessUpperBound(keyContainer().data(), size(), key, comp());
+	}
+
+	template <typename K>
+	size_type findIndex(const K& key) const
+	{
+		const size_type index = lowerIndex(key);
+		return index != size() && !comp()(key, keyContainer()[index]) ? index : size();
+	}
+
+	template <typename K>
+	STD pair<iterator, bool> insertUnique(K&& key)
+	{
+		const size_type index = lowerIndex(key);
+		if (index != size() && !comp()(key, keyContainer()[index]))
+		{
+			return { iteratorAt(index), false };
+		}
+
+		keyContainer().emplace(iteratorAt(index), STD forward<K>(key));
+		return { iteratorAt(index), true };
+	}
+
+	// Drop the repeats from n on, keeping the first of each. [0, n) must stay as it is.
+	void dedupeFrom(size_type n)
+	{
+		KeyContainer& keys = keyContainer();
+		const auto first = keys.begin() + static_cast<difference_type>(n == 0 ? 0 : n - 1);
+		const auto last = STD unique(first, keys.end(),
+			[this](const Key& left, const Key& right)
+			{
+				return !comp()(left, right);
+			});
+
+		keys.erase(last, keys.end());
+	}
+
+	// Same scheme as FlatMap::mergeTail.
+	void mergeTail(size_type n)
+	{
+		KeyContainer& keys = keyContainer();
+		const size_type total = size();
+		if (n == total)
+		{
+			return;
+		}
+
+		if (n == 0 || comp()(keys[n - 1], keys[n]))
+		{
+			dedupeFrom(n);
+			return;
+		}
+
+		KeyContainer merged(keys.get_allocator());
+		merged.reserve(total);
+
+		size_type i = 0;
+		size_type j = n;
+		while (i != n || j != total)
+		{
+			const bool takeOld = j == total || (i != n && !comp()(keys[j], keys[i]));
+			const size_type from = takeOld ? i++ : j++;
+			if (merged.empty() || comp()(merged.back(), keys[from]))
+			{
+				merged.emplace_back(STD move_if_noexcept(keys[from]));
+			}
+		}
+
+		using STD swap;
+		swap(keys, merged);
+	}
+
+	// Only the appended elements are touched until the end, so a throw just cuts them off again.
+	template <typename InputIterator>
+	void insertBulk(InputIterator first, InputIterator last, bool sorted)
+	{
+		KeyContainer& keys = keyContainer();
+		const size_type oldSize = size();
+
+		TRY_START
+		keys.insert(keys.cend(), first, last);
+		if (!sorted)
+		{
+			STD stable_sort(keys.begin() + static_cast<difference_type>(oldSize), keys.end(), comp());
+		}
+
+		mergeTail(oldSize);
+		CATCH_ALL
+		keys.erase(keys.cbegin() + static_cast<difference_type>(oldSize), keys.cend());
+		THROW_AGAIN
+		END_CATCH
+	}
+
+public:
+
+	FlatSet()
+		: mData(ZeroThenVariadicArgsT{})
+	{ }
+
+	explicit FlatSet(const Compare& comp)
+		: mData(OneThenVariadicArgsT{}, comp)
+	{ }
+
+	// Takes the container as it is, then sorts and deduplicates it.
+	explicit FlatSet(container_type keys, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp, STD move(keys))
+	{
+		STD stable_sort(keyContainer().begin(), keyContainer().end(), this->comp());
+		dedupeFrom(0);
+	}
+
+	FlatSet(SortedUniqueT, container_type keys, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp, STD move(keys))
+	{ }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatSet(InputIterator first, InputIterator last, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp)
+	{
+		insertBulk(first, last, false);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	FlatSet(SortedUniqueT, InputIterator first, InputIterator last, const Compare& comp = Compare())
+		: mData(OneThenVariadicArgsT{}, comp)
+	{
+		keyContainer().insert(keyContainer().cend(), first, last);
+	}
+
+	FlatSet(STD initializer_list<value_type> ilist, const Compare& comp = Compare())
+		: FlatSet(ilist.begin(), ilist.end(), comp)
+	{ }
+
+	FlatSet(SortedUniqueT, STD initializer_list<value_type> ilist, const Compare& comp = Compare())
+		: FlatSet(sortedUnique, ilist.begin(), ilist.end(), comp)
+	{ }
+
+	FlatSet(const FlatSet&) = default;
+
+	FlatSet(FlatSet&&) = default;
+
+	~FlatSet() = default;
+
+	FlatSet& operator=(const FlatSet&) = default;
+
+	FlatSet& operator=(FlatSet&&) = default;
+
+	FlatSet& operator=(STD initializer_list<value_type> ilist)
+	{
+		clear();
+		insertBulk(ilist.begin(), ilist.end(), false);
+		return *this;
+	}
+
+	NODISCARD iterator begin() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().cbegin();
+	}
+
+	NODISCARD iterator end() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().cend();
+	}
+
+	NODISCARD reverse_iterator rbegin() const JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	NODISCARD reverse_iterator rend() const JLIBCXX_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
+	NODISCARD const_iterator cbegin() const JLIBCXX_NOEXCEPT
+	{
+		return begin();
+	}
+
+	NODISCARD const_iterator cend() const JLIBCXX_NOEXCEPT
+	{
+		return end();
+	}
+
+	NODISCARD const_reverse_iterator crbegin() const JLIBCXX_NOEXCEPT
+	{
+		return rbegin();
+	}
+
+	NODISCARD const_reverse_iterator crend() const JLIBCXX_NOEXCEPT
+	{
+		return rend();
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().empty();
+	}
+
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<size_type>(keyContainer().size());
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return keyContainer().max_size();
+	}
+
+	void reserve(size_type n)
+	{
+		keyContainer().reserve(n);
+	}
+
+	void shrink_to_fit()
+	{
+		keyContainer().shrink_to_fit();
+	}
+
+	NODISCARD key_compare key_comp() const
+	{
+		return comp();
+	}
+
+	NODISCARD value_compare value_comp() const
+	{
+		return comp();
+	}
+
+	template <typename... Args>
+	STD pair<iterator, bool> emplace(Args&&... args)
+	{
+		if constexpr (sizeof...(Args) == 1 && (STD is_same_v<STD remove_cvref_t<Args>, Key> && ...))
+		{
+			return insertUnique(STD forward<Args>(args)...);
+		}
+		else
+		{
+			return insertUnique(Key(STD forward<Args>(args)...));
+		}
+	}
+
+	STD pair<iterator, bool> insert(const value_type& value)
+	{
+		return insertUnique(value);
+	}
+
+	STD pair<iterator, bool> insert(value_type&& value)
+	{
+		return insertUnique(STD move(value));
+	}
+
+	// Appends the range, sorts it once and merges it in.
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, false);
+	}
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void insert(SortedUniqueT, InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, true);
+	}
+
+	void insert(STD initializer_list<value_type> ilist)
+	{
+		insertBulk(ilist.begin(), ilist.end(), false);
+	}
+
+	// Batch insert of a sorted range, without the sort. See FlatMap::merge_sorted.
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	void merge_sorted(InputIterator first, InputIterator last)
+	{
+		insertBulk(first, last, true);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		return keyContainer().erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		return keyContainer().erase(first, last);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			return 0;
+		}
+
+		keyContainer().erase(iteratorAt(index));
+		return 1;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	size_type erase(const K& key)
+	{
+		const size_type index = findIndex(key);
+		if (index == size())
+		{
+			return 0;
+		}
+
+		keyContainer().erase(iteratorAt(index));
+		return 1;
+	}
+
+	void clear() JLIBCXX_NOEXCEPT
+	{
+		keyContainer().clear();
+	}
+
+	// Moves the container out and leaves the set empty.
+	NODISCARD container_type extract() &&
+	{
+		container_type result = STD move(keyContainer());
+		clear();
+		return result;
+	}
+
+	// The inverse of extract. keys must be sorted and unique.
+	void replace(container_type&& keys)
+	{
+		keyContainer() = STD move(keys);
+	}
+
+	void swap(FlatSet& other) JLIBCXX_NOEXCEPT
+	{
+		using STD swap;
+		swap(mData.first(), other.mData.first());
+		swap(keyContainer(), other.keyContainer());
+	}
+
+	NODISCARD iterator find(const key_type& key) const
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator find(const K& key) const
+	{
+		return iteratorAt(findIndex(key));
+	}
+
+	NODISCARD bool contains(const key_type& key) const
+	{
+		return findIndex(key) != size();
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD bool contains(const K& key) const
+	{
+		return findIndex(key) != size();
+	}
+
+	NODISCARD size_type count(const key_type& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD size_type count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	NODISCARD iterator lower_bound(const key_type& key) const
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator lower_bound(const K& key) const
+	{
+		return iteratorAt(lowerIndex(key));
+	}
+
+	NODISCARD iterator upper_bound(const key_type& key) const
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD iterator upper_bound(const K& key) const
+	{
+		return iteratorAt(upperIndex(key));
+	}
+
+	NODISCARD STD pair<iterator, iterator> equal_range(const key_type& key) const
+	{
+		const size_type index = lowerIndex(key);
+		const size_type next = index != size() && !comp()(key, keyContainer()[index]) ? index + 1 : index;
+		return { iteratorAt(index), iteratorAt(next) };
+	}
+
+	template <typename K, typename = RequireTransparent<K>>
+	NODISCARD STD pair<iterator, iterator> equal_range(const K& key) const
+	{
+		return { lower_bound(key), upper_bound(key) };
+	}
+
+	friend bool operator==(const FlatSet& left, const FlatSet& right)
+	{
+		return left.size() == right.size() && STD equal(left.begin(), left.end(), right.begin());
+	}
+
+	friend bool operator!=(const FlatSet& left, const FlatSet& right)
+	{
+		return !(left == right);
+	}
+
+	friend void swap(FlatSet& left, FlatSet& right) JLIBCXX_NOEXCEPT
+	{
+		left.swap(right);
+	}
+};
+
+JSTD_END
+
+#endif // !FLAT_MAP
@@ -74,6 +74,33 @@ using RequireAllocator = STD enable_if_t<is_allocator_v<Alloc>, Alloc>;
 template <typename Alloc>
 using RequireNotAllocator = STD enable_if_t<!is_allocator_v<Alloc>, Alloc>;
 
+// Compare::is_transparent enables lookup by any type the comparator accepts.
+template <typename Compare, typename = void>
+struct IsTransparent : STD false_type { };
+
+template <typename Compare>
+struct IsTransparent<Compare, STD void_t<typename Compare::is_transparent>> : STD true_type { };
+
+// KeyOfValue for sets: the element is the key.
+struct Identity
+{
+	template <typename T>
+	constexpr T&& operator()(T&& value) const JLIBCXX_NOEXCEPT
+	{
+		return STD forward<T>(value);
+	}
+};
+
+// KeyOfValue for maps: the key is the first member of the pair.
+struct SelectFirst
+{
+	template <typename Pair>
+	constexpr auto&& operator()(Pair&& pair) const JLIBCXX_NOEXCEPT
+	{
+		return STD forward<Pair>(pair).first;
+	}
+};
+
 // handle false trait or last trait.
 template <bool First_value, class First, class... Rest>
 struct __Conjunction { 
@@ -129,7 +156,7 @@ doAllocSwap(Alloc& left, Alloc& right)
 
 template <typename Alloc>
 constexpr inline void
-doAllocCopy(Alloc& left, Alloc& right)
+doAllocCopy(Alloc& left, const Alloc& right)
 {
 	using traits = STD allocator_traits<Alloc>;
 	using pocca = typename traits::propagate_on_container_copy_assignment;
@@ -155,7 +182,7 @@ doAllocMove(Alloc& left, Alloc& right)
 
 template <typename T>
 struct MoveIfNoexceptCondition
-	: public STD conjunction<STD negation<STD is_nothrow_constructible<T>>, STD is_copy_constructible<T>>::type
+	: public STD conjunction<STD negation<STD is_nothrow_move_constructible<T>>, STD is_copy_constructible<T>>::type
 { };
 
 template <typename T>
@@ -210,7 +237,7 @@ struct MyAlloctTraits : public STD allocator_traits<Alloc>
 		return Base_type::select_on_container_copy_construction(alloc);
 	}
 
-	static constexpr void doCopy(Alloc& left, Alloc& right)
+	static constexpr void doCopy(Alloc& left, const Alloc& right)
 	{
 		doAllocCopy(left, right);
 	}
@@ -372,14 +399,14 @@ public:
 
 	T1 value1;
 
-	T2 value2;
+	T2 second;
 
 	template <typename... Other2>
 	constexpr explicit CompressedPair(ZeroThenVariadicArgsT, Other2&&... otherValues) 
 		noexcept(
 			STD conjunction_v<STD is_nothrow_default_constructible<T1>, STD is_nothrow_constructible<T2, Other2...>>
 			)
-		: value1(), value2(STD forward<Other2>(otherValues)...) 
+		: value1(), second(STD forward<Other2>(otherValues)...) 
 	{ }
 
 	template <typename Other1, typename... Other2>
@@ -387,7 +414,7 @@ public:
 		noexcept(
 			STD conjunction_v<STD is_nothrow_constructible<T1, Other1>, STD is_nothrow_constructible<T2, Other2...>>
 			)
-		: value1(STD forward<Other1>(otherValue1)), value2(STD forward<Other2>(otherValues2)...)
+		: value1(STD forward<Other1>(otherValue1)), second(STD forward<Other2>(otherValues2)...)
 	{ }
 
 	constexpr T1& first() noexcept 
@@ -4,6 +4,7 @@
 
 #include "Allocator.h"
 #include "UniquePointer.h"
+#include "SharePointer.h"
 
 
 #endif // !ALLOCATOR
@@ -0,0 +1,595 @@
+#pragma once
+#ifndef MEMORY_RESOURCE
+#define MEMORY_RESOURCE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "Config.h"
+#include "Utility.h"
+#include "ArenaAllocator.h"
+#include "Vector.h"
+#include "MyList.h"
+#include "MyForwardList.h"
+
+JSTD_START
+
+namespace pmr {
+
+/*
+* Abstract source of memory, the runtime counterpart of an allocator.
+* Same contract as std::pmr::memory_resource.
+*/
+class MemoryResource
+{
+public:
+
+	static constexpr STD size_t maxAlign = alignof(STD max_align_t);
+
+	virtual ~MemoryResource() = default;
+
+	NODISCARD void* allocate(const STD size_t bytes, const STD size_t alignment = maxAlign)
+	{
+		return doAllocate(bytes, alignment);
+	}
+
+	void deallocate(void* ptr, const STD size_t bytes, const STD size_t alignment = maxAlign)
+	{
+		doDeallocate(ptr, bytes, alignment);
+	}
+
+	// Whether memory from one resource can be given back to the other.
+	NODISCARD bool is_equal(const MemoryResource& other) const JLIBCXX_NOEXCEPT
+	{
+		return doIsEqual(other);
+	}
+
+	friend bool operator==(const MemoryResource& left, const MemoryResource& right) JLIBCXX_NOEXCEPT
+	{
+		return &left == &right || left.is_equal(right);
+	}
+
+private:
+
+	virtual void* doAllocate(STD size_t bytes, STD size_t alignment) = 0;
+
+	virtual void doDeallocate(void* ptr, STD size_t bytes, STD size_t alignment) = 0;
+
+	virtual bool doIsEqual(const MemoryResource& other) const JLIBCXX_NOEXCEPT = 0;
+};
+
+namespace detail {
+
+class NewDeleteResource final : public MemoryResource
+{
+private:
+
+	void* doAllocate(const STD size_t bytes, const STD size_t alignment) override
+	{
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			return ::operator new(bytes, static_cast<STD align_val_t>(alignment));
+		}
+
+		return ::operator new(bytes);
+	}
+
+	void doDeallocate(void* ptr, const STD size_t bytes, const STD size_t alignment) override
+	{
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			::operator delete(ptr, bytes, static_cast<STD align_val_t>(alignment));
+			return;
+		}
+
+		::operator delete(ptr, bytes);
+	}
+
+	bool doIsEqual(const MemoryResource& other) const JLIBCXX_NOEXCEPT override
+	{
+		return this == &other;
+	}
+};
+
+class NullMemoryResource final : public MemoryResource
+{
+private:
+
+	void* doAllocate(STD size_t, STD size_t) override
+	{
+		throw STD bad_alloc();
+	}
+
+	void doDeallocate(void*, STD size_t, STD size_t) override { }
+
+	bool doIsEqual(const MemoryResource& other) const JLIBCXX_NOEXCEPT override
+	{
+		return this == &other;
+	}
+};
+
+} // namespace detail
+
+// operator new and operator delete.
+NODISCARD inline MemoryResource* newDeleteResource() JLIBCXX_NOEXCEPT
+{
+	static detail::NewDeleteResource resource;
+	return &resource;
+}
+
+// Throws bad_alloc on every allocation. Useful as upstream to forbid heap use.
+NODISCARD inline MemoryResource* nullMemoryResource() JLIBCXX_NOEXCEPT
+{
+	static detail::NullMemoryResource resource;
+	return &resource;
+}
+
+namespace detail {
+
+inline STD atomic<MemoryResource*>& defaultResourceSlot() JLIBCXX_NOEXCEPT
+{
+	static STD atomic<MemoryResource*> slot{ newDeleteResource() };
+	return slot;
+}
+
+} // namespace detail
+
+NODISCARD inline MemoryResource* getDefaultResource() JLIBCXX_NOEXCEPT
+{
+	return detail::defaultResourceSlot().load(STD memory_order_acquire);
+}
+
+// Replace the default resource and return the previous one. nullptr restores newDeleteResource().
+inline MemoryResource* setDefaultResource(MemoryResource* resource) JLIBCXX_NOEXCEPT
+{
+	return detail::defaultResourceSlot().exchange(
+		resource ? resource : newDeleteResource(), STD memory_order_acq_rel);
+}
+
+/*
+* Allocator that forwards to a MemoryResource chosen at runtime.
+*
+* Like std::pmr::polymorphic_allocator it never propagates: a container keeps the resource
+* it was built with, and a copy-constructed container uses the default resource.
+*/
+template <typename T>
+class PolymorphicAllocator
+{
+public:
+
+	using value_type = T;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+
+	using propagate_on_container_copy_assignment = STD false_type;
+	using propagate_on_container_move_assignment = STD false_type;
+	using propagate_on_container_swap = STD false_type;
+	using is_always_equal = STD false_type;
+
+	template <typename T2>
+	struct rebind
+	{
+		using other = PolymorphicAllocator<T2>;
+	};
+
+	PolymorphicAllocator() JLIBCXX_NOEXCEPT
+		: mResource(getDefaultResource())
+	{ }
+
+	PolymorphicAllocator(MemoryResource* resource) JLIBCXX_NOEXCEPT
+		: mResource(resource)
+	{ }
+
+	PolymorphicAllocator(const PolymorphicAllocator&) = default;
+
+	template <typename T2>
+	PolymorphicAllocator(const PolymorphicAllocator<T2>& other) JLIBCXX_NOEXCEPT
+		: mResource(other.resource())
+	{ }
+
+	PolymorphicAllocator& operator=(const PolymorphicAllocator&) = delete;
+
+	~PolymorphicAllocator() = default;
+
+	NODISCARD T* allocate(size_type n)
+	{
+		if (n > STD numeric_limits<size_type>::max() / sizeof(T))
+		{
+			throw STD bad_array_new_length();
+		}
+
+		return static_cast<T*>(mResource->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_type n) JLIBCXX_NOEXCEPT
+	{
+		mResource->deallocate(ptr, n * sizeof(T), alignof(T));
+	}
+
+	NODISCARD PolymorphicAllocator select_on_container_copy_construction() const JLIBCXX_NOEXCEPT
+	{
+		return PolymorphicAllocator();
+	}
+
+	NODISCARD MemoryResource* resource() const JLIBCXX_NOEXCEPT
+	{
+		return mResource;
+	}
+
+	template <typename T2>
+	friend bool operator==(const PolymorphicAllocator& left, const PolymorphicAllocator<T2>& right) JLIBCXX_NOEXCEPT
+	{
+		return *left.resource() == *right.resource();
+	}
+
+private:
+
+	MemoryResource* mResource;
+};
+
+/*
+* MonotonicArena as a MemoryResource, with its chunks taken from upstream. deallocate does
+* nothing and release() gives every chunk back.
+*/
+class MonotonicBufferResource : public MemoryResource
+{
+private:
+
+	// Arena chunks from a MemoryResource. The arena pads inside them for stricter alignment.
+	class UpstreamChunks
+	{
+	public:
+
+		explicit UpstreamChunks(MemoryResource* upstream) JLIBCXX_NOEXCEPT
+			: mUpstream(upstream)
+		{ }
+
+		NODISCARD void* allocateChunk(const STD size_t bytes)
+		{
+			return mUpstream->allocate(bytes, alignof(STD max_align_t));
+		}
+
+		void deallocateChunk(void* chunk, const STD size_t bytes) JLIBCXX_NOEXCEPT
+		{
+			mUpstream->deallocate(chunk, bytes, alignof(STD max_align_t));
+		}
+
+		NODISCARD MemoryResource* resource() const JLIBCXX_NOEXCEPT
+		{
+			return mUpstream;
+		}
+
+	private:
+
+		MemoryResource* mUpstream;
+	};
+
+	using Arena = BasicMonotonicArena<UpstreamChunks>;
+
+public:
+
+	static constexpr STD size_t defaultChunkSize = Arena::defaultChunkSize;
+
+	MonotonicBufferResource() JLIBCXX_NOEXCEPT
+		: MonotonicBufferResource(getDefaultResource())
+	{ }
+
+	explicit MonotonicBufferResource(MemoryResource* upstream) JLIBCXX_NOEXCEPT
+		: mArena(defaultChunkSize, UpstreamChunks(upstream))
+	{ }
+
+	explicit MonotonicBufferResource(const STD size_t initialSize, MemoryResource* upstream = getDefaultResource()) JLIBCXX_NOEXCEPT
+		: mArena(initialSize, UpstreamChunks(upstream))
+	{ }
+
+	MonotonicBufferResource(void* buffer, const STD size_t bytes, MemoryResource* upstream = getDefaultResource()) JLIBCXX_NOEXCEPT
+		: mArena(buffer, bytes, UpstreamChunks(upstream))
+	{ }
+
+	MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+
+	MonotonicBufferResource& operator=(const MonotonicBufferResource&) = delete;
+
+	~MonotonicBufferResource() override = default;
+
+	void release() JLIBCXX_NOEXCEPT
+	{
+		mArena.release();
+	}
+
+	NODISCARD MemoryResource* upstream_resource() const JLIBCXX_NOEXCEPT
+	{
+		return mArena.chunk_source().resource();
+	}
+
+private:
+
+	void* doAllocate(const STD size_t bytes, const STD size_t alignment) override
+	{
+		return mArena.allocate(bytes, alignment);
+	}
+
+	void doDeallocate(void*, STD size_t, STD size_t) override { }
+
+	bool doIsEqual(const MemoryResource& other) const JLIBCXX_NOEXCEPT override
+	{
+		return this == &other;
+	}
+
+	Arena mArena;
+};
+
+struct PoolOptions
+{
+	// Blocks carved out of one upstream chunk at most. 0 selects the default.
+	STD size_t max_blocks_per_chunk = 0;
+
+	// Requests above this size go straight to upstream. 0 selects the default.
+	STD size_t largest_required_pool_block = 0;
+};
+
+/*
+* Pools of power of two sized blocks, from 8 bytes up to largest_required_pool_block.
+*
+* Each pool keeps an intrusive free list and carves new blocks out of chunks from
+* upstream, doubling the chunk size up to max_blocks_per_chunk. Larger or over-aligned
+* requests are forwarded to upstream as they are. release() gives every chunk back.
+* Not thread safe, see SynchronizedPoolResource.
+*/
+class UnsynchronizedPoolResource : public MemoryResource
+{
+private:
+
+	struct FreeBlock
+	{
+		FreeBlock* mNext;
+	};
+
+	// Sits in front of the blocks; its size keeps them max_align_t aligned.
+	struct alignas(STD max_align_t) ChunkHeader
+	{
+		ChunkHeader* mNext;
+		STD size_t mBytes;
+	};
+
+	struct Pool
+	{
+		FreeBlock* mFreeList = nullptr;
+		unsigned char* mCursor = nullptr;
+		unsigned char* mEnd = nullptr;
+		ChunkHeader* mChunks = nullptr;
+		STD size_t mNextBlocks = 0;
+	};
+
+public:
+
+	static constexpr STD size_t smallestBlock = 8;
+	static constexpr STD size_t defaultLargestBlock = 4096;
+	static constexpr STD size_t defaultMaxBlocksPerChunk = 1024;
+	static constexpr STD size_t firstChunkBlocks = 16;
+	static constexpr STD size_t maxPools = 24;
+
+	UnsynchronizedPoolResource() JLIBCXX_NOEXCEPT
+		: UnsynchronizedPoolResource(PoolOptions(), getDefaultResource())
+	{ }
+
+	explicit UnsynchronizedPoolResource(MemoryResource* upstream) JLIBCXX_NOEXCEPT
+		: UnsynchronizedPoolResource(PoolOptions(), upstream)
+	{ }
+
+	explicit UnsynchronizedPoolResource(const PoolOptions& options, MemoryResource* upstream = getDefaultResource()) JLIBCXX_NOEXCEPT
+		: mUpstream(upstream)
+	{
+		mOptions.max_blocks_per_chunk = options.max_blocks_per_chunk
+			? options.max_blocks_per_chunk
+			: defaultMaxBlocksPerChunk;
+
+		STD size_t largest = options.largest_required_pool_block
+			? options.largest_required_pool_block
+			: defaultLargestBlock;
+		mPoolCount = 1;
+		while (blockSizeOf(mPoolCount - 1) < largest && mPoolCount < maxPools)
+		{
+			++mPoolCount;
+		}
+
+		mOptions.largest_required_pool_block = blockSizeOf(mPoolCount - 1);
+	}
+
+	UnsynchronizedPoolResource(const UnsynchronizedPoolResource&) = delete;
+
+	UnsynchronizedPoolResource& operator=(const UnsynchronizedPoolResource&) = delete;
+
+	~UnsynchronizedPoolResource() override
+	{
+		release();
+	}
+
+	// Give the chunks of every pool back to upstream. Oversized blocks are not tracked.
+	void release() JLIBCXX_NOEXCEPT
+	{
+		for (STD size_t i = 0; i < mPoolCount; ++i)
+		{
+			Pool& pool = mPools[i];
+			while (pool.mChunks)
+			{
+				ChunkHeader* next = pool.mChunks->mNext;
+				mUpstream->deallocate(pool.mChunks, pool.mChunks->mBytes, alignof(ChunkHeader));
+				pool.mChunks = next;
+			}
+
+			pool = Pool();
+		}
+	}
+
+	NODISCARD MemoryResource* upstream_resource() const JLIBCXX_NOEXCEPT
+	{
+		return mUpstream;
+	}
+
+	NODISCARD PoolOptions options() const JLIBCXX_NOEXCEPT
+	{
+		return mOptions;
+	}
+
+protected:
+
+	void* doAllocate(const STD size_t bytes, const STD size_t alignment) override
+	{
+		const STD size_t index = poolIndex(bytes, alignment);
+		if (index == mPoolCount)
+		{
+			return mUpstream->allocate(bytes, alignment);
+		}
+
+		Pool& pool = mPools[index];
+		if (pool.mFreeList)
+		{
+			FreeBlock* block = pool.mFreeList;
+			pool.mFreeList = block->mNext;
+			return block;
+		}
+
+		const STD size_t blockSize = blockSizeOf(index);
+		if (pool.mCursor == pool.mEnd)
+		{
+			refill(pool, blockSize); // Throw
+		}
+
+		void* block = pool.mCursor;
+		pool.mCursor += blockSize;
+		return block;
+	}
+
+	void doDeallocate(void* ptr, const STD size_t bytes, const STD size_t alignment) override
+	{
+		const STD size_t index = poolIndex(bytes, alignment);
+		if (index == mPoolCount)
+		{
+			mUpstream->deallocate(ptr, bytes, alignment);
+			return;
+		}
+
+		FreeBlock* block = ::new(ptr) FreeBlock;
+		block->mNext = mPools[index].mFreeList;
+		mPools[index].mFreeList = block;
+	}
+
+	bool doIsEqual(const MemoryResource& other) const JLIBCXX_NOEXCEPT override
+	{
+		return this == &other;
+	}
+
+private:
+
+	static constexpr STD size_t blockSizeOf(const STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		return smallestBlock << index;
+	}
+
+	// Index of the smallest pool that fits, or mPoolCount if none does.
+	STD size_t poolIndex(const STD size_t bytes, const STD size_t alignment) const JLIBCXX_NOEXCEPT
+	{
+		if (alignment > alignof(STD max_align_t))
+		{
+			return mPoolCount;
+		}
+
+		// Blocks are aligned to their size, up to max_align_t.
+		const STD size_t needed = bytes > alignment ? bytes : alignment;
+		STD size_t index = 0;
+		while (index < mPoolCount && blockSizeOf(index) < needed)
+		{
+			++index;
+		}
+
+		return index;
+	}
+
+	void refill(Pool& pool, const STD size_t blockSize)
+	{
+		if (pool.mNextBlocks == 0)
+		{
+			pool.mNextBlocks = firstChunkBlocks;
+		}
+
+		STD size_t blocks = pool.mNextBlocks < mOptions.max_blocks_per_chunk
+			? pool.mNextBlocks
+			: mOptions.max_blocks_per_chunk;
+		if (blocks == 0)
+		{
+			blocks = 1;
+		}
+
+		const STD size_t bytes = sizeof(ChunkHeader) + blockSize * blocks;
+		void* memory = mUpstream->allocate(bytes, alignof(ChunkHeader)); // Throw
+		pool.mChunks = ::new(memory) ChunkHeader{ pool.mChunks, bytes };
+		pool.mCursor = static_cast<unsigned char*>(memory) + sizeof(ChunkHeader);
+		pool.mEnd = static_cast<unsigned char*>(memory) + bytes;
+		pool.mNextBlocks = blocks * 2;
+	}
+
+	MemoryResource* mUpstream;
+	PoolOptions mOptions;
+	STD size_t mPoolCount = 0;
+	Pool mPools[maxPools];
+};
+
+/*
+* UnsynchronizedPoolResource behind a mutex, may be shared between threads.
+*/
+class SynchronizedPoolResource : public UnsynchronizedPoolResource
+{
+public:
+
+	using UnsynchronizedPoolResource::UnsynchronizedPoolResource;
+
+	void release()
+	{
+		STD lock_guard<STD mutex> guard(mMutex);
+		UnsynchronizedPoolResource::release();
+	}
+
+private:
+
+	void* doAllocate(const STD size_t bytes, const STD size_t alignment) override
+	{
+		STD lock_guard<STD mutex> guard(mMutex);
+		return UnsynchronizedPoolResource::doAllocate(bytes, alignment);
+	}
+
+	void doDeallocate(void* ptr, const STD size_t bytes, const STD size_t alignment) override
+	{
+		STD lock_guard<STD mutex> guard(mMutex);
+		UnsynchronizedPoolResource::doDeallocate(ptr, bytes, alignment);
+	}
+
+	STD mutex mMutex;
+};
+
+template <typename T>
+using Vector = jstd::Vector<T, PolymorphicAllocator<T>>;
+
+template <typename T>
+using MyList = jstd::MyList<T, PolymorphicAllocator<T>>;
+
+template <typename T>
+using FList = jstd::FList<T, PolymorphicAllocator<T>>;
+
+} // namespace pmr
+
+template <typename T>
+struct is_default_construct_allocator<pmr::PolymorphicAllocator<T>> : STD true_type {};
+
+JSTD_END
+
+#endif // !MEMORY_RESOURCE
@@ -539,7 +539,7 @@ public:
 			{
 				auto& thisAlloc = this->getNodeAllocator();
 				auto& thatAlloc = other.getNodeAllocator();
-				if (Node_Alloc_Traits::always_equal_v() && thisAlloc != thatAlloc)
+				if (!Node_Alloc_Traits::always_equal_v() && thisAlloc != thatAlloc)
 				{
 					clear();
 				}
@@ -671,7 +671,7 @@ public:
 
 	NODISCARD allocator_type get_allocator() const noexcept
 	{
-		return allocator_type();
+		return allocator_type(this->getNodeAllocator());
 	}
 
 	reference front()
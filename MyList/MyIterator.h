@@ -9,6 +9,19 @@
 
 JSTD_START
 
+// The C++20 iterator_concept of Iterator, or its iterator_category if it has none.
+template <typename Iterator, typename = void>
+struct IteratorConcept
+{
+	using type = typename STD iterator_traits<Iterator>::iterator_category;
+};
+
+template <typename Iterator>
+struct IteratorConcept<Iterator, STD void_t<typename STD iterator_traits<Iterator>::iterator_concept>>
+{
+	using type = typename STD iterator_traits<Iterator>::iterator_concept;
+};
+
 template <typename Iterator, typename Container>
 class NormalIterator
 {
@@ -22,6 +35,7 @@ public:
 
 	using iterator_type = Iterator;
 	using iterator_category = typename traits::iterator_category;
+	using iterator_concept = typename IteratorConcept<Iterator>::type;
 	using value_type = typename traits::value_type;
 	using difference_type = typename traits::difference_type;
 	using reference = typename traits::reference;
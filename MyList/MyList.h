@@ -720,6 +720,7 @@ private:
 	* This constructor may throw an exception, due to the element-wise move.
 	*/
 	MyList(MyList&& other, const allocator_type& alloc, STD false_type)
+		: Base(Node_Alloc_Type(alloc))
 	{
 		if (this->getNodeAllocator() == other.getNodeAllocator())
 		{
@@ -728,7 +729,7 @@ private:
 		// Element-wise move.
 		else
 		{
-			insert(begin(), STD make_move_iterator(begin()), STD make_move_iterator(other.end()));
+			insert(begin(), STD make_move_iterator(other.begin()), STD make_move_iterator(other.end()));
 		}
 	}
 
@@ -1154,9 +1155,12 @@ public:
 		}
 
 		// Not necessary. This is an undefined behaviour.
-		if (get_allocator() != other.get_allocator())
+		if constexpr (!Node_Alloc_Traits::propagate_on_swap_v())
 		{
-			abort();
+			if (get_allocator() != other.get_allocator())
+			{
+				abort();
+			}
 		}
 
 		ListNodeBase::swapNodeBase(mImpl.mHeader, other.mImpl.mHeader);
@@ -0,0 +1,302 @@
+#pragma once
+#ifndef POOL_ALLOCATOR
+#define POOL_ALLOCATOR
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "Config.h"
+#include "Utility.h"
+
+JSTD_START
+
+/*
+* Minimal test-and-test-and-set lock, enough for the short critical sections of a pool.
+*/
+class SpinLock
+{
+public:
+
+	SpinLock() = default;
+
+	SpinLock(const SpinLock&) = delete;
+
+	SpinLock& operator=(const SpinLock&) = delete;
+
+	void lock() JLIBCXX_NOEXCEPT
+	{
+		while (mFlag.test_and_set(STD memory_order_acquire))
+		{
+			while (mFlag.test(STD memory_order_relaxed)) { }
+		}
+	}
+
+	NODISCARD bool try_lock() JLIBCXX_NOEXCEPT
+	{
+		return !mFlag.test_and_set(STD memory_order_acquire);
+	}
+
+	void unlock() JLIBCXX_NOEXCEPT
+	{
+		mFlag.clear(STD memory_order_release);
+	}
+
+private:
+
+	STD atomic_flag mFlag;
+};
+
+/*
+* Hands out blocks of BlockSize bytes aligned to BlockAlign.
+*
+* Blocks are carved on demand out of slabs that double in size up to maxSlabBlocks.
+* A freed block goes to an intrusive free list and is the first one to be reused,
+* so a churning list keeps hitting the same warm memory. Slabs are only released
+* by the destructor.
+*/
+template <STD size_t BlockSize, STD size_t BlockAlign>
+class FixedBlockPool
+{
+private:
+
+	struct FreeBlock
+	{
+		FreeBlock* mNext;
+	};
+
+	struct SlabHeader
+	{
+		SlabHeader* mNext;
+		STD size_t mBytes;
+	};
+
+public:
+
+	static constexpr STD size_t blockAlign = BlockAlign < alignof(FreeBlock) ? alignof(FreeBlock) : BlockAlign;
+
+	static constexpr STD size_t blockSize =
+		((BlockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : BlockSize) + blockAlign - 1) / blockAlign * blockAlign;
+
+	static constexpr STD size_t firstSlabBlocks = 32;
+	static constexpr STD size_t maxSlabBlocks = 4096;
+
+	FixedBlockPool() = default;
+
+	FixedBlockPool(const FixedBlockPool&) = delete;
+
+	FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+	~FixedBlockPool()
+	{
+		while (mSlabs)
+		{
+			SlabHeader* next = mSlabs->mNext;
+			deallocateSlab(mSlabs);
+			mSlabs = next;
+		}
+	}
+
+	/*
+	* The pool shared by every PoolAllocator with this block geometry.
+	* It is never destroyed, containers with static storage duration may still
+	* give their nodes back while other statics are torn down.
+	*/
+	static FixedBlockPool& shared()
+	{
+		alignas(FixedBlockPool) static unsigned char storage[sizeof(FixedBlockPool)];
+		static FixedBlockPool* const pool = ::new(static_cast<void*>(storage)) FixedBlockPool();
+		return *pool;
+	}
+
+	NODISCARD void* allocate()
+	{
+		STD lock_guard<SpinLock> guard(mLock);
+
+		if (mFreeList)
+		{
+			FreeBlock* block = mFreeList;
+			mFreeList = block->mNext;
+			return block;
+		}
+
+		if (mCursor == mSlabEnd)
+		{
+			refill(); // Throw
+		}
+
+		void* block = mCursor;
+		mCursor += blockSize;
+		return block;
+	}
+
+	void deallocate(void* ptr) JLIBCXX_NOEXCEPT
+	{
+		STD lock_guard<SpinLock> guard(mLock);
+
+		FreeBlock* block = ::new(ptr) FreeBlock;
+		block->mNext = mFreeList;
+		mFreeList = block;
+	}
+
+private:
+
+	// Room for the slab header, padded so the first block is aligned.
+	static constexpr STD size_t headerSize = (sizeof(SlabHeader) + blockAlign - 1) / blockAlign * blockAlign;
+
+	static constexpr bool overAligned = blockAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+	void refill()
+	{
+		const STD size_t bytes = headerSize + blockSize * mNextSlabBlocks;
+
+		void* memory;
+		if constexpr (overAligned)
+		{
+			memory = ::operator new(bytes, static_cast<STD align_val_t>(blockAlign));
+		}
+		else
+		{
+			memory = ::operator new(bytes);
+		}
+
+		SlabHeader* slab = ::new(memory) SlabHeader{ mSlabs, bytes };
+		mSlabs = slab;
+
+		mCursor = static_cast<unsigned char*>(memory) + headerSize;
+		mSlabEnd = static_cast<unsigned char*>(memory) + bytes;
+
+		if (mNextSlabBlocks < maxSlabBlocks)
+		{
+			mNextSlabBlocks *= 2;
+		}
+	}
+
+	static void deallocateSlab(SlabHeader* slab) JLIBCXX_NOEXCEPT
+	{
+		if constexpr (overAligned)
+		{
+			::operator delete(static_cast<void*>(slab), slab->mBytes, static_cast<STD align_val_t>(blockAlign));
+		}
+		else
+		{
+			::operator delete(static_cast<void*>(slab), slab->mBytes);
+		}
+	}
+
+	FreeBlock* mFreeList = nullptr;
+	SlabHeader* mSlabs = nullptr;
+	unsigned char* mCursor = nullptr;
+	unsigned char* mSlabEnd = nullptr;
+	STD size_t mNextSlabBlocks = firstSlabBlocks;
+	SpinLock mLock;
+};
+
+/*
+* Stateless allocator for node based containers, e.g. MyList<T, PoolAllocator<T>>.
+*
+* Single objects come from the FixedBlockPool of their size and alignment, so after
+* rebinding every ListNode<T> shares one free list. Arrays go to operator new.
+*/
+template <typename T>
+class PoolAllocator
+{
+public:
+
+	static_assert(!STD is_const_v<T>, "The C++ Standard forbids containers of const elements "
+									  "because allocator<const T> is ill-formed.");
+
+	using value_type = T;
+	using size_type = STD size_t;
+	using difference_type = STD ptrdiff_t;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+
+	using propagate_on_container_move_assignment = STD true_type;
+	using is_always_equal = STD true_type;
+
+	template <typename T2>
+	struct rebind
+	{
+		using other = PoolAllocator<T2>;
+	};
+
+	PoolAllocator() = default;
+
+	PoolAllocator(const PoolAllocator&) = default;
+
+	template <typename T2>
+	PoolAllocator(const PoolAllocator<T2>&) noexcept { }
+
+	PoolAllocator& operator=(const PoolAllocator&) = default;
+
+	~PoolAllocator() = default;
+
+	NODISCARD T* allocate(size_type n)
+	{
+		if (n == 1)
+		{
+			return static_cast<T*>(Pool::shared().allocate());
+		}
+
+		if (n > max_size())
+		{
+			throw STD bad_array_new_length();
+		}
+
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), static_cast<STD align_val_t>(alignof(T))));
+		}
+		else
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+	}
+
+	void deallocate(T* ptr, size_type n) JLIBCXX_NOEXCEPT
+	{
+		if (n == 1)
+		{
+			Pool::shared().deallocate(ptr);
+			return;
+		}
+
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			::operator delete(ptr, n * sizeof(T), static_cast<STD align_val_t>(alignof(T)));
+		}
+		else
+		{
+			::operator delete(ptr, n * sizeof(T));
+		}
+	}
+
+	NODISCARD size_type max_size() const JLIBCXX_NOEXCEPT
+	{
+		return STD numeric_limits<size_type>::max() / sizeof(T);
+	}
+
+	template <typename T2>
+	friend bool operator==(const PoolAllocator&, const PoolAllocator<T2>&) JLIBCXX_NOEXCEPT
+	{
+		return true;
+	}
+
+private:
+
+	using Pool = FixedBlockPool<sizeof(T), alignof(T)>;
+};
+
+// construct and destroy are the allocator_traits defaults.
+template <typename T>
+struct is_default_construct_allocator<PoolAllocator<T>> : STD true_type {};
+
+JSTD_END
+
+#endif // !POOL_ALLOCATOR
@@ -3,8 +3,11 @@
 #define PRITORITY_QUEUE
 
 #include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <memory>
 #include <iterator>
+#include <ranges>
 #include <type_traits>
 #include <initializer_list>
 #include <stdexcept>
@@ -14,7 +17,154 @@
 
 JSTD_START
 
-template <typename T, typename Container = STD vector<T>, typename Compare = STD less<typename Container::value_type>>
+/*
+* Heap layout policy for PriorityQueue: every node has Arity children, those of node i start
+* at Arity * i + 1. A wider heap is shallower, so a pop walks fewer levels, and the children
+* it compares at each level sit next to each other, often in one cache line. Large queues
+* usually do best with 4; 2 is the usual binary heap and uses the std algorithms.
+*
+* push expects the new element at last - 1, pop moves the top there.
+*/
+template <STD size_t Arity>
+struct DaryHeap
+{
+	static_assert(Arity >= 2, "jstd::DaryHeap needs at least two children per node.");
+
+	static constexpr STD size_t arity = Arity;
+
+	template <typename RandomIt, typename Compare>
+	static void push(RandomIt first, RandomIt last, Compare& comp)
+	{
+		if constexpr (Arity == 2)
+		{
+			STD push_heap(first, last, comp);
+		}
+		else
+		{
+			const auto len = last - first;
+			if (len > 1)
+			{
+				STD iter_value_t<RandomIt> value(STD move(*(last - 1)));
+				siftUp(first, len - 1, decltype(len)(0), value, comp);
+			}
+		}
+	}
+
+	template <typename RandomIt, typename Compare>
+	static void pop(RandomIt first, RandomIt last, Compare& comp)
+	{
+		if constexpr (Arity == 2)
+		{
+			STD pop_heap(first, last, comp);
+		}
+		else
+		{
+			const auto len = last - first;
+			if (len > 1)
+			{
+				STD iter_value_t<RandomIt> value(STD move(*(last - 1)));
+				*(last - 1) = STD move(*first);
+				siftDown(first, len - 1, decltype(len)(0), value, comp);
+			}
+		}
+	}
+
+	template <typename RandomIt, typename Compare>
+	static void make(RandomIt first, RandomIt last, Compare& comp)
+	{
+		if constexpr (Arity == 2)
+		{
+			STD make_heap(first, last, comp);
+		}
+		else
+		{
+			const auto len = last - first;
+			if (len < 2)
+			{
+				return;
+			}
+
+			// Every node from the last parent down to the root, bottom up.
+			for (auto parent = (len - 2) / static_cast<decltype(len)>(Arity) + 1; parent-- > 0;)
+			{
+				STD iter_value_t<RandomIt> value(STD move(first[parent]));
+				siftDown(first, len, parent, value, comp);
+			}
+		}
+	}
+
+private:
+
+	// Move the hole up from hole, but not past top, to where value fits.
+	template <typename RandomIt, typename Distance, typename Value, typename Compare>
+	static void siftUp(RandomIt first, Distance hole, Distance top, Value& value, Compare& comp)
+	{
+		while (hole > top)
+		{
+			const Distance parent = (hole - 1) / static_cast<Distance>(Arity);
+			if (!comp(first[parent], value))
+			{
+				break;
+			}
+
+			first[hole] = STD move(first[parent]);
+			hole = parent;
+		}
+
+		first[hole] = STD move(value);
+	}
+
+	/*
+	* Fill the hole with value among [first, first + len). Like the std algorithms the hole is
+	* first pulled down to a leaf along the largest children, without comparing against value,
+	* and value is then sifted up from there. A value taken from the bottom mostly belongs near
+	* the bottom again, so this saves a compare and a mispredicted branch per level.
+	*/
+	template <typename RandomIt, typename Distance, typename Value, typename Compare>
+	static void siftDown(RandomIt first, Distance len, Distance hole, Value& value, Compare& comp)
+	{
+		const Distance top = hole;
+		constexpr auto width = static_cast<Distance>(Arity);
+		while (true)
+		{
+			const Distance child = hole * width + 1;
+			if (child >= len)
+			{
+				break;
+			}
+
+			Distance best = child;
+			if (len - child >= width)
+			{
+				// A full set of children: a fixed trip count the compiler can unroll.
+				for (Distance i = 1; i < width; ++i)
+				{
+					best = comp(first[best], first[child + i]) ? child + i : best;
+				}
+			}
+			else
+			{
+				for (Distance i = child + 1; i < len; ++i)
+				{
+					best = comp(first[best], first[i]) ? i : best;
+				}
+			}
+
+			first[hole] = STD move(first[best]);
+			hole = best;
+		}
+
+		siftUp(first, hole, top, value, comp);
+	}
+};
+
+using BinaryHeap = DaryHeap<2>;
+
+/*
+* Max-heap adapter, like std::priority_queue. HeapPolicy picks the heap layout, see DaryHeap.
+*/
+template <typename T, typename Container = STD vector<T>, typename Compare = STD less<typename Container::value_type>,
+	typename HeapPolicy = BinaryHeap>
 class PriorityQueue
 {
 	static_assert(STD is_same_v<T, typename Container::value_type>, "value_type must be the same as the underlying container");
@@ -50,13 +200,13 @@ public:
 	explicit PriorityQueue(const Compare& compare, const Container& otherContainer)
 		: container(otherContainer), comp(compare) 
 	{
-		STD make_heap(otherContainer.begin(), otherContainer.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
-	explicit PriorityQueue(const Compare& compare, const Container&& otherContainer = Container())
+	explicit PriorityQueue(const Compare& compare, Container&& otherContainer = Container())
 		: container(STD move(otherContainer)), comp(compare)
 	{
-		STD make_heap(otherContainer.begin(), otherContainer.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
 	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
@@ -71,14 +221,14 @@ public:
 	PriorityQueue(const Compare& otherComp, const Container& otherContainer, const Alloc& alloc)
 		: container(otherContainer, alloc), comp(otherComp)
 	{
-		STD make_heap(container.begin(), container.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
 	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
 	PriorityQueue(const Compare& otherComp, Container&& otherContainer, const Alloc& alloc)
 		: container(STD move(otherContainer), alloc), comp(otherComp)
 	{
-		STD make_heap(container.begin(), container.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
 	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
@@ -94,7 +244,7 @@ public:
 		: container(otherContainer), comp(otherComp)
 	{
 		container.insert(container.end(), first, last);
-		STD make_heap(container.begin(), container.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
 	template <typename InputIterator>
@@ -102,7 +252,7 @@ public:
 		: container(STD move(otherContainer)), comp(otherComp)
 	{
 		container.insert(container.end(), first, last);
-		STD make_heap(container.begin(), container.end(), comp);
+		HeapPolicy::make(container.begin(), container.end(), comp);
 	}
 
 	~PriorityQueue() = default;
@@ -125,28 +275,71 @@ public:
 	void push(const value_type& value)
 	{
 		container.push_back(value);
-		STD push_heap(container.begin(), container.end(), comp);
+		HeapPolicy::push(container.begin(), container.end(), comp);
 	}
 
-	void push(const value_type&& value)
+	void push(value_type&& value)
 	{
 		container.push_back(STD move(value));
-		STD push_heap(container.begin(), container.end(), comp);
+		HeapPolicy::push(container.begin(), container.end(), comp);
 	}
 
 	template <typename... Args>
 	void emplace(Args&&... args)
 	{
 		container.emplace_back(STD forward<Args>(args)...);
-		STD push_heap(container.begin(), container.end(), comp);
+		HeapPolicy::push(container.begin(), container.end(), comp);
 	}
 
 	void pop()
 	{
-		STD pop_heap(container.begin(), container.end(), comp);
+		HeapPolicy::pop(container.begin(), container.end(), comp);
 		container.pop_back();
 	}
 
+	// Remove the top and hand it out by move, instead of copying top() before pop().
+	NODISCARD value_type pop_top()
+	{
+		HeapPolicy::pop(container.begin(), container.end(), comp);
+		value_type result(STD move(container.back()));
+		container.pop_back();
+		return result;
+	}
+
+	/*
+	* Append every element of range. A small batch is pushed one by one; once it is large
+	* enough that k pushes, O(k log n), would cost more than one O(n) heapify, the whole
+	* container is rebuilt instead.
+	*/
+	template <typename Range>
+	void push_range(Range&& range)
+	{
+		const size_type oldSize = container.size();
+		if constexpr (STD ranges::common_range<Range>)
+		{
+			container.insert(container.end(), STD ranges::begin(range), STD ranges::end(range));
+		}
+		else
+		{
+			for (auto&& element : range)
+			{
+				container.emplace_back(STD forward<decltype(element)>(element));
+			}
+		}
+
+		const size_type count = container.size() - oldSize;
+		if (count * static_cast<size_type>(STD bit_width(container.size())) >= container.size())
+		{
+			HeapPolicy::make(container.begin(), container.end(), comp);
+			return;
+		}
+
+		for (size_type i = oldSize + 1; i <= container.size(); ++i)
+		{
+			HeapPolicy::push(container.begin(), container.begin() + i, comp);
+		}
+	}
+
 	void swap(PriorityQueue& other) noexcept(STD conjunction_v<STD is_nothrow_swappable<Container>, STD is_nothrow_swappable<Compare>>)
 	{
 		using STD swap;
@@ -187,9 +380,9 @@ template
 >
 PriorityQueue(Compare, Container, Alloc) -> PriorityQueue<typename Container::value_type, Container, Compare>;
 
-template<typename T, typename Container, typename Compare> 
+template<typename T, typename Container, typename Compare, typename HeapPolicy> 
 inline typename STD enable_if_t<STD conjunction_v<STD is_swappable<Container>, STD is_swappable<Compare>>>
-swap(PriorityQueue<T, Container, Compare>& left, PriorityQueue<T, Container, Compare>& right) noexcept(noexcept(left.swap(right)))
+swap(PriorityQueue<T, Container, Compare, HeapPolicy>& left, PriorityQueue<T, Container, Compare, HeapPolicy>& right) noexcept(noexcept(left.swap(right)))
 {
 	left.swap(right);
 }
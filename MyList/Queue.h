@@ -1 +1,702 @@
 #pragma once
+#ifndef QUEUE
+#define QUEUE
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "AlignedAllocator.h"
+#include "Deque.h"
+#include "Healper.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+JSTD_START
+
+// FIFO adaptor, pushes at the back and pops at the front of Container.
+template <typename T, typename Container = Deque<T>>
+class Queue
+{
+	static_assert(STD is_same_v<T, typename Container::value_type>, "value_type must be the same as the underlying container");
+
+public:
+
+	using value_type = typename Container::value_type;
+	using reference = typename Container::reference;
+	using const_reference = typename Container::const_reference;
+	using size_type = typename Container::size_type;
+	using container_type = Container;
+
+private:
+
+	Container container;
+
+	template <typename Alloc>
+	using EnableIfUsesAllocator = STD enable_if_t<STD uses_allocator_v<Container, Alloc>>;
+
+public:
+
+	template
+	<
+		typename aContainer = Container,
+		typename Requires = STD enable_if_t<STD is_default_constructible_v<aContainer>>
+	>
+	Queue()
+		: container() { }
+
+	explicit Queue(const Container& otherContainer)
+		: container(otherContainer) { }
+
+	explicit Queue(Container&& otherContainer)
+		: container(STD move(otherContainer)) { }
+
+	template <typename InputIterator, typename = RequireInputIter<InputIterator>>
+	Queue(InputIterator first, InputIterator last)
+		: container(first, last) { }
+
+	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
+	explicit Queue(const Alloc& alloc)
+		: container(alloc) { }
+
+	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
+	Queue(const Container& otherContainer, const Alloc& alloc)
+		: container(otherContainer, alloc) { }
+
+	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
+	Queue(Container&& otherContainer, const Alloc& alloc)
+		: container(STD move(otherContainer), alloc) { }
+
+	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
+	Queue(const Queue& other, const Alloc& alloc)
+		: container(other.container, alloc) { }
+
+	template <typename Alloc, typename Requires = EnableIfUsesAllocator<Alloc>>
+	Queue(Queue&& other, const Alloc& alloc)
+		: container(STD move(other.container), alloc) { }
+
+	~Queue() = default;
+
+	NODISCARD bool empty() const
+	{
+		return container.empty();
+	}
+
+	NODISCARD size_type size() const
+	{
+		return container.size();
+	}
+
+	NODISCARD reference front()
+	{
+		return container.front();
+	}
+
+	NODISCARD const_reference front() const
+	{
+		return container.front();
+	}
+
+	NODISCARD reference back()
+	{
+		return container.back();
+	}
+
+	NODISCARD const_reference back() const
+	{
+		return container.back();
+	}
+
+	void push(const value_type& value)
+	{
+		container.push_back(value);
+	}
+
+	void push(value_type&& value)
+	{
+		container.push_back(STD move(value));
+	}
+
+	template <typename... Args>
+	decltype(auto) emplace(Args&&... args)
+	{
+		return container.emplace_back(STD forward<Args>(args)...);
+	}
+
+	void pop()
+	{
+		container.pop_front();
+	}
+
+	void swap(Queue& other) noexcept(STD is_nothrow_swappable_v<Container>)
+	{
+		using STD swap;
+		swap(container, other.container);
+	}
+
+	NODISCARD const Container& getContainer() const JLIBCXX_NOEXCEPT
+	{
+		return container;
+	}
+
+	template <typename T2, typename Container2>
+	friend bool operator==(const Queue<T2, Container2>& left, const Queue<T2, Container2>& right);
+
+	template <typename T2, typename Container2>
+	friend bool operator<(const Queue<T2, Container2>& left, const Queue<T2, Container2>& right);
+};
+
+template <typename T, typename Container>
+inline bool operator==(const Queue<T, Container>& left, const Queue<T, Container>& right)
+{
+	return left.container == right.container;
+}
+
+template <typename T, typename Container>
+inline bool operator!=(const Queue<T, Container>& left, const Queue<T, Container>& right)
+{
+	return !(left == right);
+}
+
+template <typename T, typename Container>
+inline bool operator<(const Queue<T, Container>& left, const Queue<T, Container>& right)
+{
+	return left.container < right.container;
+}
+
+template <typename Container, typename = RequireNotAllocator<Container>>
+Queue(Container) -> Queue<typename Container::value_type, Container>;
+
+template
+<
+	typename Container,
+	typename Alloc,
+	typename = RequireNotAllocator<Container>,
+	typename = RequireAllocator<Alloc>
+>
+Queue(Container, Alloc) -> Queue<typename Container::value_type, Container>;
+
+template
+<
+	typename InputIterator,
+	typename ValT = typename STD iterator_traits<InputIterator>::value_type,
+	typename = RequireInputIter<InputIterator>
+>
+Queue(InputIterator, InputIterator) -> Queue<ValT>;
+
+template<typename T, typename Container>
+inline typename STD enable_if_t<STD is_swappable_v<Container>>
+swap(Queue<T, Container>& left, Queue<T, Container>& right) noexcept(noexcept(left.swap(right)))
+{
+	left.swap(right);
+}
+
+/*
+* Bounded lock-free queue for exactly one producer thread and one consumer thread.
+*
+* The producer only writes mTail and the consumer only writes mHead, each on its own
+* cache line. Both keep a private copy of the other side's index and only reload it
+* (acquire) when the copy says the ring is full or empty, so in steady state a push or
+* pop touches no shared cache line except the slot itself. N must be a power of two.
+*
+* try_push* may only be called from the producer, try_pop* only from the consumer.
+*/
+template <typename T, STD size_t N>
+class SpscRing
+{
+	static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two.");
+
+public:
+
+	using value_type = T;
+	using size_type = STD size_t;
+
+	SpscRing() = default;
+
+	SpscRing(const SpscRing&) = delete;
+
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	~SpscRing() JLIBCXX_NOEXCEPT
+	{
+		const STD size_t tail = mTail.load(STD memory_order_relaxed);
+		for (STD size_t head = mHead.load(STD memory_order_relaxed); head != tail; ++head)
+		{
+			STD destroy_at(slot(head));
+		}
+	}
+
+	NODISCARD static constexpr size_type capacity() JLIBCXX_NOEXCEPT
+	{
+		return N;
+	}
+
+	template <typename... Args>
+	NODISCARD bool try_emplace(Args&&... args)
+	{
+		const STD size_t tail = mTail.load(STD memory_order_relaxed);
+		if (tail - mHeadCache == N)
+		{
+			mHeadCache = mHead.load(STD memory_order_acquire);
+			if (tail - mHeadCache == N)
+			{
+				return false;
+			}
+		}
+
+		STD construct_at(slot(tail), STD forward<Args>(args)...);
+		mTail.store(tail + 1, STD memory_order_release);
+		return true;
+	}
+
+	NODISCARD bool try_push(const T& value)
+	{
+		return try_emplace(value);
+	}
+
+	NODISCARD bool try_push(T&& value)
+	{
+		return try_emplace(STD move(value));
+	}
+
+	/*
+	* Push up to n elements from first with one release store, returns how many fit.
+	* If a copy throws, the elements before it are pushed.
+	*/
+	template <typename InputIterator>
+	size_type try_push_n(InputIterator first, const size_type n)
+	{
+		const STD size_t tail = mTail.load(STD memory_order_relaxed);
+		if (N - (tail - mHeadCache) < n)
+		{
+			mHeadCache = mHead.load(STD memory_order_acquire);
+		}
+
+		const size_type count = STD min(n, N - (tail - mHeadCache));
+		size_type done = 0;
+
+		TRY_START
+		for (; done < count; ++done, ++first)
+		{
+			STD construct_at(slot(tail + done), *first);
+		}
+		CATCH_ALL
+		mTail.store(tail + done, STD memory_order_release);
+		THROW_AGAIN
+		END_CATCH
+
+		mTail.store(tail + count, STD memory_order_release);
+		return count;
+	}
+
+	NODISCARD bool try_pop(T& out)
+	{
+		const STD size_t head = mHead.load(STD memory_order_relaxed);
+		if (head == mTailCache)
+		{
+			mTailCache = mTail.load(STD memory_order_acquire);
+			if (head == mTailCache)
+			{
+				return false;
+			}
+		}
+
+		T* element = slot(head);
+
+		TRY_START
+		out = STD move(*element);
+		CATCH_ALL
+		STD destroy_at(element);
+		mHead.store(head + 1, STD memory_order_release);
+		THROW_AGAIN
+		END_CATCH
+
+		STD destroy_at(element);
+		mHead.store(head + 1, STD memory_order_release);
+		return true;
+	}
+
+	/*
+	* Move up to n elements to out with one release store, returns how many were popped.
+	* If an assignment throws, that element is dropped and the ones before it stay popped.
+	*/
+	template <typename OutputIterator>
+	size_type try_pop_n(OutputIterator out, const size_type n)
+	{
+		const STD size_t head = mHead.load(STD memory_order_relaxed);
+		if (mTailCache - head < n)
+		{
+			mTailCache = mTail.load(STD memory_order_acquire);
+		}
+
+		const size_type count = STD min(n, mTailCache - head);
+		size_type done = 0;
+
+		TRY_START
+		for (; done < count; ++done, ++out)
+		{
+			T* element = slot(head + done);
+			*out = STD move(*element);
+			STD destroy_at(element);
+		}
+		CATCH_ALL
+		STD destroy_at(slot(head + done));
+		mHead.store(head + done + 1, STD memory_order_release);
+		THROW_AGAIN
+		END_CATCH
+
+		mHead.store(head + count, STD memory_order_release);
+		return count;
+	}
+
+	// Only a snapshot when the other thread is running.
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		const STD size_t head = mHead.load(STD memory_order_acquire);
+		return mTail.load(STD memory_order_acquire) - head;
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return size() == 0;
+	}
+
+private:
+
+	NODISCARD T* slot(const STD size_t index) JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<T*>(mBuffer + (index & (N - 1)) * sizeof(T)));
+	}
+
+	// Written by the consumer.
+	alignas(cacheLineSize) STD atomic<STD size_t> mHead{ 0 };
+	STD size_t mTailCache = 0;
+
+	// Written by the producer.
+	alignas(cacheLineSize) STD atomic<STD size_t> mTail{ 0 };
+	STD size_t mHeadCache = 0;
+
+	alignas(cacheLineSize) alignas(T) unsigned char mBuffer[sizeof(T) * N];
+};
+
+/*
+* Bounded lock-free queue for any number of producers and consumers (D. Vyukov's design).
+*
+* Every cell carries a sequence number that says whose turn it is: pos for the producer
+* of ticket pos, pos + 1 for its consumer, pos + capacity for the producer one lap later.
+* try_emplace and try_pop claim a ticket with one CAS and fail instead of waiting.
+* emplace and pop take a ticket unconditionally, spin a little for their turn and then
+* sleep on the cell's sequence with atomic wait. The fast path never notifies unless a
+* thread is actually asleep.
+*
+* A claimed ticket cannot be given back, so a T that may throw while constructed from
+* the arguments is built on the stack first and then moved in, which must not throw.
+*/
+template <typename T, typename Alloc = STD allocator<T>>
+class MpmcQueue
+{
+	static_assert(STD is_nothrow_move_constructible_v<T> && STD is_nothrow_destructible_v<T>,
+		"MpmcQueue needs a T that can be moved and destroyed without throwing.");
+
+public:
+
+	using value_type = T;
+	using size_type = STD size_t;
+	using allocator_type = Alloc;
+
+private:
+
+	struct Cell
+	{
+		alignas(cacheLineSize) STD atomic<STD size_t> mSequence;
+		alignas(T) unsigned char mStorage[sizeof(T)];
+
+		NODISCARD T* value() JLIBCXX_NOEXCEPT
+		{
+			return STD launder(reinterpret_cast<T*>(mStorage));
+		}
+	};
+
+	using Cell_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<Cell>::other;
+	using Cell_Alloc_Traits = MyAlloctTraits<Cell_Alloc_Type>;
+
+	static constexpr int spinLimit = 128;
+
+public:
+
+	// The capacity is rounded up to a power of two, and is at least 2.
+	explicit MpmcQueue(const size_type capacity, const allocator_type& alloc = allocator_type())
+		: mAlloc(alloc), mMask(STD bit_ceil(STD max<size_type>(capacity, 2)) - 1)
+	{
+		mCells = Cell_Alloc_Traits::allocate(mAlloc, mMask + 1);
+		for (STD size_t i = 0; i <= mMask; ++i)
+		{
+			STD construct_at(mCells + i);
+			mCells[i].mSequence.store(i, STD memory_order_relaxed);
+		}
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+	// No thread may use the queue any more.
+	~MpmcQueue() JLIBCXX_NOEXCEPT
+	{
+		const STD size_t last = mEnqueuePos.load(STD memory_order_relaxed);
+		for (STD size_t pos = mDequeuePos.load(STD memory_order_relaxed); pos != last; ++pos)
+		{
+			Cell& cell = cellAt(pos);
+			if (cell.mSequence.load(STD memory_order_relaxed) == pos + 1)
+			{
+				STD destroy_at(cell.value());
+			}
+		}
+
+		for (STD size_t i = 0; i <= mMask; ++i)
+		{
+			STD destroy_at(mCells + i);
+		}
+
+		Cell_Alloc_Traits::deallocate(mAlloc, mCells, mMask + 1);
+	}
+
+	NODISCARD size_type capacity() const JLIBCXX_NOEXCEPT
+	{
+		return mMask + 1;
+	}
+
+	// Only a snapshot when other threads are running.
+	NODISCARD size_type size() const JLIBCXX_NOEXCEPT
+	{
+		const STD size_t dequeuePos = mDequeuePos.load(STD memory_order_acquire);
+		const STD size_t enqueuePos = mEnqueuePos.load(STD memory_order_acquire);
+		return enqueuePos > dequeuePos ? STD min(enqueuePos - dequeuePos, capacity()) : 0;
+	}
+
+	NODISCARD bool empty() const JLIBCXX_NOEXCEPT
+	{
+		return size() == 0;
+	}
+
+	NODISCARD allocator_type get_allocator() const JLIBCXX_NOEXCEPT
+	{
+		return allocator_type(mAlloc);
+	}
+
+	// Returns false if the queue is full.
+	template <typename... Args>
+	NODISCARD bool try_emplace(Args&&... args)
+	{
+		if constexpr (STD is_nothrow_constructible_v<T, Args...>)
+		{
+			Cell* cell = claimForPush();
+			if (!cell)
+			{
+				return false;
+			}
+
+			STD construct_at(cell->value(), STD forward<Args>(args)...);
+			publish(*cell, cell->mSequence.load(STD memory_order_relaxed) + 1);
+			return true;
+		}
+		else
+		{
+			T temp(STD forward<Args>(args)...);
+			return try_emplace(STD move(temp));
+		}
+	}
+
+	NODISCARD bool try_push(const T& value)
+	{
+		return try_emplace(value);
+	}
+
+	NODISCARD bool try_push(T&& value)
+	{
+		return try_emplace(STD move(value));
+	}
+
+	// Returns false if the queue is empty.
+	NODISCARD bool try_pop(T& out)
+	{
+		STD size_t pos = mDequeuePos.load(STD memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &cellAt(pos);
+			const STD size_t sequence = cell->mSequence.load(STD memory_order_acquire);
+			const auto diff = static_cast<STD ptrdiff_t>(sequence - (pos + 1));
+			if (diff == 0)
+			{
+				if (mDequeuePos.compare_exchange_weak(pos, pos + 1, STD memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = mDequeuePos.load(STD memory_order_relaxed);
+			}
+		}
+
+		consume(*cell, pos, out);
+		return true;
+	}
+
+	// Waits while the queue is full.
+	template <typename... Args>
+	void emplace(Args&&... args)
+	{
+		if constexpr (STD is_nothrow_constructible_v<T, Args...>)
+		{
+			const STD size_t pos = mEnqueuePos.fetch_add(1, STD memory_order_relaxed);
+			Cell& cell = cellAt(pos);
+			waitForTurn(cell, pos);
+			STD construct_at(cell.value(), STD forward<Args>(args)...);
+			publish(cell, pos + 1);
+		}
+		else
+		{
+			T temp(STD forward<Args>(args)...);
+			emplace(STD move(temp));
+		}
+	}
+
+	void push(const T& value)
+	{
+		emplace(value);
+	}
+
+	void push(T&& value)
+	{
+		emplace(STD move(value));
+	}
+
+	// Waits while the queue is empty.
+	void pop(T& out)
+	{
+		const STD size_t pos = mDequeuePos.fetch_add(1, STD memory_order_relaxed);
+		Cell& cell = cellAt(pos);
+		waitForTurn(cell, pos + 1);
+		consume(cell, pos, out);
+	}
+
+private:
+
+	NODISCARD Cell& cellAt(const STD size_t pos) const JLIBCXX_NOEXCEPT
+	{
+		return mCells[pos & mMask];
+	}
+
+	Cell* claimForPush() JLIBCXX_NOEXCEPT
+	{
+		STD size_t pos = mEnqueuePos.load(STD memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cellAt(pos);
+			const STD size_t sequence = cell.mSequence.load(STD memory_order_acquire);
+			const auto diff = static_cast<STD ptrdiff_t>(sequence - pos);
+			if (diff == 0)
+			{
+				if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, STD memory_order_relaxed))
+				{
+					return &cell;
+				}
+			}
+			else if (diff < 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				pos = mEnqueuePos.load(STD memory_order_relaxed);
+			}
+		}
+	}
+
+	// The element is destroyed and the cell handed on even if the assignment throws.
+	void consume(Cell& cell, const STD size_t pos, T& out)
+	{
+		T* element = cell.value();
+
+		TRY_START
+		out = STD move(*element);
+		CATCH_ALL
+		STD destroy_at(element);
+		publish(cell, pos + mMask + 1);
+		THROW_AGAIN
+		END_CATCH
+
+		STD destroy_at(element);
+		publish(cell, pos + mMask + 1);
+	}
+
+	/*
+	* The store and the load of mSleepers are seq_cst, as are the increment and the
+	* re-check in waitForTurn, so either the sleeper sees the new sequence or we see the sleeper.
+	*/
+	void publish(Cell& cell, const STD size_t sequence) JLIBCXX_NOEXCEPT
+	{
+		cell.mSequence.store(sequence, STD memory_order_seq_cst);
+		if (mSleepers.load(STD memory_order_seq_cst) != 0)
+		{
+			cell.mSequence.notify_all();
+		}
+	}
+
+	void waitForTurn(Cell& cell, const STD size_t turn) JLIBCXX_NOEXCEPT
+	{
+		for (int i = 0; i < spinLimit; ++i)
+		{
+			if (cell.mSequence.load(STD memory_order_acquire) == turn)
+			{
+				return;
+			}
+
+			cpuRelax();
+		}
+
+		mSleepers.fetch_add(1, STD memory_order_seq_cst);
+		for (STD size_t sequence = cell.mSequence.load(STD memory_order_seq_cst); sequence != turn;
+			sequence = cell.mSequence.load(STD memory_order_acquire))
+		{
+			cell.mSequence.wait(sequence, STD memory_order_acquire);
+		}
+
+		mSleepers.fetch_sub(1, STD memory_order_relaxed);
+	}
+
+	static void cpuRelax() JLIBCXX_NOEXCEPT
+	{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#endif
+	}
+
+	// Read-only after construction.
+	Cell_Alloc_Type mAlloc;
+	const STD size_t mMask;
+	Cell* mCells = nullptr;
+
+	alignas(cacheLineSize) STD atomic<STD size_t> mEnqueuePos{ 0 };
+	alignas(cacheLineSize) STD atomic<STD size_t> mDequeuePos{ 0 };
+	alignas(cacheLineSize) STD atomic<STD size_t> mSleepers{ 0 };
+};
+
+JSTD_END
+
+#endif // !QUEUE
@@ -1 +1,1146 @@
 #pragma once
+#ifndef SHARE_POINTER
+#define SHARE_POINTER
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "Healper.h"
+#include "UniquePointer.h"
+#include "Utility.h"
+
+JSTD_START
+
+/*
+* How the reference counts of a control block are updated.
+* Atomic is safe to share between threads, Single is plain integers for objects
+* that never leave one thread.
+*/
+enum class LockPolicy
+{
+	Atomic,
+	Single
+};
+
+template <LockPolicy Lp>
+class RefCount;
+
+/*
+* Taking a reference only needs the count to stay positive, so increments are relaxed.
+* The decrement that reaches zero must see every write made through other owners
+* before the object is destroyed, hence acq_rel.
+*/
+template <>
+class RefCount<LockPolicy::Atomic>
+{
+public:
+
+	explicit RefCount(const long count) JLIBCXX_NOEXCEPT
+		: mCount(count)
+	{ }
+
+	void increment() JLIBCXX_NOEXCEPT
+	{
+		mCount.fetch_add(1, STD memory_order_relaxed);
+	}
+
+	// Returns the new count.
+	long decrement() JLIBCXX_NOEXCEPT
+	{
+		return mCount.fetch_sub(1, STD memory_order_acq_rel) - 1;
+	}
+
+	// For WeakPtr::lock, never brings a dead object back.
+	bool incrementIfNotZero() JLIBCXX_NOEXCEPT
+	{
+		long count = mCount.load(STD memory_order_relaxed);
+		do
+		{
+			if (count == 0)
+			{
+				return false;
+			}
+		} while (!mCount.compare_exchange_weak(count, count + 1, STD memory_order_acq_rel, STD memory_order_relaxed));
+
+		return true;
+	}
+
+	NODISCARD long get() const JLIBCXX_NOEXCEPT
+	{
+		return mCount.load(STD memory_order_relaxed);
+	}
+
+private:
+
+	STD atomic<long> mCount;
+};
+
+template <>
+class RefCount<LockPolicy::Single>
+{
+public:
+
+	explicit RefCount(const long count) JLIBCXX_NOEXCEPT
+		: mCount(count)
+	{ }
+
+	void increment() JLIBCXX_NOEXCEPT
+	{
+		++mCount;
+	}
+
+	long decrement() JLIBCXX_NOEXCEPT
+	{
+		return --mCount;
+	}
+
+	bool incrementIfNotZero() JLIBCXX_NOEXCEPT
+	{
+		if (mCount == 0)
+		{
+			return false;
+		}
+
+		++mCount;
+		return true;
+	}
+
+	NODISCARD long get() const JLIBCXX_NOEXCEPT
+	{
+		return mCount;
+	}
+
+private:
+
+	long mCount;
+};
+
+/*
+* Control block of a SharedPtr.
+*
+* mWeakCount is the number of WeakPtrs plus one while any SharedPtr is alive, so the last
+* SharedPtr and the last WeakPtr agree on who frees the block with a single decrement.
+* dispose ends the object, destroy frees the block itself.
+*/
+template <LockPolicy Lp>
+class ControlBlockBase
+{
+public:
+
+	ControlBlockBase() JLIBCXX_NOEXCEPT
+		: mUseCount(1), mWeakCount(1)
+	{ }
+
+	ControlBlockBase(const ControlBlockBase&) = delete;
+
+	ControlBlockBase& operator=(const ControlBlockBase&) = delete;
+
+	virtual ~ControlBlockBase() = default;
+
+	virtual void dispose() JLIBCXX_NOEXCEPT = 0;
+
+	virtual void destroy() JLIBCXX_NOEXCEPT = 0;
+
+	void addRef() JLIBCXX_NOEXCEPT
+	{
+		mUseCount.increment();
+	}
+
+	NODISCARD bool addRefLock() JLIBCXX_NOEXCEPT
+	{
+		return mUseCount.incrementIfNotZero();
+	}
+
+	void release() JLIBCXX_NOEXCEPT
+	{
+		if (mUseCount.decrement() == 0)
+		{
+			dispose();
+			weakRelease();
+		}
+	}
+
+	void weakAddRef() JLIBCXX_NOEXCEPT
+	{
+		mWeakCount.increment();
+	}
+
+	void weakRelease() JLIBCXX_NOEXCEPT
+	{
+		if (mWeakCount.decrement() == 0)
+		{
+			destroy();
+		}
+	}
+
+	NODISCARD long useCount() const JLIBCXX_NOEXCEPT
+	{
+		return mUseCount.get();
+	}
+
+private:
+
+	RefCount<Lp> mUseCount;
+	RefCount<Lp> mWeakCount;
+};
+
+/*
+* Control block for a pointer adopted with a deleter.
+* Empty deleters and allocators take no space.
+*/
+template <typename Ptr, typename D, typename Alloc, LockPolicy Lp>
+class ControlBlockPtr final : public ControlBlockBase<Lp>
+{
+public:
+
+	using Block_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<ControlBlockPtr>::other;
+	using Block_Alloc_Traits = MyAlloctTraits<Block_Alloc_Type>;
+
+	// deleter is left untouched if this throws, so the caller can still use it on ptr.
+	ControlBlockPtr(Ptr ptr, D& deleter, const Alloc& alloc)
+		JLIBCXX_NOEXCEPT_IF(noexcept(D(STD move_if_noexcept(deleter))))
+		: mData(OneThenVariadicArgsT{}, STD move_if_noexcept(deleter), OneThenVariadicArgsT{}, Block_Alloc_Type(alloc), ptr)
+	{ }
+
+	void dispose() JLIBCXX_NOEXCEPT override
+	{
+		mData.first()(mData.second.second);
+	}
+
+	void destroy() JLIBCXX_NOEXCEPT override
+	{
+		Block_Alloc_Type alloc(STD move(mData.second.first()));
+		STD destroy_at(this);
+		Block_Alloc_Traits::deallocate(alloc, this, 1);
+	}
+
+private:
+
+	CompressedPair<D, CompressedPair<Block_Alloc_Type, Ptr>> mData;
+};
+
+/*
+* Control block that also holds the object, the single allocation behind MakeShared.
+*/
+template <typename T, typename Alloc, LockPolicy Lp>
+class ControlBlockInplace final : public ControlBlockBase<Lp>
+{
+public:
+
+	using Block_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<ControlBlockInplace>::other;
+	using Block_Alloc_Traits = MyAlloctTraits<Block_Alloc_Type>;
+	using T_Alloc_Type = typename MyAlloctTraits<Alloc>:: template rebind<T>::other;
+	using T_Alloc_Traits = MyAlloctTraits<T_Alloc_Type>;
+
+	template <typename... Args>
+	ControlBlockInplace(const Alloc& alloc, Args&&... args)
+		: mData(OneThenVariadicArgsT{}, alloc)
+	{
+		T_Alloc_Type tAlloc(mData.first());
+		T_Alloc_Traits::construct(tAlloc, ptr(), STD forward<Args>(args)...);
+	}
+
+	void dispose() JLIBCXX_NOEXCEPT override
+	{
+		T_Alloc_Type tAlloc(mData.first());
+		T_Alloc_Traits::destroy(tAlloc, ptr());
+	}
+
+	void destroy() JLIBCXX_NOEXCEPT override
+	{
+		Block_Alloc_Type alloc(STD move(mData.first()));
+		STD destroy_at(this);
+		Block_Alloc_Traits::deallocate(alloc, this, 1);
+	}
+
+	NODISCARD T* ptr() JLIBCXX_NOEXCEPT
+	{
+		return STD launder(reinterpret_cast<T*>(mData.second.mBytes));
+	}
+
+private:
+
+	// Left uninitialized, the constructor builds T in it.
+	struct Storage
+	{
+		Storage() { }
+
+		alignas(T) unsigned char mBytes[sizeof(T)];
+	};
+
+	CompressedPair<Block_Alloc_Type, Storage> mData;
+};
+
+template <typename T, LockPolicy Lp>
+class BasicWeakPtr;
+
+template <typename T, LockPolicy Lp>
+class BasicSharedPtr;
+
+struct MakeSharedTag { };
+
+/*
+* Shared ownership of an object, the counts are kept according to Lp.
+* Use the SharedPtr alias.
+*/
+template <typename T, LockPolicy Lp = LockPolicy::Atomic>
+class BasicSharedPtr
+{
+public:
+
+	using element_type = STD remove_extent_t<T>;
+	using weak_type = BasicWeakPtr<T, Lp>;
+
+private:
+
+	using ControlBlock = ControlBlockBase<Lp>;
+
+	template <typename Y>
+	using Compatible = require<STD conditional_t<STD is_array_v<T>,
+		STD is_convertible<STD remove_extent_t<Y>(*)[], element_type(*)[]>,
+		STD is_convertible<Y*, element_type*>>>;
+
+	template <typename Y>
+	using DefaultDeleter = STD conditional_t<STD is_array_v<T>, DefaultDelete<element_type[]>, DefaultDelete<Y>>;
+
+	template <typename, LockPolicy>
+	friend class BasicSharedPtr;
+
+	template <typename, LockPolicy>
+	friend class BasicWeakPtr;
+
+	template <typename T2, LockPolicy Lp2, typename Alloc, typename... Args>
+	friend BasicSharedPtr<T2, Lp2> allocateSharedPolicy(const Alloc& alloc, Args&&... args);
+
+public:
+
+	constexpr BasicSharedPtr() JLIBCXX_NOEXCEPT
+		: mPtr(nullptr), mCtrl(nullptr)
+	{ }
+
+	constexpr BasicSharedPtr(STD nullptr_t) JLIBCXX_NOEXCEPT
+		: BasicSharedPtr()
+	{ }
+
+	template <typename Y, typename = Compatible<Y>>
+	explicit BasicSharedPtr(Y* ptr)
+		: BasicSharedPtr(ptr, DefaultDeleter<Y>())
+	{ }
+
+	template <typename Y, typename D, typename = Compatible<Y>>
+	BasicSharedPtr(Y* ptr, D deleter)
+		: BasicSharedPtr(ptr, STD move(deleter), STD allocator<char>())
+	{ }
+
+	// The control block comes from alloc. If that throws, deleter(ptr) is called.
+	template <typename Y, typename D, typename Alloc, typename = Compatible<Y>>
+	BasicSharedPtr(Y* ptr, D deleter, const Alloc& alloc)
+		: mPtr(ptr), mCtrl(nullptr)
+	{
+		TRY_START
+		mCtrl = createBlock(ptr, deleter, alloc);
+		CATCH_ALL
+		deleter(ptr);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	template <typename D>
+	BasicSharedPtr(STD nullptr_t, D deleter)
+		: BasicSharedPtr(static_cast<element_type*>(nullptr), STD move(deleter), STD allocator<char>())
+	{ }
+
+	template <typename D, typename Alloc>
+	BasicSharedPtr(STD nullptr_t, D deleter, const Alloc& alloc)
+		: BasicSharedPtr(static_cast<element_type*>(nullptr), STD move(deleter), alloc)
+	{ }
+
+	// Aliasing constructor, shares ownership with other but points to ptr.
+	template <typename Y>
+	BasicSharedPtr(const BasicSharedPtr<Y, Lp>& other, element_type* ptr) JLIBCXX_NOEXCEPT
+		: mPtr(ptr), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->addRef();
+		}
+	}
+
+	template <typename Y>
+	BasicSharedPtr(BasicSharedPtr<Y, Lp>&& other, element_type* ptr) JLIBCXX_NOEXCEPT
+		: mPtr(ptr), mCtrl(other.mCtrl)
+	{
+		other.mPtr = nullptr;
+		other.mCtrl = nullptr;
+	}
+
+	BasicSharedPtr(const BasicSharedPtr& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->addRef();
+		}
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicSharedPtr(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->addRef();
+		}
+	}
+
+	BasicSharedPtr(BasicSharedPtr&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		other.mPtr = nullptr;
+		other.mCtrl = nullptr;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicSharedPtr(BasicSharedPtr<Y, Lp>&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		other.mPtr = nullptr;
+		other.mCtrl = nullptr;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	explicit BasicSharedPtr(const BasicWeakPtr<Y, Lp>& other)
+		: mPtr(nullptr), mCtrl(nullptr)
+	{
+		if (!other.mCtrl || !other.mCtrl->addRefLock())
+		{
+			throw STD bad_weak_ptr();
+		}
+
+		mPtr = other.mPtr;
+		mCtrl = other.mCtrl;
+	}
+
+	template <typename Y, typename D, typename = Compatible<Y>,
+		typename = require<STD is_convertible<typename UniquePtr<Y, D>::pointer, element_type*>>>
+	BasicSharedPtr(UniquePtr<Y, D>&& other)
+		: BasicSharedPtr()
+	{
+		if (!other)
+		{
+			return;
+		}
+
+		using Deleter = STD conditional_t<STD is_reference_v<D>, STD reference_wrapper<STD remove_reference_t<D>>, D>;
+		// Copied unless moving cannot throw, so other keeps a usable deleter if this fails.
+		using Source = STD conditional_t<STD is_reference_v<D>, D, decltype(STD move_if_noexcept(other.get_deleter()))>;
+		auto* ptr = other.get();
+		Deleter deleter(static_cast<Source>(other.get_deleter()));
+		mCtrl = createBlock(ptr, deleter, STD allocator<char>());
+		mPtr = ptr;
+		other.release();
+	}
+
+	~BasicSharedPtr() JLIBCXX_NOEXCEPT
+	{
+		if (mCtrl)
+		{
+			mCtrl->release();
+		}
+	}
+
+	BasicSharedPtr& operator=(const BasicSharedPtr& other) JLIBCXX_NOEXCEPT
+	{
+		BasicSharedPtr(other).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicSharedPtr& operator=(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+	{
+		BasicSharedPtr(other).swap(*this);
+		return *this;
+	}
+
+	BasicSharedPtr& operator=(BasicSharedPtr&& other) JLIBCXX_NOEXCEPT
+	{
+		BasicSharedPtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicSharedPtr& operator=(BasicSharedPtr<Y, Lp>&& other) JLIBCXX_NOEXCEPT
+	{
+		BasicSharedPtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename D>
+	BasicSharedPtr& operator=(UniquePtr<Y, D>&& other)
+	{
+		BasicSharedPtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	void reset() JLIBCXX_NOEXCEPT
+	{
+		BasicSharedPtr().swap(*this);
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	void reset(Y* ptr)
+	{
+		BasicSharedPtr(ptr).swap(*this);
+	}
+
+	template <typename Y, typename D, typename = Compatible<Y>>
+	void reset(Y* ptr, D deleter)
+	{
+		BasicSharedPtr(ptr, STD move(deleter)).swap(*this);
+	}
+
+	template <typename Y, typename D, typename Alloc, typename = Compatible<Y>>
+	void reset(Y* ptr, D deleter, const Alloc& alloc)
+	{
+		BasicSharedPtr(ptr, STD move(deleter), alloc).swap(*this);
+	}
+
+	void swap(BasicSharedPtr& other) JLIBCXX_NOEXCEPT
+	{
+		STD swap(mPtr, other.mPtr);
+		STD swap(mCtrl, other.mCtrl);
+	}
+
+	NODISCARD element_type* get() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr;
+	}
+
+	template <typename Y = T, typename = STD enable_if_t<!STD is_void_v<Y> && !STD is_array_v<Y>>>
+	NODISCARD Y& operator*() const JLIBCXX_NOEXCEPT
+	{
+		return *mPtr;
+	}
+
+	template <typename Y = T, typename = STD enable_if_t<!STD is_array_v<Y>>>
+	NODISCARD element_type* operator->() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr;
+	}
+
+	template <typename Y = T, typename = STD enable_if_t<STD is_array_v<Y>>>
+	NODISCARD element_type& operator[](const STD ptrdiff_t index) const JLIBCXX_NOEXCEPT
+	{
+		return mPtr[index];
+	}
+
+	NODISCARD long use_count() const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl ? mCtrl->useCount() : 0;
+	}
+
+	explicit operator bool() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr != nullptr;
+	}
+
+	// Ordering by control block, what std::owner_less uses.
+	template <typename Y>
+	NODISCARD bool owner_before(const BasicSharedPtr<Y, Lp>& other) const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl < other.mCtrl;
+	}
+
+	template <typename Y>
+	NODISCARD bool owner_before(const BasicWeakPtr<Y, Lp>& other) const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl < other.mCtrl;
+	}
+
+private:
+
+	BasicSharedPtr(MakeSharedTag, element_type* ptr, ControlBlock* ctrl) JLIBCXX_NOEXCEPT
+		: mPtr(ptr), mCtrl(ctrl)
+	{ }
+
+	/*
+	* On failure nothing is left allocated and deleter still holds its state, the caller
+	* decides whether ptr is deleted.
+	*/
+	template <typename Y, typename D, typename Alloc>
+	static ControlBlock* createBlock(Y* ptr, D& deleter, const Alloc& alloc)
+	{
+		using Block = ControlBlockPtr<Y*, D, Alloc, Lp>;
+		typename Block::Block_Alloc_Type blockAlloc(alloc);
+
+		Block* block = Block::Block_Alloc_Traits::allocate(blockAlloc, 1);
+
+		TRY_START
+		return STD construct_at(block, ptr, deleter, alloc);
+		CATCH_ALL
+		Block::Block_Alloc_Traits::deallocate(blockAlloc, block, 1);
+		THROW_AGAIN
+		END_CATCH
+	}
+
+	element_type* mPtr;
+	ControlBlock* mCtrl;
+};
+
+/*
+* Non-owning reference to an object managed by BasicSharedPtr.
+* Use the WeakPtr alias.
+*/
+template <typename T, LockPolicy Lp = LockPolicy::Atomic>
+class BasicWeakPtr
+{
+public:
+
+	using element_type = STD remove_extent_t<T>;
+
+private:
+
+	using ControlBlock = ControlBlockBase<Lp>;
+
+	template <typename Y>
+	using Compatible = require<STD is_convertible<Y*, T*>>;
+
+	template <typename, LockPolicy>
+	friend class BasicSharedPtr;
+
+	template <typename, LockPolicy>
+	friend class BasicWeakPtr;
+
+public:
+
+	constexpr BasicWeakPtr() JLIBCXX_NOEXCEPT
+		: mPtr(nullptr), mCtrl(nullptr)
+	{ }
+
+	BasicWeakPtr(const BasicWeakPtr& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->weakAddRef();
+		}
+	}
+
+	// Converting from a WeakPtr<Y> needs a live Y to adjust the pointer, so lock first.
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr(const BasicWeakPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.lock().get()), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->weakAddRef();
+		}
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		if (mCtrl)
+		{
+			mCtrl->weakAddRef();
+		}
+	}
+
+	BasicWeakPtr(BasicWeakPtr&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr), mCtrl(other.mCtrl)
+	{
+		other.mPtr = nullptr;
+		other.mCtrl = nullptr;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr(BasicWeakPtr<Y, Lp>&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.lock().get()), mCtrl(other.mCtrl)
+	{
+		other.mPtr = nullptr;
+		other.mCtrl = nullptr;
+	}
+
+	~BasicWeakPtr() JLIBCXX_NOEXCEPT
+	{
+		if (mCtrl)
+		{
+			mCtrl->weakRelease();
+		}
+	}
+
+	BasicWeakPtr& operator=(const BasicWeakPtr& other) JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr(other).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr& operator=(const BasicWeakPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr(other).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr& operator=(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr(other).swap(*this);
+		return *this;
+	}
+
+	BasicWeakPtr& operator=(BasicWeakPtr&& other) JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = Compatible<Y>>
+	BasicWeakPtr& operator=(BasicWeakPtr<Y, Lp>&& other) JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	void reset() JLIBCXX_NOEXCEPT
+	{
+		BasicWeakPtr().swap(*this);
+	}
+
+	void swap(BasicWeakPtr& other) JLIBCXX_NOEXCEPT
+	{
+		STD swap(mPtr, other.mPtr);
+		STD swap(mCtrl, other.mCtrl);
+	}
+
+	NODISCARD long use_count() const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl ? mCtrl->useCount() : 0;
+	}
+
+	NODISCARD bool expired() const JLIBCXX_NOEXCEPT
+	{
+		return use_count() == 0;
+	}
+
+	// An empty pointer if the object is already gone.
+	NODISCARD BasicSharedPtr<T, Lp> lock() const JLIBCXX_NOEXCEPT
+	{
+		if (mCtrl && mCtrl->addRefLock())
+		{
+			return BasicSharedPtr<T, Lp>(MakeSharedTag{}, mPtr, mCtrl);
+		}
+
+		return BasicSharedPtr<T, Lp>();
+	}
+
+	template <typename Y>
+	NODISCARD bool owner_before(const BasicSharedPtr<Y, Lp>& other) const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl < other.mCtrl;
+	}
+
+	template <typename Y>
+	NODISCARD bool owner_before(const BasicWeakPtr<Y, Lp>& other) const JLIBCXX_NOEXCEPT
+	{
+		return mCtrl < other.mCtrl;
+	}
+
+private:
+
+	element_type* mPtr;
+	ControlBlock* mCtrl;
+};
+
+template <typename T>
+using SharedPtr = BasicSharedPtr<T, LockPolicy::Atomic>;
+
+template <typename T>
+using WeakPtr = BasicWeakPtr<T, LockPolicy::Atomic>;
+
+// SharedPtr with plain integer counts. Copies must not be used from more than one thread.
+template <typename T>
+using LocalSharedPtr = BasicSharedPtr<T, LockPolicy::Single>;
+
+template <typename T>
+using LocalWeakPtr = BasicWeakPtr<T, LockPolicy::Single>;
+
+// Object and control block in one allocation from alloc.
+template <typename T, LockPolicy Lp, typename Alloc, typename... Args>
+inline BasicSharedPtr<T, Lp> allocateSharedPolicy(const Alloc& alloc, Args&&... args)
+{
+	static_assert(!STD is_array_v<T>, "AllocateShared does not support arrays.");
+
+	using Block = ControlBlockInplace<T, Alloc, Lp>;
+	typename Block::Block_Alloc_Type blockAlloc(alloc);
+	Block* block = Block::Block_Alloc_Traits::allocate(blockAlloc, 1);
+
+	TRY_START
+	STD construct_at(block, alloc, STD forward<Args>(args)...);
+	CATCH_ALL
+	Block::Block_Alloc_Traits::deallocate(blockAlloc, block, 1);
+	THROW_AGAIN
+	END_CATCH
+
+	return BasicSharedPtr<T, Lp>(MakeSharedTag{}, block->ptr(), block);
+}
+
+template <typename T, typename Alloc, typename... Args>
+inline SharedPtr<T> AllocateShared(const Alloc& alloc, Args&&... args)
+{
+	return allocateSharedPolicy<T, LockPolicy::Atomic>(alloc, STD forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+inline SharedPtr<T> MakeShared(Args&&... args)
+{
+	return allocateSharedPolicy<T, LockPolicy::Atomic>(STD allocator<T>(), STD forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+inline LocalSharedPtr<T> AllocateLocalShared(const Alloc& alloc, Args&&... args)
+{
+	return allocateSharedPolicy<T, LockPolicy::Single>(alloc, STD forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+inline LocalSharedPtr<T> MakeLocalShared(Args&&... args)
+{
+	return allocateSharedPolicy<T, LockPolicy::Single>(STD allocator<T>(), STD forward<Args>(args)...);
+}
+
+template <typename T, typename Y, LockPolicy Lp>
+inline BasicSharedPtr<T, Lp> StaticPointerCast(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+{
+	return BasicSharedPtr<T, Lp>(other, static_cast<typename BasicSharedPtr<T, Lp>::element_type*>(other.get()));
+}
+
+template <typename T, typename Y, LockPolicy Lp>
+inline BasicSharedPtr<T, Lp> ConstPointerCast(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+{
+	return BasicSharedPtr<T, Lp>(other, const_cast<typename BasicSharedPtr<T, Lp>::element_type*>(other.get()));
+}
+
+template <typename T, typename Y, LockPolicy Lp>
+inline BasicSharedPtr<T, Lp> DynamicPointerCast(const BasicSharedPtr<Y, Lp>& other) JLIBCXX_NOEXCEPT
+{
+	if (auto* ptr = dynamic_cast<typename BasicSharedPtr<T, Lp>::element_type*>(other.get()))
+	{
+		return BasicSharedPtr<T, Lp>(other, ptr);
+	}
+
+	return BasicSharedPtr<T, Lp>();
+}
+
+template <typename T, typename U, LockPolicy Lp>
+inline bool operator==(const BasicSharedPtr<T, Lp>& left, const BasicSharedPtr<U, Lp>& right) JLIBCXX_NOEXCEPT
+{
+	return left.get() == right.get();
+}
+
+template <typename T, typename U, LockPolicy Lp>
+inline bool operator!=(const BasicSharedPtr<T, Lp>& left, const BasicSharedPtr<U, Lp>& right) JLIBCXX_NOEXCEPT
+{
+	return left.get() != right.get();
+}
+
+template <typename T, typename U, LockPolicy Lp>
+inline bool operator<(const BasicSharedPtr<T, Lp>& left, const BasicSharedPtr<U, Lp>& right) JLIBCXX_NOEXCEPT
+{
+	return STD less<>()(left.get(), right.get());
+}
+
+template <typename T, LockPolicy Lp>
+inline bool operator==(const BasicSharedPtr<T, Lp>& left, STD nullptr_t) JLIBCXX_NOEXCEPT
+{
+	return !left;
+}
+
+template <typename T, LockPolicy Lp>
+inline bool operator!=(const BasicSharedPtr<T, Lp>& left, STD nullptr_t) JLIBCXX_NOEXCEPT
+{
+	return static_cast<bool>(left);
+}
+
+template <typename T, LockPolicy Lp>
+inline void swap(BasicSharedPtr<T, Lp>& left, BasicSharedPtr<T, Lp>& right) JLIBCXX_NOEXCEPT
+{
+	left.swap(right);
+}
+
+template <typename T, LockPolicy Lp>
+inline void swap(BasicWeakPtr<T, Lp>& left, BasicWeakPtr<T, Lp>& right) JLIBCXX_NOEXCEPT
+{
+	left.swap(right);
+}
+
+// Two raw pointers, relocating never touches the counts.
+template <typename T, LockPolicy Lp>
+struct is_trivially_relocatable<BasicSharedPtr<T, Lp>> : STD true_type {};
+
+template <typename T, LockPolicy Lp>
+struct is_trivially_relocatable<BasicWeakPtr<T, Lp>> : STD true_type {};
+
+/*
+* How IntrusivePtr takes and drops a reference, by default through the
+* members addRef() and release() of T. Specialise it for types with other names.
+*/
+template <typename T>
+struct IntrusivePtrTraits
+{
+	static void addRef(T* ptr) JLIBCXX_NOEXCEPT
+	{
+		ptr->addRef();
+	}
+
+	static void release(T* ptr) JLIBCXX_NOEXCEPT
+	{
+		ptr->release();
+	}
+};
+
+/*
+* Base class that gives Derived an embedded count for IntrusivePtr.
+* The object deletes itself when the last reference goes.
+*/
+template <typename Derived, LockPolicy Lp = LockPolicy::Atomic>
+class IntrusiveRefCounter
+{
+public:
+
+	IntrusiveRefCounter() JLIBCXX_NOEXCEPT
+		: mRefCount(0)
+	{ }
+
+	// A copy is a new object, with its own references.
+	IntrusiveRefCounter(const IntrusiveRefCounter&) JLIBCXX_NOEXCEPT
+		: mRefCount(0)
+	{ }
+
+	IntrusiveRefCounter& operator=(const IntrusiveRefCounter&) JLIBCXX_NOEXCEPT
+	{
+		return *this;
+	}
+
+	void addRef() const JLIBCXX_NOEXCEPT
+	{
+		mRefCount.increment();
+	}
+
+	void release() const JLIBCXX_NOEXCEPT
+	{
+		if (mRefCount.decrement() == 0)
+		{
+			delete static_cast<const Derived*>(this);
+		}
+	}
+
+	NODISCARD long use_count() const JLIBCXX_NOEXCEPT
+	{
+		return mRefCount.get();
+	}
+
+protected:
+
+	~IntrusiveRefCounter() = default;
+
+private:
+
+	mutable RefCount<Lp> mRefCount;
+};
+
+/*
+* Shared ownership through a count stored in the object itself.
+* No control block, a copy is one pointer and one addRef.
+*/
+template <typename T>
+class IntrusivePtr
+{
+private:
+
+	using Traits = IntrusivePtrTraits<T>;
+
+	template <typename>
+	friend class IntrusivePtr;
+
+public:
+
+	using element_type = T;
+
+	constexpr IntrusivePtr() JLIBCXX_NOEXCEPT
+		: mPtr(nullptr)
+	{ }
+
+	constexpr IntrusivePtr(STD nullptr_t) JLIBCXX_NOEXCEPT
+		: mPtr(nullptr)
+	{ }
+
+	// With addRef == false the pointer adopts a reference the caller already holds.
+	explicit IntrusivePtr(T* ptr, const bool addRef = true) JLIBCXX_NOEXCEPT
+		: mPtr(ptr)
+	{
+		if (mPtr && addRef)
+		{
+			Traits::addRef(mPtr);
+		}
+	}
+
+	IntrusivePtr(const IntrusivePtr& other) JLIBCXX_NOEXCEPT
+		: IntrusivePtr(other.mPtr)
+	{ }
+
+	template <typename Y, typename = require<STD is_convertible<Y*, T*>>>
+	IntrusivePtr(const IntrusivePtr<Y>& other) JLIBCXX_NOEXCEPT
+		: IntrusivePtr(other.mPtr)
+	{ }
+
+	IntrusivePtr(IntrusivePtr&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr)
+	{
+		other.mPtr = nullptr;
+	}
+
+	template <typename Y, typename = require<STD is_convertible<Y*, T*>>>
+	IntrusivePtr(IntrusivePtr<Y>&& other) JLIBCXX_NOEXCEPT
+		: mPtr(other.mPtr)
+	{
+		other.mPtr = nullptr;
+	}
+
+	~IntrusivePtr() JLIBCXX_NOEXCEPT
+	{
+		if (mPtr)
+		{
+			Traits::release(mPtr);
+		}
+	}
+
+	IntrusivePtr& operator=(const IntrusivePtr& other) JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr(other).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = require<STD is_convertible<Y*, T*>>>
+	IntrusivePtr& operator=(const IntrusivePtr<Y>& other) JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr(other).swap(*this);
+		return *this;
+	}
+
+	IntrusivePtr& operator=(IntrusivePtr&& other) JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	template <typename Y, typename = require<STD is_convertible<Y*, T*>>>
+	IntrusivePtr& operator=(IntrusivePtr<Y>&& other) JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr(STD move(other)).swap(*this);
+		return *this;
+	}
+
+	void reset() JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr().swap(*this);
+	}
+
+	void reset(T* ptr, const bool addRef = true) JLIBCXX_NOEXCEPT
+	{
+		IntrusivePtr(ptr, addRef).swap(*this);
+	}
+
+	// Give up ownership without dropping the reference.
+	NODISCARD T* detach() JLIBCXX_NOEXCEPT
+	{
+		T* ptr = mPtr;
+		mPtr = nullptr;
+		return ptr;
+	}
+
+	void swap(IntrusivePtr& other) JLIBCXX_NOEXCEPT
+	{
+		STD swap(mPtr, other.mPtr);
+	}
+
+	NODISCARD T* get() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr;
+	}
+
+	NODISCARD T& operator*() const JLIBCXX_NOEXCEPT
+	{
+		return *mPtr;
+	}
+
+	NODISCARD T* operator->() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr;
+	}
+
+	explicit operator bool() const JLIBCXX_NOEXCEPT
+	{
+		return mPtr != nullptr;
+	}
+
+private:
+
+	T* mPtr;
+};
+
+template <typename T, typename... Args>
+inline IntrusivePtr<T> MakeIntrusive(Args&&... args)
+{
+	return IntrusivePtr<T>(new T(STD forward<Args>(args)...));
+}
+
+template <typename T, typename U>
+inline bool operator==(const IntrusivePtr<T>& left, const IntrusivePtr<U>& right) JLIBCXX_NOEXCEPT
+{
+	return left.get() == right.get();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const IntrusivePtr<T>& left, const IntrusivePtr<U>& right) JLIBCXX_NOEXCEPT
+{
+	return left.get() != right.get();
+}
+
+template <typename T, typename U>
+inline bool operator<(const IntrusivePtr<T>& left, const IntrusivePtr<U>& right) JLIBCXX_NOEXCEPT
+{
+	return STD less<>()(left.get(), right.get());
+}
+
+template <typename T>
+inline bool operator==(const IntrusivePtr<T>& left, STD nullptr_t) JLIBCXX_NOEXCEPT
+{
+	return !left;
+}
+
+template <typename T>
+inline bool operator!=(const IntrusivePtr<T>& left, STD nullptr_t) JLIBCXX_NOEXCEPT
+{
+	return static_cast<bool>(left);
+}
+
+template <typename T>
+inline void swap(IntrusivePtr<T>& left, IntrusivePtr<T>& right) JLIBCXX_NOEXCEPT
+{
+	left.swap(right);
+}
+
+template <typename T>
+struct is_trivially_relocatable<IntrusivePtr<T>> : STD true_type {};
+
+JSTD_END
+
+#endif // !SHARE_POINTER
@@ -0,0 +1,319 @@
+#pragma once
+#ifndef SMALL_VECTOR
+#define SMALL_VECTOR
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "Config.h"
+#include "Healper.h"
+#include "Utility.h"
+#include "Vector.h"
+
+JSTD_START
+
+/*
+* Storage base of SmallVector. Keeps the VectorImplData three pointer layout of
+* VectorBase, but the pointers refer to an inline buffer of N elements until the
+* vector outgrows it. Only then the allocator is used.
+*/
+template <typename T, STD size_t N, typename Alloc>
+class SmallVectorBase : public VectorBase<T, Alloc>
+{
+private:
+
+	static_assert(N > 0, "jstd::SmallVector needs an inline capacity of at least one element.");
+
+	using Base = VectorBase<T, Alloc>;
+	using VectorImplData = typename Base::VectorImplData;
+
+public:
+
+	using T_Alloc_Type = typename Base::T_Alloc_Type;
+	using pointer = typename Base::pointer;
+	using allocator_type = typename Base::allocator_type;
+
+	static_assert(STD is_pointer_v<pointer>, "jstd::SmallVector needs an allocator with raw pointers.");
+
+private:
+
+	using Alloc_Traits = MyAlloctTraits<T_Alloc_Type>;
+
+public:
+
+	using Base::mImpl;
+	using Base::getTAllocator;
+
+	SmallVectorBase() JLIBCXX_NOEXCEPT_IF(STD is_nothrow_default_constructible_v<T_Alloc_Type>)
+		: Base()
+	{
+		resetToInline();
+	}
+
+	SmallVectorBase(const allocator_type& alloc) JLIBCXX_NOEXCEPT
+		: Base(alloc)
+	{
+		resetToInline();
+	}
+
+	SmallVectorBase(const STD size_t n)
+		: Base()
+	{
+		resetToInline();
+		createStorage(n);
+	}
+
+	SmallVectorBase(const STD size_t n, const allocator_type& alloc)
+		: Base(alloc)
+	{
+		resetToInline();
+		createStorage(n);
+	}
+
+	SmallVectorBase(SmallVectorBase&& other) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_move_constructible_v<T>)
+		: Base(T_Alloc_Type(STD move(other.getTAllocator())))
+	{
+		resetToInline();
+
+		// A heap buffer is stolen, inline elements have to be moved one by one.
+		if (!other.isInline())
+		{
+			mImpl.copyPointerFrom(other.mImpl);
+			other.resetToInline();
+			return;
+		}
+
+		mImpl.mLast = relocateRange(other.mImpl.mStart, other.mImpl.mLast, mImpl.mStart, getTAllocator());
+		other.mImpl.mLast = other.mImpl.mStart;
+	}
+
+	~SmallVectorBase() JLIBCXX_NOEXCEPT
+	{
+		deallocateWholeArray();
+
+		// Nothing left for VectorBase to release.
+		mImpl.mStart = pointer();
+		mImpl.mLast = pointer();
+		mImpl.mEnd = pointer();
+	}
+
+	NODISCARD pointer inlineData() JLIBCXX_NOEXCEPT
+	{
+		return reinterpret_cast<pointer>(mInline);
+	}
+
+	NODISCARD bool isInline() const JLIBCXX_NOEXCEPT
+	{
+		return mImpl.mStart == reinterpret_cast<const T*>(mInline);
+	}
+
+	// Hand out the inline buffer while it is free, so shrinking back below N stops using the heap.
+	pointer allocateArray(STD size_t n)
+	{
+		if (n <= N && !isInline())
+		{
+			return inlineData();
+		}
+
+		return Base::allocateArray(n);
+	}
+
+	void deallocateArray(pointer ptr, STD size_t n) JLIBCXX_NOEXCEPT
+	{
+		if (ptr != inlineData())
+		{
+			Base::deallocateArray(ptr, n);
+		}
+	}
+
+	void deallocateWholeArray() JLIBCXX_NOEXCEPT
+	{
+		deallocateArray(mImpl.mStart, mImpl.mEnd - mImpl.mStart);
+	}
+
+	/*
+	* Exchange the storage, not the allocators.
+	* Heap buffers are swapped by pointer. Elements in an inline buffer are moved,
+	* if that throws both vectors stay valid but their contents are unspecified.
+	*/
+	void swapStorage(SmallVectorBase& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return;
+		}
+
+		if (!isInline() && !other.isInline())
+		{
+			mImpl.swapData(other.mImpl);
+			return;
+		}
+
+		if (isInline() && other.isInline())
+		{
+			SmallVectorBase* shorter = this;
+			SmallVectorBase* longer = STD addressof(other);
+			if (shorter->size() > longer->size())
+			{
+				STD swap(shorter, longer);
+			}
+
+			const pointer common = longer->mImpl.mStart + shorter->size();
+			if constexpr (is_bitwise_relocatable_v<T, T_Alloc_Type>)
+			{
+				swapBytes(shorter->mImpl.mStart, longer->mImpl.mStart, shorter->size() * sizeof(T));
+			}
+			else
+			{
+				STD swap_ranges(shorter->mImpl.mStart, shorter->mImpl.mLast, longer->mImpl.mStart);
+			}
+
+			shorter->mImpl.mLast = relocateRange(
+				common, longer->mImpl.mLast, shorter->mImpl.mLast, shorter->getTAllocator());
+			longer->mImpl.mLast = common;
+			return;
+		}
+
+		// One side is inline, the other one on the heap.
+		SmallVectorBase& inlineSide = isInline() ? *this : other;
+		SmallVectorBase& heapSide = isInline() ? other : *this;
+
+		VectorImplData heap;
+		heap.copyPointerFrom(heapSide.mImpl);
+		heapSide.resetToInline();
+
+		TRY_START
+		heapSide.mImpl.mLast = relocateRange(
+			inlineSide.mImpl.mStart, inlineSide.mImpl.mLast, heapSide.mImpl.mStart, heapSide.getTAllocator());
+		CATCH_ALL
+		heapSide.mImpl.copyPointerFrom(heap);
+		THROW_AGAIN
+		END_CATCH
+
+		inlineSide.mImpl.copyPointerFrom(heap);
+	}
+
+protected:
+
+	void createStorage(STD size_t n)
+	{
+		if (n <= N)
+		{
+			resetToInline();
+			return;
+		}
+
+		mImpl.mStart = Base::allocateArray(n);
+		mImpl.mLast = mImpl.mStart;
+		mImpl.mEnd = mImpl.mStart + n;
+	}
+
+private:
+
+	NODISCARD STD size_t size() const JLIBCXX_NOEXCEPT
+	{
+		return static_cast<STD size_t>(mImpl.mLast - mImpl.mStart);
+	}
+
+	void resetToInline() JLIBCXX_NOEXCEPT
+	{
+		mImpl.mStart = inlineData();
+		mImpl.mLast = mImpl.mStart;
+		mImpl.mEnd = mImpl.mStart + N;
+	}
+
+	/*
+	* Move [first, last) to the uninitialized storage at dest and destroy the source.
+	* A single memmove for trivially relocatable types. If a move throws, the source is intact.
+	*/
+	static pointer relocateRange(pointer first, pointer last, pointer dest, T_Alloc_Type& alloc)
+	{
+		if constexpr (is_nothrow_relocatable_v<T, T_Alloc_Type>)
+		{
+			return myRelocate(first, last, dest, alloc);
+		}
+		else
+		{
+			const pointer result = uninitializedMoveAllocated(first, last, dest, alloc);
+			myDestroy(first, last, alloc);
+			return result;
+		}
+	}
+
+	alignas(T) unsigned char mInline[sizeof(T) * N];
+};
+
+/*
+* A Vector that keeps up to N elements inside the object and only allocates
+* when it grows past that. Same interface as jstd::Vector.
+*/
+template <typename T, STD size_t N, typename Alloc = STD allocator<T>>
+class SmallVector : public Vector<T, Alloc, SmallVectorBase<T, N, Alloc>>
+{
+private:
+
+	using Base = Vector<T, Alloc, SmallVectorBase<T, N, Alloc>>;
+
+public:
+
+	using typename Base::size_type;
+
+	using Base::Base;
+
+	SmallVector() = default;
+
+	SmallVector(const SmallVector&) = default;
+
+	SmallVector(SmallVector&&) = default;
+
+	~SmallVector() = default;
+
+	SmallVector& operator=(const SmallVector&) = default;
+
+	SmallVector& operator=(SmallVector&&) = default;
+
+	using Base::operator=;
+
+	NODISCARD static constexpr size_type inline_capacity() JLIBCXX_NOEXCEPT
+	{
+		return N;
+	}
+
+	// True while the elements live in the inline buffer.
+	NODISCARD bool is_inline() const JLIBCXX_NOEXCEPT
+	{
+		return this->isInline();
+	}
+
+	// The inline buffer cannot shrink. A heap buffer returns to it when the elements fit.
+	void shrink_to_fit()
+	{
+		if (is_inline())
+		{
+			return;
+		}
+
+		Base::shrink_to_fit();
+		if (is_inline())
+		{
+			this->mImpl.mEnd = this->mImpl.mStart + N;
+		}
+	}
+
+	void swap(SmallVector& other)
+	{
+		Base::swap(other);
+	}
+};
+
+template <typename T, STD size_t N, typename Alloc>
+inline void swap(SmallVector<T, N, Alloc>& left, SmallVector<T, N, Alloc>& right)
+{
+	left.swap(right);
+}
+
+JSTD_END
+
+#endif // !SMALL_VECTOR
@@ -1,29 +1,58 @@
 #ifndef APT_A2_TST
 #define APT_A2_TST
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
 #include <string>
-
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // !NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/*
+ * Nodes live in one array owned by the tree and refer to each other
+ * by 32-bit index, not by pointer. Index 0 is never a real node, so
+ * a link of 0 means "none", like a null pointer.
+ */
 template <typename CharT, typename Traits = ::std::char_traits<CharT>>
 class TstNode final
 {
-private:
-
-	using Self = TstNode<CharT, Traits>;
-
 public:
 
-	explicit TstNode(const char& letter) noexcept
+	using index_type = ::std::uint32_t;
+
+	TstNode() noexcept
 		: mLeft(),
 		mMid(),
 		mRight(),
 		mParent(),
-		mLetter(letter),
+		mLetter(),
 		mEndWord(false)
 	{ }
 
-	TstNode(const char& letter, Self* const parent) noexcept
+	explicit TstNode(const CharT& letter, const index_type parent = 0) noexcept
 		: mLeft(),
 		mMid(),
 		mRight(),
@@ -34,13 +63,13 @@ public:
 
 	~TstNode() noexcept = default;
 
-	Self* mLeft;
+	index_type mLeft;
 
-	Self* mMid;
+	index_type mMid;
 
-	Self* mRight;
+	index_type mRight;
 
-	Self* mParent;
+	index_type mParent;
 
 	CharT mLetter;
 
@@ -49,15 +78,25 @@ public:
 };
 
 
+template <typename CharT, typename Traits = ::std::char_traits<CharT>>
+class MappedTst;
+
+
 template <typename CharT, typename Traits = ::std::char_traits<CharT>>
 class TernarySearchTree final
 {
 private:
 
+	friend class MappedTst<CharT, Traits>;
+
 	using Node = TstNode<CharT, Traits>;
 
+	using index_type = typename Node::index_type;
+
+	static constexpr index_type nullIndex = 0;
+
 public:
-	
+
 	using node_type = Node;
 	using value_type = CharT;
 	using reference = CharT&;
@@ -68,38 +107,273 @@ public:
 	using difference_type = ::std::ptrdiff_t;
 	using string_type = ::std::basic_string<CharT, Traits>;
 	using traits = Traits;
+	using score_type = ::std::uint32_t;
+
+	/*
+	 * Walks every word under a prefix in sorted order, one at a time.
+	 *
+	 * It keeps only the current node and one word buffer, and follows
+	 * the parent links to move on, so producing a result allocates
+	 * nothing once the buffer has grown to the longest word.
+	 *
+	 * The reference stays valid until the next increment. Changing the
+	 * tree invalidates the iterator.
+	 */
+	class prefix_iterator
+	{
+	public:
 
+		using iterator_category = ::std::input_iterator_tag;
+		using value_type = string_type;
+		using difference_type = ::std::ptrdiff_t;
+		using reference = const string_type&;
+		using pointer = const string_type*;
 
-	TernarySearchTree() noexcept
-		: mRoot(), mSize()
-	{ }
+		prefix_iterator() noexcept
+			: mNodes(), mCur(), mStop(), mWord()
+		{ }
 
-	template <typename InputIterator>
-	TernarySearchTree(InputIterator first, InputIterator last)
-		: mRoot(), mSize()
+		reference operator*() const noexcept
+		{
+			return mWord;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &mWord;
+		}
+
+		prefix_iterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+
+		friend bool operator==(const prefix_iterator& left, const prefix_iterator& right) noexcept
+		{
+			return left.mCur == right.mCur;
+		}
+
+		friend bool operator!=(const prefix_iterator& left, const prefix_iterator& right) noexcept
+		{
+			return !(left == right);
+		}
+
+	private:
+
+		friend class TernarySearchTree;
+
+		/*
+		 * Start at stop, the node of the last prefix letter, or at
+		 * root when stop is null. word holds the prefix.
+		 */
+		prefix_iterator(
+			const Node* nodes,
+			const index_type root,
+			const index_type stop,
+			string_type word
+		)
+			: mNodes(nodes), mCur(), mStop(stop), mWord(::std::move(word))
+		{
+			if (mStop)
+			{
+				if (node(mStop).mEndWord)
+				{
+					mCur = mStop;
+				}
+				else
+				{
+					const index_type mid = node(mStop).mMid;
+					mWord.push_back(node(mid).mLetter);
+					mCur = descendFirst(mid);
+				}
+			}
+			else if (root)
+			{
+				mWord.push_back(node(root).mLetter);
+				mCur = descendFirst(root);
+			}
+		}
+
+		const Node& node(const index_type index) const noexcept
+		{
+			return mNodes[index];
+		}
+
+		/*
+		 * The first word in the subtree of cur, whose letter is
+		 * already the last one in mWord.
+		 */
+		index_type descendFirst(index_type cur)
+		{
+			while (true)
+			{
+				while (node(cur).mLeft)
+				{
+					cur = node(cur).mLeft;
+					mWord.back() = node(cur).mLetter;
+				}
+
+				if (node(cur).mEndWord)
+				{
+					return cur;
+				}
+
+				// Not a word, so it must have a middle child.
+				cur = node(cur).mMid;
+				mWord.push_back(node(cur).mLetter);
+			}
+		}
+
+		/*
+		 * In order, a node comes after its left subtree and before its
+		 * middle and right subtrees. Climbing out of a middle child
+		 * drops a letter, out of a left or right child swaps it.
+		 */
+		void advance()
+		{
+			index_type cur = mCur;
+
+			if (node(cur).mMid)
+			{
+				const index_type mid = node(cur).mMid;
+				mWord.push_back(node(mid).mLetter);
+				mCur = descendFirst(mid);
+				return;
+			}
+
+			while (true)
+			{
+				if (cur == mStop)
+				{
+					mCur = nullIndex;
+					return;
+				}
+
+				if (node(cur).mRight)
+				{
+					const index_type right = node(cur).mRight;
+					mWord.back() = node(right).mLetter;
+					mCur = descendFirst(right);
+					return;
+				}
+
+				// Everything under cur is done, climb until a parent still has work.
+				bool climbing = true;
+
+				while (climbing)
+				{
+					const index_type parent = node(cur).mParent;
+
+					if (!parent)
+					{
+						mCur = nullIndex;
+						return;
+					}
+
+					const Node& up = node(parent);
+
+					if (cur == up.mLeft)
+					{
+						mWord.back() = up.mLetter;
+
+						if (up.mEndWord)
+						{
+							mCur = parent;
+						}
+						else
+						{
+							mWord.push_back(node(up.mMid).mLetter);
+							mCur = descendFirst(up.mMid);
+						}
+
+						return;
+					}
+
+					if (cur == up.mMid)
+					{
+						// The right subtree of parent is next.
+						mWord.pop_back();
+						climbing = false;
+					}
+					else
+					{
+						mWord.back() = up.mLetter;
+					}
+
+					cur = parent;
+				}
+			}
+		}
+
+		const Node* mNodes;
+
+		index_type mCur;
+
+		index_type mStop;
+
+		string_type mWord;
+	};
+
+	// What prefixSearch returns, for use in a range-based for.
+	class prefix_range
 	{
-		try
+	public:
+
+		prefix_iterator begin() const
 		{
-			buildDictionary(first, last);
+			return mFirst;
 		}
-		catch (...)
+
+		prefix_iterator end() const noexcept
 		{
-			deleteSubTree(mRoot);
-			throw;
+			return prefix_iterator();
 		}
+
+	private:
+
+		friend class TernarySearchTree;
+
+		explicit prefix_range(prefix_iterator first)
+			: mFirst(::std::move(first))
+		{ }
+
+		prefix_iterator mFirst;
+	};
+
+
+	TernarySearchTree() noexcept
+		: mNodes(), mScores(), mRoot(), mFreeList(), mSize(), mScored(false)
+	{ }
+
+	template <typename InputIterator>
+	TernarySearchTree(InputIterator first, InputIterator last)
+		: mNodes(), mScores(), mRoot(), mFreeList(), mSize(), mScored(false)
+	{
+		buildDictionary(first, last);
 	}
 
 	TernarySearchTree(TernarySearchTree&& other) noexcept
-		: mRoot(other.mRoot), mSize(other.mSize)
+		: mNodes(::std::move(other.mNodes)),
+		mScores(::std::move(other.mScores)),
+		mRoot(other.mRoot),
+		mFreeList(other.mFreeList),
+		mSize(other.mSize),
+		mScored(other.mScored)
 	{
-		other.mRoot = nullptr;
+		other.mNodes.clear();
+		other.mScores.clear();
+		other.mRoot = nullIndex;
+		other.mFreeList = nullIndex;
 		other.mSize = 0;
+		other.mScored = false;
 	}
 
-	~TernarySearchTree() noexcept
-	{
-		deleteSubTree(mRoot);
-	}
+	/*
+	 * All nodes go with the one array that holds them,
+	 * no walk over the tree is needed.
+	 */
+	~TernarySearchTree() noexcept = default;
 
 private:
 
@@ -125,7 +399,7 @@ private:
 
 	static bool charGreaterThan(const CharT& left, const CharT& right)
 	{
-		/* 
+		/*
 		 * NOLINT(readability-suspicious-call-argument).
 		 *
 		 * We need to reverse the argument in here.
@@ -149,61 +423,315 @@ public:
 		}
 	}
 
+	/*
+	 * Add the words in [first, last) in an order that keeps the tree
+	 * balanced. buildDictionary adds them in input order, so sorted
+	 * input turns every left/right chain into a list.
+	 *
+	 * The words are sorted if needed, then the median goes in first,
+	 * and the same is done for each half.
+	 *
+	 * With more than one thread, and an empty tree, each first letter
+	 * gets its own subtree, built on its own thread and grafted under
+	 * the letter afterwards. threads of 0 means one per hardware thread.
+	 */
+	template <typename InputIterator>
+	void buildBalanced(InputIterator first, InputIterator last, unsigned threads = 1)
+	{
+		::std::vector<string_type> words;
+
+		for (; first != last; ++first)
+		{
+			words.emplace_back(*first);
+		}
+
+		if (!::std::is_sorted(words.begin(), words.end()))
+		{
+			::std::sort(words.begin(), words.end());
+		}
+
+		words.erase(::std::unique(words.begin(), words.end()), words.end());
+
+		if (threads == 0)
+		{
+			threads = ::std::max(1U, ::std::thread::hardware_concurrency());
+		}
+
+		if (threads > 1 && empty())
+		{
+			buildParallel(words, threads);
+		}
+		else
+		{
+			addMedians(words, 0, words.size(), 0);
+		}
+	}
+
 	bool contain(const string_type& string) const noexcept
 	{
 		return contain(string.c_str(), string.length());
 	}
 
 	bool contain(
-		const value_type* string, 
+		const value_type* string,
 		const size_type length
 	) const noexcept
 	{
-		Node* cur = mRoot;
-		bool end = false;
-		bool ret = false;
-		size_type i = 0;
+		const index_type found = findNode(string, length);
+
+		return found && mNodes[found].mEndWord;
+	}
+
+	/*
+	 * Every stored word that starts with prefix, in sorted order.
+	 * An empty prefix gives the whole dictionary.
+	 */
+	prefix_range prefixSearch(const string_type& prefix) const
+	{
+		return prefixSearch(prefix.c_str(), prefix.length());
+	}
+
+	prefix_range prefixSearch(const CharT* prefix, const size_type length) const
+	{
+		return makePrefixRange(mNodes.data(), mRoot, prefix, length);
+	}
+
+	/*
+	 * Call sink(word, score) for the k best scored words under prefix,
+	 * highest score first.
+	 *
+	 * Every node caches the best score in its subtree, so the search
+	 * always expands the most promising subtree and stops after k
+	 * words, without walking everything under the prefix. Words added
+	 * without a score count as 0.
+	 */
+	template <typename Sink>
+	void topK(const string_type& prefix, const size_type k, Sink&& sink) const
+	{
+		topK(prefix.c_str(), prefix.length(), k, sink);
+	}
 
-		while (cur && !end)
+	template <typename Sink>
+	void topK(const CharT* prefix, const size_type length, const size_type k, Sink&& sink) const
+	{
+		::std::vector<Candidate> heap;
+		index_type stop = nullIndex;
+
+		if (length == 0)
+		{
+			pushSubtree(heap, mRoot);
+		}
+		else
 		{
-			if (charLessThan(string[i], cur->mLetter))
+			stop = findNode(prefix, length);
+
+			if (stop)
 			{
-				cur = cur->mLeft;
+				if (mNodes[stop].mEndWord)
+				{
+					pushCandidate(heap, Candidate{ scoreOf(stop), stop, true });
+				}
+
+				pushSubtree(heap, mNodes[stop].mMid);
 			}
-			else if (charGreaterThan(string[i], cur->mLetter))
+		}
+
+		string_type word;
+		size_type found = 0;
+
+		while (found < k && !heap.empty())
+		{
+			::std::pop_heap(heap.begin(), heap.end(), candidateLess);
+			const Candidate best = heap.back();
+			heap.pop_back();
+
+			if (best.mWord)
 			{
-				cur = cur->mRight;
+				spellWord(prefix, length, stop, best.mNode, word);
+				sink(static_cast<const string_type&>(word), best.mBound);
+				++found;
 			}
 			else
 			{
-				if (i == length - 1)
-				{
-					end = true;
-				}
-				else
+				const Node& node = mNodes[best.mNode];
+
+				if (node.mEndWord)
 				{
-					cur = cur->mMid;
-					++i;
+					pushCandidate(heap, Candidate{ scoreOf(best.mNode), best.mNode, true });
 				}
+
+				pushSubtree(heap, node.mLeft);
+				pushSubtree(heap, node.mMid);
+				pushSubtree(heap, node.mRight);
 			}
 		}
+	}
+
+	bool addWord(const string_type& word)
+	{
+		return addWord(word.c_str(), word.length());
+	}
+
+	bool addWord(const CharT* word)
+	{
+		return addWord(word, traits::length(word));
+	}
+
+	/*
+	 * Call sink(candidate, distance) for every stored word within
+	 * maxDistance edits (Levenshtein) of word, in sorted order.
+	 *
+	 * The walk keeps one DP row per depth. Words sharing a prefix share
+	 * its rows, and a middle subtree is skipped as soon as the smallest
+	 * value in its row is over the bound. Rows and the candidate buffer
+	 * only grow when the walk first reaches a new depth, so visiting a
+	 * node allocates nothing.
+	 */
+	template <typename Sink>
+	void fuzzySearch(const string_type& word, const size_type maxDistance, Sink&& sink) const
+	{
+		fuzzySearch(word.c_str(), word.length(), maxDistance, sink);
+	}
 
-		if (cur)
+	template <typename Sink>
+	void fuzzySearch(
+		const CharT* word,
+		const size_type length,
+		const size_type maxDistance,
+		Sink&& sink
+	) const
+	{
+		if (mRoot)
 		{
-			ret = cur->mEndWord;
+			const size_type width = length + 1;
+			::std::vector<size_type> rows(width * (length + 2));
+			string_type candidate;
+			candidate.reserve(length + 1);
+
+			for (size_type i = 0; i < width; ++i)
+			{
+				rows[i] = i;
+			}
+
+			const Node* const nodes = mNodes.data();
+			index_type cur = mRoot;
+			FuzzyStage stage = FuzzyStage::arrived;
+
+			// Letters before cur, which is also the row cur reads from.
+			size_type depth = 0;
+
+			while (cur)
+			{
+				const Node& node = nodes[cur];
+				index_type next = nullIndex;
+
+				if (stage == FuzzyStage::arrived && node.mLeft)
+				{
+					next = node.mLeft;
+				}
+				else if (stage == FuzzyStage::arrived || stage == FuzzyStage::fromLeft)
+				{
+					if (rows.size() < width * (depth + 2))
+					{
+						rows.resize(width * (depth + 2));
+					}
+
+					const size_type* const above = rows.data() + width * depth;
+					size_type* const row = rows.data() + width * (depth + 1);
+					const size_type best = fuzzyRow(above, row, word, length, node.mLetter);
+
+					candidate.resize(depth);
+					candidate.push_back(node.mLetter);
+
+					if (node.mEndWord && row[length] <= maxDistance)
+					{
+						sink(static_cast<const string_type&>(candidate), row[length]);
+					}
+
+					if (node.mMid && best <= maxDistance)
+					{
+						next = node.mMid;
+						++depth;
+					}
+					else
+					{
+						next = node.mRight;
+					}
+				}
+				else if (stage == FuzzyStage::fromMid)
+				{
+					next = node.mRight;
+				}
+
+				if (next)
+				{
+					cur = next;
+					stage = FuzzyStage::arrived;
+				}
+				else
+				{
+					const index_type parent = node.mParent;
+
+					if (parent)
+					{
+						const Node& up = nodes[parent];
+
+						if (cur == up.mLeft)
+						{
+							stage = FuzzyStage::fromLeft;
+						}
+						else if (cur == up.mMid)
+						{
+							stage = FuzzyStage::fromMid;
+							--depth;
+						}
+						else
+						{
+							stage = FuzzyStage::fromRight;
+						}
+					}
+
+					cur = parent;
+				}
+			}
 		}
+	}
 
-		return ret;
+	/*
+	 * Add word with a score for topK, or set the score of a word that
+	 * is already there. Returns true if the word is new.
+	 *
+	 * Not an addWord overload: addWord("apple", 10) would pick the one
+	 * taking a length.
+	 *
+	 * The first scored word turns on a score table parallel to the
+	 * nodes; trees that never use scores do not pay for it.
+	 */
+	bool addScoredWord(const string_type& word, const score_type score)
+	{
+		return addScoredWord(word.c_str(), word.length(), score);
 	}
 
-	bool addWord(const string_type& word)
+	bool addScoredWord(const CharT* word, const score_type score)
 	{
-		return addWord(word.c_str(), word.length());
+		return addScoredWord(word, traits::length(word), score);
 	}
 
-	bool addWord(const CharT* word)
+	bool addScoredWord(const CharT* word, const size_type length, const score_type score)
 	{
-		return addWord(word, ::std::strlen(word));
+		bool ret = false;
+
+		if (length != 0)
+		{
+			enableScores();
+			ret = addWord(word, length);
+
+			const index_type found = findNode(word, length);
+			mScores[found].mScore = score;
+			refreshScoresUpwards(found);
+		}
+
+		return ret;
 	}
 
 	bool addWord(const CharT* word, const size_type length)
@@ -220,34 +748,40 @@ public:
 			}
 			else
 			{
-				Node* cur = mRoot;
+				index_type cur = mRoot;
 
 				try
 				{
 					size_type i = 0;
 					bool done = false;
 
+					/*
+					 * New nodes may move the array, so links are
+					 * written through an index after the node exists.
+					 */
 					while (i < length && !done)
 					{
-						if (charLessThan(word[i], cur->mLetter))
+						if (charLessThan(word[i], mNodes[cur].mLetter))
 						{
-							if (!cur->mLeft)
+							if (!mNodes[cur].mLeft)
 							{
-								cur->mLeft = new Node(word[i], cur);
+								const index_type child = newNode(word[i], cur);
+								mNodes[cur].mLeft = child;
 							}
 
-							cur = cur->mLeft;
+							cur = mNodes[cur].mLeft;
 						}
 						else if (
-							charGreaterThan(word[i], cur->mLetter)
+							charGreaterThan(word[i], mNodes[cur].mLetter)
 							)
 						{
-							if (!cur->mRight)
+							if (!mNodes[cur].mRight)
 							{
-								cur->mRight = new TstNode(word[i], cur);
+								const index_type child = newNode(word[i], cur);
+								mNodes[cur].mRight = child;
 							}
 
-							cur = cur->mRight;
+							cur = mNodes[cur].mRight;
 						}
 						else
 						{
@@ -259,13 +793,14 @@ public:
 							}
 							else
 							{
-								if (!cur->mMid)
+								if (!mNodes[cur].mMid)
 								{
 									// Throw.
-									cur->mMid = new TstNode(word[i], cur);
+									const index_type child = newNode(word[i], cur);
+									mNodes[cur].mMid = child;
 								}
 
-								cur = cur->mMid;
+								cur = mNodes[cur].mMid;
 							}
 						}
 					}
@@ -278,13 +813,13 @@ public:
 				}
 
 				// If end word, return false. Adding failed.
-				if (cur->mEndWord)
+				if (mNodes[cur].mEndWord)
 				{
 					ret = false;
 				}
 				else
 				{
-					cur->mEndWord = true;
+					mNodes[cur].mEndWord = true;
 					++mSize;
 					ret = true;
 				}
@@ -304,14 +839,152 @@ public:
 		return mSize;
 	}
 
-	bool deleteWord(const string_type& word) noexcept
+	/*
+	 * Nodes in use, not counting the ones
+	 * freed by deleteWord and kept for reuse.
+	 */
+	size_type node_count() const noexcept
+	{
+		size_type freeNodes = 0;
+
+		for (index_type i = mFreeList; i; i = mNodes[i].mMid)
+		{
+			++freeNodes;
+		}
+
+		return mNodes.empty() ? 0 : mNodes.size() - 1 - freeNodes;
+	}
+
+	// Room for nodes nodes without moving the array again.
+	void reserve(const size_type nodes)
+	{
+		checkNodeCount(nodes);
+		mNodes.reserve(nodes + 1);
+	}
+
+	void shrink_to_fit()
+	{
+		mNodes.shrink_to_fit();
+	}
+
+	/*
+	 * Write the tree as an image for MappedTst: a header, then the
+	 * node array. Links are indices, so the image means the same
+	 * wherever it is mapped.
+	 *
+	 * Nodes are renumbered depth first with the middle child first,
+	 * which keeps the letters of a word on nearby pages and leaves out
+	 * the slots freed by deleteWord. Scores are not written.
+	 */
+	void serialize(::std::ostream& out) const
+	{
+		// order[i] is the node written at index i + 1, place maps back.
+		::std::vector<index_type> order;
+		::std::vector<index_type> place(mNodes.size());
+		::std::vector<index_type> pending;
+
+		order.reserve(node_count());
+
+		if (mRoot)
+		{
+			pending.push_back(mRoot);
+		}
+
+		while (!pending.empty())
+		{
+			const index_type cur = pending.back();
+			pending.pop_back();
+
+			order.push_back(cur);
+			place[cur] = static_cast<index_type>(order.size());
+
+			const Node& node = mNodes[cur];
+
+			for (const index_type child : { node.mRight, node.mLeft, node.mMid })
+			{
+				if (child)
+				{
+					pending.push_back(child);
+				}
+			}
+		}
+
+		ImageHeader header{};
+		::std::memcpy(header.mMagic, imageMagic, sizeof(header.mMagic));
+		header.mByteOrder = imageByteOrder;
+		header.mNodeSize = sizeof(Node);
+		header.mCharSize = sizeof(CharT);
+		header.mRoot = mRoot ? 1 : 0;
+		header.mNodeCount = order.size() + 1;
+		header.mWordCount = mSize;
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		// Written in batches, zeroed first so padding bytes are too.
+		constexpr size_type batch = 4096;
+		::std::vector<Node> buffer(batch);
+		size_type done = 0;
+
+		// Slot 0, the placeholder.
+		size_type filled = 1;
+		::std::memset(static_cast<void*>(buffer.data()), 0, sizeof(Node) * batch);
+
+		while (out && done < order.size())
+		{
+			while (filled < batch && done < order.size())
+			{
+				const Node& node = mNodes[order[done]];
+				Node& image = buffer[filled];
+				image.mLeft = place[node.mLeft];
+				image.mMid = place[node.mMid];
+				image.mRight = place[node.mRight];
+				image.mParent = place[node.mParent];
+				image.mLetter = node.mLetter;
+				image.mEndWord = node.mEndWord;
+				++filled;
+				++done;
+			}
+
+			out.write(
+				reinterpret_cast<const char*>(buffer.data()),
+				static_cast<::std::streamsize>(sizeof(Node) * filled)
+			);
+
+			filled = 0;
+			::std::memset(static_cast<void*>(buffer.data()), 0, sizeof(Node) * batch);
+		}
+
+		if (filled != 0)
+		{
+			out.write(
+				reinterpret_cast<const char*>(buffer.data()),
+				static_cast<::std::streamsize>(sizeof(Node) * filled)
+			);
+		}
+
+		if (!out)
+		{
+			throw ::std::runtime_error("TernarySearchTree: failed to write the image");
+		}
+	}
+
+	void clear() noexcept
+	{
+		mNodes.clear();
+		mScores.clear();
+		mRoot = nullIndex;
+		mFreeList = nullIndex;
+		mSize = 0;
+	}
+
+	bool deleteWord(const string_type& word) noexcept
 	{
 		return deleteWord(word.c_str(), word.length());
 	}
 
 	bool deleteWord(const CharT* word) noexcept
 	{
-		return deleteWord(word, ::std::strlen(word));
+		return deleteWord(word, traits::length(word));
 	}
 
 	bool deleteWord(const CharT* word, const size_type length) noexcept
@@ -321,18 +994,18 @@ public:
 		if (word && length != 0 && !empty())
 		{
 			size_type i = 0;
-			Node* cur = mRoot;
+			index_type cur = mRoot;
 			bool done = false;
 
 			while (cur && !done)
 			{
-				if (charLessThan(word[i], cur->mLetter))
+				if (charLessThan(word[i], mNodes[cur].mLetter))
 				{
-					cur = cur->mLeft;
+					cur = mNodes[cur].mLeft;
 				}
-				else if (charGreaterThan(word[i], cur->mLetter))
+				else if (charGreaterThan(word[i], mNodes[cur].mLetter))
 				{
-					cur = cur->mRight;
+					cur = mNodes[cur].mRight;
 				}
 				else
 				{
@@ -342,21 +1015,28 @@ public:
 					}
 					else
 					{
-						cur = cur->mMid;
+						cur = mNodes[cur].mMid;
 						++i;
 					}
 				}
 			}
 
-			// No search all letter, cur is nullptr or cur is not end word. return false.
-			if (i != length - 1 || !cur || !cur->mEndWord)
+			// No search all letter, cur is null or cur is not end word. return false.
+			if (i != length - 1 || !cur || !mNodes[cur].mEndWord)
 			{
 				ret = false;
 			}
 			else
 			{
 				// Do delete.
-				cur->mEndWord = false;
+				mNodes[cur].mEndWord = false;
+
+				// A node that stays for its middle child must not keep the old score.
+				if (mScored)
+				{
+					mScores[cur].mScore = 0;
+				}
+
 				clearUpUpwards(cur);
 
 				--mSize;
@@ -369,149 +1049,957 @@ public:
 
 private:
 
-	static Node* getSuccessorsFromRight(Node* node) noexcept
+	/*
+	 * Add words[low, high) median first, without their first skip
+	 * letters.
+	 */
+	void addMedians(
+		const ::std::vector<string_type>& words,
+		const size_type low,
+		const size_type high,
+		const size_type skip
+	)
+	{
+		if (low < high)
+		{
+			const size_type mid = low + (high - low) / 2;
+			addWord(words[mid].c_str() + skip, words[mid].length() - skip);
+			addMedians(words, low, mid, skip);
+			addMedians(words, mid + 1, high, skip);
+		}
+	}
+
+	/*
+	 * The first letters of groups [low, high) as one-letter words,
+	 * median first.
+	 */
+	void addLetterMedians(
+		const ::std::vector<string_type>& words,
+		const ::std::vector<size_type>& starts,
+		const size_type low,
+		const size_type high
+	)
+	{
+		if (low < high)
+		{
+			const size_type mid = low + (high - low) / 2;
+			addWord(words[starts[mid]].c_str(), 1);
+			addLetterMedians(words, starts, low, mid);
+			addLetterMedians(words, starts, mid + 1, high);
+		}
+	}
+
+	/*
+	 * words is sorted and unique. Every run of words with the same
+	 * first letter is a group. Its words minus that letter become a
+	 * separate tree, built by whichever thread takes the group.
+	 *
+	 * If a thread cannot be started the others take its groups.
+	 */
+	void buildParallel(const ::std::vector<string_type>& words, const unsigned threads)
+	{
+		// Group g is words[starts[g], starts[g + 1]).
+		::std::vector<size_type> starts;
+
+		for (size_type i = 0; i < words.size(); ++i)
+		{
+			if (!words[i].empty()
+				&& (starts.empty() || charNonEqual(words[i][0], words[starts.back()][0])))
+			{
+				starts.push_back(i);
+			}
+		}
+
+		const size_type groups = starts.size();
+		starts.push_back(words.size());
+
+		if (groups != 0)
+		{
+			::std::vector<TernarySearchTree> parts(groups);
+			::std::atomic<size_type> nextGroup(0);
+
+			const auto work = [&](::std::exception_ptr& error) noexcept
+			{
+				try
+				{
+					for (size_type g = nextGroup++; g < groups; g = nextGroup++)
+					{
+						// The one-letter word, if any, sorts first and stays on the letter node.
+						const size_type low = starts[g] + (words[starts[g]].length() == 1 ? 1 : 0);
+						parts[g].addMedians(words, low, starts[g + 1], 1);
+					}
+				}
+				catch (...)
+				{
+					error = ::std::current_exception();
+				}
+			};
+
+			const size_type helpers = ::std::min<size_type>(threads, groups) - 1;
+			::std::vector<::std::exception_ptr> errors(helpers + 1);
+			::std::vector<::std::thread> pool;
+			pool.reserve(helpers);
+
+			try
+			{
+				for (size_type t = 0; t < helpers; ++t)
+				{
+					pool.emplace_back(work, ::std::ref(errors[t + 1]));
+				}
+			}
+			catch (...)
+			{
+				/*
+				 * system_error or bad_alloc from starting a thread. The started ones are joined
+				 * below either way, and this thread takes whatever groups they leave.
+				 */
+			}
+
+			work(errors[0]);
+
+			for (::std::thread& thread : pool)
+			{
+				thread.join();
+			}
+
+			for (const ::std::exception_ptr& error : errors)
+			{
+				if (error)
+				{
+					::std::rethrow_exception(error);
+				}
+			}
+
+			graftParts(words, starts, parts);
+		}
+	}
+
+	void graftParts(
+		const ::std::vector<string_type>& words,
+		const ::std::vector<size_type>& starts,
+		::std::vector<TernarySearchTree>& parts
+	)
+	{
+		// Drop nodes left on the free list, the offsets below assume none.
+		clear();
+
+		try
+		{
+			const size_type groups = parts.size();
+			addLetterMedians(words, starts, 0, groups);
+
+			size_type total = mNodes.size();
+
+			for (const TernarySearchTree& part : parts)
+			{
+				total += part.mNodes.empty() ? 0 : part.mNodes.size() - 1;
+			}
+
+			checkNodeCount(total - 1);
+			mNodes.reserve(total);
+
+			size_type count = 0;
+
+			for (size_type g = 0; g < groups; ++g)
+			{
+				const index_type letter = findNode(words[starts[g]].c_str(), 1);
+				const bool single = words[starts[g]].length() == 1;
+
+				mNodes[letter].mEndWord = single;
+				count += single ? 1 : 0;
+				count += parts[g].size();
+				graft(letter, parts[g]);
+
+				// Give the memory back as we go.
+				::std::vector<Node>().swap(parts[g].mNodes);
+			}
+
+			mSize = count;
+
+			if (mScored)
+			{
+				mScores.resize(mNodes.size());
+			}
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+	}
+
+	// Append the nodes of part, shifting its links, as the middle child of parent.
+	void graft(const index_type parent, const TernarySearchTree& part)
+	{
+		if (part.mRoot)
+		{
+			const index_type offset = static_cast<index_type>(mNodes.size() - 1);
+
+			for (size_type i = 1; i < part.mNodes.size(); ++i)
+			{
+				Node node = part.mNodes[i];
+				node.mLeft = shiftLink(node.mLeft, offset);
+				node.mMid = shiftLink(node.mMid, offset);
+				node.mRight = shiftLink(node.mRight, offset);
+				node.mParent = node.mParent ? node.mParent + offset : parent;
+				mNodes.push_back(node);
+			}
+
+			mNodes[parent].mMid = part.mRoot + offset;
+		}
+	}
+
+	static index_type shiftLink(const index_type link, const index_type offset) noexcept
+	{
+		return link ? link + offset : nullIndex;
+	}
+
+	/*
+	 * Start of a serialize image, followed by mNodeCount nodes. Only a
+	 * build with the same node layout and byte order can map it.
+	 */
+	struct ImageHeader
+	{
+		char mMagic[8];
+
+		::std::uint32_t mByteOrder;
+
+		::std::uint32_t mNodeSize;
+
+		::std::uint32_t mCharSize;
+
+		::std::uint32_t mRoot;
+
+		::std::uint64_t mNodeCount;
+
+		::std::uint64_t mWordCount;
+	};
+
+	static constexpr char imageMagic[8] = { 'T', 'S', 'T', 'I', 'M', 'G', '0', '1' };
+
+	static constexpr ::std::uint32_t imageByteOrder = 0x01020304;
+
+	static_assert(::std::is_trivially_copyable_v<Node>, "Nodes are written and mapped as bytes.");
+
+	static_assert(sizeof(ImageHeader) % alignof(Node) == 0, "Mapped nodes must stay aligned.");
+
+	// Where the fuzzySearch walk came from when it reaches a node.
+	enum class FuzzyStage
+	{
+		arrived,
+		fromLeft,
+		fromMid,
+		fromRight
+	};
+
+	/*
+	 * One Levenshtein step: row is the distances of every prefix of
+	 * word to the letters above, then letter. Returns the row minimum.
+	 */
+	static size_type fuzzyRow(
+		const size_type* above,
+		size_type* row,
+		const CharT* word,
+		const size_type length,
+		const CharT& letter
+	) noexcept
+	{
+		row[0] = above[0] + 1;
+		size_type ret = row[0];
+
+		for (size_type i = 1; i <= length; ++i)
+		{
+			const size_type replace = above[i - 1] + (charEqual(word[i - 1], letter) ? 0 : 1);
+			row[i] = ::std::min(::std::min(above[i], row[i - 1]) + 1, replace);
+			ret = ::std::min(ret, row[i]);
+		}
+
+		return ret;
+	}
+
+	// For topK: the best score of a node's subtree, or of the word ending at it.
+	struct Candidate
+	{
+		score_type mBound;
+
+		index_type mNode;
+
+		bool mWord;
+	};
+
+	// On equal scores a finished word comes out before a subtree.
+	static bool candidateLess(const Candidate& left, const Candidate& right) noexcept
+	{
+		return left.mBound < right.mBound
+			|| (left.mBound == right.mBound && !left.mWord && right.mWord);
+	}
+
+	static void pushCandidate(::std::vector<Candidate>& heap, const Candidate& candidate)
+	{
+		heap.push_back(candidate);
+		::std::push_heap(heap.begin(), heap.end(), candidateLess);
+	}
+
+	void pushSubtree(::std::vector<Candidate>& heap, const index_type root) const
+	{
+		if (root)
+		{
+			pushCandidate(heap, Candidate{ mScored ? mScores[root].mMax : 0, root, false });
+		}
+	}
+
+	score_type scoreOf(const index_type index) const noexcept
+	{
+		return mScored ? mScores[index].mScore : 0;
+	}
+
+	/*
+	 * Rebuild the word that ends at target into word. The letters after
+	 * the prefix are those of target and of every ancestor below stop
+	 * that was left through its middle child.
+	 */
+	void spellWord(
+		const CharT* prefix,
+		const size_type length,
+		const index_type stop,
+		const index_type target,
+		string_type& word
+	) const
+	{
+		word.assign(prefix, length);
+
+		if (target != stop)
+		{
+			const size_type base = word.size();
+			index_type cur = target;
+			word.push_back(mNodes[cur].mLetter);
+
+			while (mNodes[cur].mParent != stop)
+			{
+				const index_type parent = mNodes[cur].mParent;
+
+				if (mNodes[parent].mMid == cur)
+				{
+					word.push_back(mNodes[parent].mLetter);
+				}
+
+				cur = parent;
+			}
+
+			::std::reverse(word.begin() + static_cast<difference_type>(base), word.end());
+		}
+	}
+
+	// The node of the last letter of string, or null.
+	index_type findNode(const CharT* string, const size_type length) const noexcept
+	{
+		return findNode(mNodes.data(), mRoot, string, length);
+	}
+
+	// Shared with MappedTst, which walks nodes it did not build.
+	static index_type findNode(
+		const Node* nodes,
+		const index_type root,
+		const CharT* string,
+		const size_type length
+	) noexcept
+	{
+		index_type cur = length == 0 ? nullIndex : root;
+		index_type ret = nullIndex;
+		size_type i = 0;
+
+		while (cur && !ret)
+		{
+			const Node& node = nodes[cur];
+
+			if (charLessThan(string[i], node.mLetter))
+			{
+				cur = node.mLeft;
+			}
+			else if (charGreaterThan(string[i], node.mLetter))
+			{
+				cur = node.mRight;
+			}
+			else
+			{
+				if (i == length - 1)
+				{
+					ret = cur;
+				}
+				else
+				{
+					cur = node.mMid;
+					++i;
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	static prefix_range makePrefixRange(
+		const Node* nodes,
+		const index_type root,
+		const CharT* prefix,
+		const size_type length
+	)
+	{
+		prefix_iterator first;
+
+		if (length == 0)
+		{
+			first = prefix_iterator(nodes, root, nullIndex, string_type());
+		}
+		else
+		{
+			const index_type stop = findNode(nodes, root, prefix, length);
+
+			if (stop)
+			{
+				first = prefix_iterator(nodes, root, stop, string_type(prefix, length));
+			}
+		}
+
+		return prefix_range(::std::move(first));
+	}
+
+	void enableScores()
+	{
+		if (!mScored)
+		{
+			mScores.resize(mNodes.size());
+			mScored = true;
+		}
+	}
+
+	/*
+	 * Recompute the cached subtree maximum from cur up to the root.
+	 * Slot 0 keeps a maximum of 0, so missing children need no check.
+	 */
+	void refreshScoresUpwards(index_type cur) noexcept
+	{
+		if (mScored)
+		{
+			while (cur)
+			{
+				const Node& node = mNodes[cur];
+				score_type best = node.mEndWord ? mScores[cur].mScore : 0;
+				best = ::std::max(best, mScores[node.mLeft].mMax);
+				best = ::std::max(best, mScores[node.mMid].mMax);
+				best = ::std::max(best, mScores[node.mRight].mMax);
+				mScores[cur].mMax = best;
+				cur = node.mParent;
+			}
+		}
+	}
+
+	static void checkNodeCount(const size_type nodes)
+	{
+		if (nodes >= ::std::numeric_limits<index_type>::max())
+		{
+			throw ::std::length_error("TernarySearchTree: too many nodes for 32-bit indices");
+		}
+	}
+
+	/*
+	 * Take a node from the free list, or append one.
+	 * Appending may move the array, so callers must not
+	 * hold references to nodes across this call.
+	 */
+	index_type newNode(const CharT& letter, const index_type parent)
+	{
+		index_type ret = mFreeList;
+
+		if (ret)
+		{
+			mFreeList = mNodes[ret].mMid;
+			mNodes[ret] = Node(letter, parent);
+		}
+		else
+		{
+			if (mNodes.empty())
+			{
+				// Slot 0 stands for "no node".
+				mNodes.emplace_back();
+			}
+
+			checkNodeCount(mNodes.size());
+			mNodes.emplace_back(letter, parent);
+
+			if (mScored)
+			{
+				try
+				{
+					mScores.resize(mNodes.size());
+				}
+				catch (...)
+				{
+					mNodes.pop_back();
+					throw;
+				}
+			}
+
+			ret = static_cast<index_type>(mNodes.size() - 1);
+		}
+
+		return ret;
+	}
+
+	void freeNode(const index_type index) noexcept
 	{
-		Node* ret = node->mRight;
-		while (ret->mLeft)
+		if (mScored)
 		{
-			ret = ret->mLeft;
+			mScores[index] = Score();
+		}
+
+		mNodes[index] = Node();
+		mNodes[index].mMid = mFreeList;
+		mFreeList = index;
+	}
+
+	index_type getSuccessorsFromRight(const index_type node) const noexcept
+	{
+		index_type ret = mNodes[node].mRight;
+		while (mNodes[ret].mLeft)
+		{
+			ret = mNodes[ret].mLeft;
 		}
 
 		return ret;
 	}
 
-	void clearUpUpwards(Node* cur) noexcept
+	void clearUpUpwards(index_type cur) noexcept
 	{
 		bool done = false;
 
 		while (cur && !done)
 		{
-			if (cur->mMid || cur->mEndWord)
+			Node& node = mNodes[cur];
+
+			if (node.mMid || node.mEndWord)
 			{
 				done = true;
 			}
 			else
 			{
-				if (!cur->mLeft)
+				if (!node.mLeft)
 				{
-					transplantBToA(cur, cur->mRight);
+					transplantBToA(cur, node.mRight);
 				}
-				else if (!cur->mRight)
+				else if (!node.mRight)
 				{
-					transplantBToA(cur, cur->mLeft);
+					transplantBToA(cur, node.mLeft);
 				}
 				else
 				{
-					Node* successor = getSuccessorsFromRight(cur);
+					const index_type successor = getSuccessorsFromRight(cur);
 
-					if (successor->mParent != cur)
+					// The deepest node whose subtree changes shape.
+					const index_type changedFrom = mNodes[successor].mParent != cur
+						? mNodes[successor].mParent
+						: successor;
+
+					if (mNodes[successor].mParent != cur)
 					{
-						transplantBToA(successor, successor->mRight);
-						successor->mRight = cur->mRight;
-						successor->mRight->mParent = successor;
+						transplantBToA(successor, mNodes[successor].mRight);
+						mNodes[successor].mRight = node.mRight;
+						mNodes[mNodes[successor].mRight].mParent = successor;
 					}
 
 					transplantBToA(cur, successor);
-					successor->mLeft = cur->mLeft;
-					successor->mLeft->mParent = successor;
+					mNodes[successor].mLeft = node.mLeft;
+					mNodes[mNodes[successor].mLeft].mParent = successor;
+
+					refreshScoresUpwards(changedFrom);
 				}
 
-				const Node* const toDelete = cur;
-				cur = cur->mParent;
+				const index_type toDelete = cur;
+				cur = node.mParent;
 
-				delete toDelete;
+				freeNode(toDelete);
 			}
 		}
+
+		refreshScoresUpwards(cur);
 	}
 
-	void transplantBToA(Node* const a, Node* const b) noexcept
+	void transplantBToA(const index_type a, const index_type b) noexcept
 	{
-		if (!a->mParent)
+		const index_type parent = mNodes[a].mParent;
+
+		if (!parent)
 		{
 			mRoot = b;
 		}
-		else if (a == a->mParent->mLeft)
+		else if (a == mNodes[parent].mLeft)
 		{
-			a->mParent->mLeft = b;
+			mNodes[parent].mLeft = b;
 		}
-		else if (a == a->mParent->mRight)
+		else if (a == mNodes[parent].mRight)
 		{
-			a->mParent->mRight = b;
+			mNodes[parent].mRight = b;
 		}
 		else
 		{
-			a->mParent->mMid = b;
+			mNodes[parent].mMid = b;
 		}
 
 		if (b)
 		{
-			b->mParent = a->mParent;
+			mNodes[b].mParent = parent;
 		}
 	}
 
 	void emptyInsert(const CharT* word, const size_type length)
 	{
-		// Throw
-		mRoot = new Node(word[0]);
-		Node* cur = mRoot;
-
 		try
 		{
+			// Throw
+			mRoot = newNode(word[0], nullIndex);
+			index_type cur = mRoot;
+
 			for (size_type i = 1; i < length; ++i)
 			{
-				cur->mMid = new Node(word[i], cur);
-				cur = cur->mMid;
+				const index_type child = newNode(word[i], cur);
+				mNodes[cur].mMid = child;
+				cur = child;
 			}
+
+			mNodes[cur].mEndWord = true;
 		}
-		catch (...) 
+		catch (...)
 		{
-			/* 
+			/*
 			 * If we failed to create a tree when
 			 * the tree is empty before.
 			 *
-			 * We will destroy all the nodes which
-			 * already created.
+			 * Every node is unused then, so
+			 * we drop them all.
 			 */
-			deleteSubTree(mRoot);
+			clear();
+			throw;
+		}
+	}
+
+	struct Score
+	{
+		score_type mScore;
+
+		// Best mScore of any word in the subtree, this node included.
+		score_type mMax;
+	};
+
+	// mNodes[0] is the placeholder for "no node". Empty until the first word.
+	::std::vector<Node> mNodes;
+
+	// Parallel to mNodes once a word was added with a score, empty before.
+	::std::vector<Score> mScores;
+
+	index_type mRoot;
+
+	// Freed nodes, chained through mMid.
+	index_type mFreeList;
+
+	size_type mSize;
+
+	bool mScored;
+
+};
+
+/*
+ * Read-only view of an image written by TernarySearchTree::serialize.
+ *
+ * The file is mapped, not read. Opening it is one mmap (MapViewOfFile
+ * on Windows), and queries walk the mapped nodes in place, so every
+ * process that maps the same file shares one copy in the page cache.
+ *
+ * The image is trusted; only its header and length are checked.
+ */
+template <typename CharT, typename Traits>
+class MappedTst final
+{
+private:
+
+	using Tree = TernarySearchTree<CharT, Traits>;
+
+	using Node = typename Tree::node_type;
+
+	using index_type = typename Node::index_type;
+
+	using Header = typename Tree::ImageHeader;
+
+public:
+
+	using value_type = CharT;
+	using size_type = ::std::size_t;
+	using string_type = ::std::basic_string<CharT, Traits>;
+	using traits = Traits;
+	using prefix_iterator = typename Tree::prefix_iterator;
+	using prefix_range = typename Tree::prefix_range;
+
+	/*
+	 * Throws ::std::system_error if the file cannot be opened or
+	 * mapped, and ::std::runtime_error if it is not an image this
+	 * build can read.
+	 */
+	explicit MappedTst(const ::std::string& path)
+		: mAddress(), mLength(), mNodes(), mRoot(), mSize(), mNodeCount()
+	{
+		mapFile(path);
+
+		try
+		{
+			readHeader();
+		}
+		catch (...)
+		{
+			unmap();
 			throw;
 		}
+	}
 
-		cur->mEndWord = true;
+	MappedTst(MappedTst&& other) noexcept
+		: mAddress(other.mAddress),
+		mLength(other.mLength),
+		mNodes(other.mNodes),
+		mRoot(other.mRoot),
+		mSize(other.mSize),
+		mNodeCount(other.mNodeCount)
+	{
+		other.mAddress = nullptr;
+		other.mLength = 0;
+		other.mNodes = nullptr;
+		other.mRoot = 0;
+		other.mSize = 0;
+		other.mNodeCount = 0;
 	}
 
-	static void deleteSubTree(Node* root) noexcept
+	MappedTst(const MappedTst&) = delete;
+
+	MappedTst& operator=(const MappedTst&) = delete;
+
+	~MappedTst() noexcept
 	{
-		if (root)
+		unmap();
+	}
+
+	bool contain(const string_type& string) const noexcept
+	{
+		return contain(string.c_str(), string.length());
+	}
+
+	bool contain(const CharT* string, const size_type length) const noexcept
+	{
+		const index_type found = Tree::findNode(mNodes, mRoot, string, length);
+
+		return found && mNodes[found].mEndWord;
+	}
+
+	prefix_range prefixSearch(const string_type& prefix) const
+	{
+		return prefixSearch(prefix.c_str(), prefix.length());
+	}
+
+	prefix_range prefixSearch(const CharT* prefix, const size_type length) const
+	{
+		return Tree::makePrefixRange(mNodes, mRoot, prefix, length);
+	}
+
+	bool empty() const noexcept
+	{
+		return mSize == 0;
+	}
+
+	size_type size() const noexcept
+	{
+		return mSize;
+	}
+
+	size_type node_count() const noexcept
+	{
+		return mNodeCount == 0 ? 0 : mNodeCount - 1;
+	}
+
+private:
+
+#if defined(_WIN32)
+	void mapFile(const ::std::string& path)
+	{
+		const HANDLE file = ::CreateFileA(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr
+		);
+
+		if (file == INVALID_HANDLE_VALUE)
 		{
-			if (root->mLeft)
+			throw ::std::system_error(
+				static_cast<int>(::GetLastError()),
+				::std::system_category(),
+				"MappedTst: cannot open " + path
+			);
+		}
+
+		LARGE_INTEGER length{};
+		DWORD error = 0;
+
+		if (!::GetFileSizeEx(file, &length))
+		{
+			error = ::GetLastError();
+		}
+		else if (static_cast<unsigned long long>(length.QuadPart) >= sizeof(Header))
+		{
+			const HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (!mapping)
 			{
-				deleteSubTree(root->mLeft);
-				root->mLeft = nullptr;
-				
+				error = ::GetLastError();
 			}
-
-			if (root->mMid)
+			else
 			{
-				deleteSubTree(root->mMid);
-				root->mMid = nullptr;
+				// The view keeps the mapping alive after its handle is closed.
+				mAddress = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+				if (!mAddress)
+				{
+					error = ::GetLastError();
+				}
+				else
+				{
+					mLength = static_cast<size_type>(length.QuadPart);
+				}
+
+				::CloseHandle(mapping);
 			}
+		}
+
+		::CloseHandle(file);
 
-			if (root->mRight)
+		if (error != 0)
+		{
+			throw ::std::system_error(
+				static_cast<int>(error),
+				::std::system_category(),
+				"MappedTst: cannot map " + path
+			);
+		}
+	}
+
+	void unmap() noexcept
+	{
+		if (mAddress)
+		{
+			::UnmapViewOfFile(mAddress);
+		}
+	}
+#else
+	void mapFile(const ::std::string& path)
+	{
+		const int file = ::open(path.c_str(), O_RDONLY);
+
+		if (file < 0)
+		{
+			throw ::std::system_error(errno, ::std::generic_category(), "MappedTst: cannot open " + path);
+		}
+
+		struct stat info {};
+		int error = 0;
+
+		if (::fstat(file, &info) != 0)
+		{
+			error = errno;
+		}
+		else if (static_cast<unsigned long long>(info.st_size) >= sizeof(Header))
+		{
+			void* const address = ::mmap(
+				nullptr,
+				static_cast<size_type>(info.st_size),
+				PROT_READ,
+				MAP_SHARED,
+				file,
+				0
+			);
+
+			if (address == MAP_FAILED)
+			{
+				error = errno;
+			}
+			else
 			{
-				deleteSubTree(root->mRight);
-				root->mRight = nullptr;
+				mAddress = address;
+				mLength = static_cast<size_type>(info.st_size);
 			}
+		}
+
+		// The mapping stays valid after the descriptor is closed.
+		::close(file);
+
+		if (error != 0)
+		{
+			throw ::std::system_error(error, ::std::generic_category(), "MappedTst: cannot map " + path);
+		}
+	}
 
-			delete root;
+	void unmap() noexcept
+	{
+		if (mAddress)
+		{
+			::munmap(mAddress, mLength);
 		}
 	}
+#endif // _WIN32
 
-	Node* mRoot;
+	void readHeader()
+	{
+		const unsigned char* const bytes = static_cast<const unsigned char*>(mAddress);
+		Header header{};
+		bool valid = bytes && mLength >= sizeof(Header);
+
+		if (valid)
+		{
+			::std::memcpy(&header, bytes, sizeof(Header));
+
+			valid = ::std::memcmp(header.mMagic, Tree::imageMagic, sizeof(header.mMagic)) == 0
+				&& header.mByteOrder == Tree::imageByteOrder
+				&& header.mNodeSize == sizeof(Node)
+				&& header.mCharSize == sizeof(CharT)
+				&& header.mNodeCount != 0
+				&& header.mNodeCount <= (mLength - sizeof(Header)) / sizeof(Node)
+				&& header.mNodeCount * sizeof(Node) == mLength - sizeof(Header)
+				&& header.mRoot < header.mNodeCount;
+		}
+
+		if (!valid)
+		{
+			throw ::std::runtime_error("MappedTst: not a TernarySearchTree image for this build");
+		}
+
+		mNodes = reinterpret_cast<const Node*>(bytes + sizeof(Header));
+		mRoot = header.mRoot;
+		mSize = static_cast<size_type>(header.mWordCount);
+		mNodeCount = static_cast<size_type>(header.mNodeCount);
+	}
+
+	void* mAddress;
+
+	size_type mLength;
+
+	const Node* mNodes;
+
+	index_type mRoot;
 
 	size_type mSize;
 
+	size_type mNodeCount;
+
 };
 
 using StringTst = TernarySearchTree<char>;
 
-#endif // !APT_A2_TST
\ No newline at end of file
+using MappedStringTst = MappedTst<char>;
+
+#endif // !APT_A2_TST
@@ -8,6 +8,7 @@
 #include <tuple>
 
 #include "Healper.h"
+#include "Utility.h"
 
 JSTD_START
 
@@ -304,7 +305,12 @@ public:
 		return ptrData.getPtr();
 	}
 
-	const deleter_type& get_deleter() noexcept
+	deleter_type& get_deleter() noexcept
+	{
+		return ptrData.getDeleter();
+	}
+
+	const deleter_type& get_deleter() const noexcept
 	{
 		return ptrData.getDeleter();
 	}
@@ -419,8 +425,13 @@ private:
 	UniqPtrData<T, D> ptrData;
 };
 
-
-
+/*
+* A UniquePtr is its pointer and its deleter, moving one and forgetting the source is a bitwise copy.
+*/
+template <typename T, typename D>
+struct is_trivially_relocatable<UniquePtr<T, D>>
+	: STD bool_constant<is_trivially_relocatable_v<typename UniquePtr<T, D>::pointer>
+		&& is_trivially_relocatable_v<D>> {};
 
 template <typename T>
 struct MakeUniq
@@ -3,6 +3,8 @@
 #define UTILITY
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <stdexcept>
@@ -11,6 +13,58 @@
 
 JSTD_START
 
+/*
+* Customization point: T is trivially relocatable if moving an object to new storage and
+* ending the lifetime of the source is equivalent to copying its bytes.
+* True for trivially copyable types; specialize it for types that merely own a resource
+* through a pointer, like UniquePtr.
+*/
+template <typename T>
+struct is_trivially_relocatable : STD is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/*
+* Allocators whose construct/destroy are plain placement new and ~T().
+* Only through these may the helpers below skip the allocator and touch bytes directly.
+*/
+template <typename Alloc>
+struct is_default_construct_allocator : STD false_type {};
+
+template <typename T>
+struct is_default_construct_allocator<STD allocator<T>> : STD true_type {};
+
+template <typename T, typename Alloc>
+inline constexpr bool is_bitwise_relocatable_v =
+	is_trivially_relocatable_v<T> && is_default_construct_allocator<Alloc>::value;
+
+/*
+* Relocation never throws: either it is a memcpy, or a nothrow move followed by a destroy.
+*/
+template <typename T, typename Alloc>
+inline constexpr bool is_nothrow_relocatable_v = is_bitwise_relocatable_v<T, Alloc>
+	|| (STD is_nothrow_move_constructible_v<T> && is_default_construct_allocator<Alloc>::value);
+
+/*
+* Both iterators are contiguous over the same trivially copyable type, so copying
+* the elements is copying the bytes.
+*/
+template <typename InputIterator, typename ForwardIterator, typename Allocator>
+inline constexpr bool is_memcpy_copyable_v = [] {
+	if constexpr (STD contiguous_iterator<InputIterator> && STD contiguous_iterator<ForwardIterator>)
+	{
+		using Source = STD remove_cv_t<STD iter_value_t<InputIterator>>;
+		using Dest = STD iter_value_t<ForwardIterator>;
+		return STD is_same_v<Source, Dest> && STD is_trivially_copyable_v<Dest>
+			&& is_default_construct_allocator<Allocator>::value;
+	}
+	else
+	{
+		return false;
+	}
+}();
+
 template <typename T>
 constexpr inline void myDestroyInPlace(T& object) JLIBCXX_NOEXCEPT
 {
@@ -37,18 +91,20 @@ constexpr inline void myDestroyRange(NoThrowFwdIt first, const NoThrowFwdIt last
 }
 
 template <typename ForwardIterator, typename Allocator>
-void myDestroy(ForwardIterator first, ForwardIterator last, Allocator& alloc)
+constexpr void myDestroy(ForwardIterator first, ForwardIterator last, Allocator& alloc)
 {
-	for (; first != last; ++first)
+	if constexpr (is_default_construct_allocator<Allocator>::value)
 	{
-		STD allocator_traits<Allocator>::destroy(alloc, STD addressof(*first));
+		// No-op for trivially destructible types.
+		myDestroyRange(first, last);
+	}
+	else
+	{
+		for (; first != last; ++first)
+		{
+			STD allocator_traits<Allocator>::destroy(alloc, STD addressof(*first));
+		}
 	}
-}
-
-template <typename ForwardIterator, typename T>
-inline void myDestroy(ForwardIterator first, ForwardIterator last, STD allocator<T>&) JLIBCXX_NOEXCEPT
-{
-	myDestroyRange(first, last);
 }
 
 template <typename T>
@@ -110,7 +166,7 @@ struct NODISCARD ClearGuard
 };
 
 template <class InputIterator>
-static NODISCARD constexpr STD iter_difference_t<InputIterator> myDistance(
+NODISCARD static constexpr STD iter_difference_t<InputIterator> myDistance(
 	InputIterator first,
 	InputIterator last)
 {
@@ -135,6 +191,17 @@ constexpr static InputIterator fillN(InputIterator dest, STD size_t n, const V&
 		return dest;
 	}
 
+	if constexpr (STD contiguous_iterator<InputIterator>
+		&& STD is_trivially_copyable_v<STD iter_value_t<InputIterator>>)
+	{
+		if (!STD is_constant_evaluated())
+		{
+			// Lowers to memset for bytes and to a vectorized store loop otherwise.
+			STD fill_n(STD to_address(dest), n, value);
+			return dest + static_cast<STD iter_difference_t<InputIterator>>(n);
+		}
+	}
+
 	for (; n; --n, ++dest)
 	{
 		*dest = value;
@@ -161,6 +228,17 @@ constexpr static InputIterator uninitializedFillRanges(
 	const V& value,
 	Allocator& alloc)
 {
+	if constexpr (STD contiguous_iterator<InputIterator>
+		&& STD is_trivially_copyable_v<STD iter_value_t<InputIterator>>
+		&& is_default_construct_allocator<Allocator>::value)
+	{
+		if (!STD is_constant_evaluated())
+		{
+			// Trivial types begin their lifetime by assignment into the storage.
+			return fillN(dest, static_cast<STD size_t>(count), value);
+		}
+	}
+
 	InputIterator current = dest;
 	TRY_START
 	for (; count; --count, ++current)
@@ -176,6 +254,202 @@ constexpr static InputIterator uninitializedFillRanges(
 	END_CATCH
 }
 
+template <typename InputIterator, typename SizeT, typename ForwardIterator, typename Allocator>
+constexpr static ForwardIterator uninitializedCopyNAllocated(
+	InputIterator first,
+	SizeT count,
+	ForwardIterator dest,
+	Allocator& alloc)
+{
+	if constexpr (is_memcpy_copyable_v<InputIterator, ForwardIterator, Allocator>)
+	{
+		if (!STD is_constant_evaluated())
+		{
+			if (count > 0)
+			{
+				STD memmove(STD to_address(dest), STD to_address(first), sizeof(*dest) * count);
+			}
+
+			return dest + count;
+		}
+	}
+
+	ForwardIterator current = dest;
+	TRY_START
+	for (; count; --count, ++first, ++current)
+	{
+		STD allocator_traits<Allocator>::construct(alloc, STD addressof(*current), *first);
+	}
+
+	return current;
+	CATCH_ALL
+	myDestroy(dest, current, alloc);
+
+	THROW_AGAIN
+	END_CATCH
+}
+
+template <typename InputIterator, typename ForwardIterator, typename Allocator>
+constexpr static ForwardIterator uninitializedCopyAllocated(
+	InputIterator first,
+	InputIterator last,
+	ForwardIterator dest,
+	Allocator& alloc)
+{
+	if constexpr (is_memcpy_copyable_v<InputIterator, ForwardIterator, Allocator>)
+	{
+		if (!STD is_constant_evaluated())
+		{
+			const auto count = last - first;
+			if (count > 0)
+			{
+				STD memmove(STD to_address(dest), STD to_address(first), sizeof(*dest) * count);
+			}
+
+			return dest + count;
+		}
+	}
+
+	ForwardIterator current = dest;
+	TRY_START
+	for (; first != last; ++first, ++current)
+	{
+		STD allocator_traits<Allocator>::construct(alloc, STD addressof(*current), *first);
+	}
+
+	return current;
+	CATCH_ALL
+	myDestroy(dest, current, alloc);
+
+	THROW_AGAIN
+	END_CATCH
+}
+
+/*
+* Move-construct [first, last) into the uninitialized storage at dest. The source is left
+* moved-from and still has to be destroyed by the caller.
+*/
+template <typename InputIterator, typename ForwardIterator, typename Allocator>
+constexpr static ForwardIterator uninitializedMoveAllocated(
+	InputIterator first,
+	InputIterator last,
+	ForwardIterator dest,
+	Allocator& alloc)
+{
+	if constexpr (is_memcpy_copyable_v<InputIterator, ForwardIterator, Allocator>)
+	{
+		return uninitializedCopyAllocated(first, last, dest, alloc);
+	}
+	else
+	{
+		return uninitializedCopyAllocated(
+			STD make_move_iterator(first), STD make_move_iterator(last), dest, alloc);
+	}
+}
+
+/*
+* Move [first, last) into the uninitialized storage at dest and end the lifetime of the source.
+* One memmove when T is trivially relocatable, otherwise a move and a destroy per element.
+* The ranges may overlap only if dest <= first.
+*/
+template <typename Pointer, typename Allocator>
+constexpr static Pointer myRelocate(Pointer first, Pointer last, Pointer dest, Allocator& alloc) JLIBCXX_NOEXCEPT
+{
+	using T = typename STD pointer_traits<Pointer>::element_type;
+	static_assert(is_nothrow_relocatable_v<T, Allocator>, "Relocation must not throw");
+
+	if constexpr (is_bitwise_relocatable_v<T, Allocator>)
+	{
+		if (!STD is_constant_evaluated())
+		{
+			const auto count = last - first;
+			if (count > 0)
+			{
+				STD memmove(
+					static_cast<void*>(STD to_address(dest)),
+					static_cast<const void*>(STD to_address(first)),
+					sizeof(T) * count);
+			}
+
+			return dest + count;
+		}
+	}
+
+	for (; first != last; ++first, ++dest)
+	{
+		STD allocator_traits<Allocator>::construct(alloc, STD to_address(dest), STD move(*first));
+		STD allocator_traits<Allocator>::destroy(alloc, STD to_address(first));
+	}
+
+	return dest;
+}
+
+/*
+* Exchange the bytes of two non-overlapping buffers through a small stack buffer.
+*/
+inline void swapBytes(void* left, void* right, STD size_t bytes) JLIBCXX_NOEXCEPT
+{
+	constexpr STD size_t chunkSize = 256;
+	unsigned char buffer[chunkSize];
+
+	auto* l = static_cast<unsigned char*>(left);
+	auto* r = static_cast<unsigned char*>(right);
+	while (bytes)
+	{
+		const STD size_t chunk = bytes < chunkSize ? bytes : chunkSize;
+		STD memcpy(buffer, l, chunk);
+		STD memcpy(l, r, chunk);
+		STD memcpy(r, buffer, chunk);
+
+		l += chunk;
+		r += chunk;
+		bytes -= chunk;
+	}
+}
+
+/*
+* Branchless binary search over n sorted keys. For a given n the loop always runs the same
+* number of times and the select compiles to a conditional move, so the search does not
+* mispredict. Used by BTreeMap inside a node and by FlatMap over the whole key array.
+*/
+template <typename Key, typename K, typename Compare>
+inline STD size_t branchlessLowerBound(const Key* keys, STD size_t n, const K& key, const Compare& comp)
+{
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	const Key* base = keys;
+	while (n > 1)
+	{
+		const STD size_t half = n / 2;
+		base = comp(base[half], key) ? base + half : base;
+		n -= half;
+	}
+
+	return static_cast<STD size_t>(base - keys) + static_cast<STD size_t>(comp(*base, key));
+}
+
+template <typename Key, typename K, typename Compare>
+inline STD size_t branchlessUpperBound(const Key* keys, STD size_t n, const K& key, const Compare& comp)
+{
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	const Key* base = keys;
+	while (n > 1)
+	{
+		const STD size_t half = n / 2;
+		base = comp(key, base[half]) ? base : base + half;
+		n -= half;
+	}
+
+	return static_cast<STD size_t>(base - keys) + static_cast<STD size_t>(!comp(key, *base));
+}
+
 JSTD_END
 
 #endif // !UTILITY
\ No newline at end of file
@@ -4,10 +4,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <iterator>
 #include <type_traits>
 #include <initializer_list>
+#include <ranges>
 #include <stdexcept>
 #include <string_view>
 
@@ -107,6 +110,8 @@ public:
 
 	VectorBase() = default;
 
+	VectorBase(VectorBase&&) = default;
+
 	VectorBase(const allocator_type& alloc) JLIBCXX_NOEXCEPT
 		: mImpl(alloc)
 	{ }
@@ -167,6 +172,12 @@ public:
 		deallocateArray(mImpl.mStart, mImpl.mEnd - mImpl.mStart);
 	}
 
+	// Exchange the storage, not the allocators.
+	void swapStorage(VectorBase& other) JLIBCXX_NOEXCEPT
+	{
+		mImpl.swapData(other.mImpl);
+	}
+
 protected:
 
 	void createStorage(STD size_t n)
@@ -177,8 +188,13 @@ protected:
 	}
 };
 
-template <typename T, typename Alloc = STD allocator<T>>
-class Vector : protected VectorBase<T, Alloc>
+/*
+* StorageBase owns the buffer. It defaults to VectorBase, SmallVector plugs in a base
+* with inline storage. A storage base provides createStorage, allocateArray,
+* deallocateArray, deallocateWholeArray and swapStorage.
+*/
+template <typename T, typename Alloc = STD allocator<T>, typename StorageBase = VectorBase<T, Alloc>>
+class Vector : protected StorageBase
 {
 private:
 
@@ -188,8 +204,10 @@ private:
 		"jstd::vector must have a non-const, non-volatile value_type.");
 	static_assert(STD is_same_v<typename Alloc::value_type, T>,
 		"jstd::vector must have the same value_type as its allocator.");
+	static_assert(JSTD_VECTOR_GROWTH_NUMERATOR > JSTD_VECTOR_GROWTH_DENOMINATOR,
+		"jstd::vector growth factor must be greater than 1.");
 
-	using Base = VectorBase<T, Alloc>;
+	using Base = StorageBase;
 	using T_Alloc_Type = typename Base::T_Alloc_Type;
 	using Alloc_Traits = MyAlloctTraits<T_Alloc_Type>;
 
@@ -232,28 +250,69 @@ private:
 		return n;
 	}
 
+	// Construct n elements from args at dest. Returns the new last.
 	template <typename... Args>
-	void initializeNValues(size_type n, Args&&... args)
+	pointer constructN(const pointer dest, size_type n, const Args&... args)
 	{
-		auto current = this->mImpl.mStart;
+		pointer current = dest;
 
 		TRY_START
 		for (; n; --n, ++current)
 		{
-			Alloc_Traits::construct(this->mImpl, STD addressof(*current), STD forward<Args>(args)...);
+			Alloc_Traits::construct(this->mImpl, STD addressof(*current), args...);
 		}
 
-		this->mImpl.mLast = current;
+		return current;
 		CATCH_ALL
-		myDestroy(this->mImpl.mStart, current, this->mImpl);
+		myDestroy(dest, current, this->mImpl);
 		THROW_AGAIN
 		END_CATCH
 	}
 
+	/*
+	* Default-initialize n elements at dest. Returns the new last.
+	* With an allocator whose construct is plain placement new (is_default_construct_allocator),
+	* trivial T is left uninitialized. Other allocators can only value-initialize through
+	* construct, so they get value-initialized elements.
+	*/
+	pointer defaultInitializeN(const pointer dest, size_type n)
+	{
+		if constexpr (!is_default_construct_allocator<T_Alloc_Type>::value)
+		{
+			return constructN(dest, n);
+		}
+		else if constexpr (STD is_trivially_default_constructible_v<T> && STD is_trivially_destructible_v<T>)
+		{
+			return dest + n;
+		}
+		else
+		{
+			pointer current = dest;
+
+			TRY_START
+			for (; n; --n, ++current)
+			{
+				::new(static_cast<void*>(STD to_address(current))) T;
+			}
+
+			return current;
+			CATCH_ALL
+			myDestroy(dest, current, this->mImpl);
+			THROW_AGAIN
+			END_CATCH
+		}
+	}
+
+	template <typename... Args>
+	void initializeNValues(size_type n, const Args&... args)
+	{
+		this->mImpl.mLast = constructN(this->mImpl.mStart, n, args...);
+	}
+
 	template <typename InputIterator>
 	void copyNValuesFromRanges(InputIterator first, InputIterator last)
 	{
-		InputIterator current = this->mImpl.mStart;
+		pointer current = this->mImpl.mStart;
 		TRY_START
 		for (; first != last; ++current, ++first)
 		{
@@ -321,7 +380,7 @@ public:
 		copyNValuesFromRanges(other.cbegin(), other.cend());
 	}
 
-	Vector(Vector&&) noexcept = default;
+	Vector(Vector&&) JLIBCXX_NOEXCEPT_IF(STD is_nothrow_move_constructible_v<Base>) = default;
 
 	Vector(const Vector& other, const allocator_type& alloc)
 		: Base(other.size(), alloc)
@@ -329,6 +388,26 @@ public:
 		copyNValuesFromRanges(other.cbegin(), other.cend());
 	}
 
+	/*
+	* Allocator-extended move constructor.
+	* Takes over the storage of other if alloc compares equal to its allocator,
+	* otherwise the elements are moved one by one into storage from alloc.
+	*/
+	Vector(Vector&& other, const allocator_type& alloc) JLIBCXX_NOEXCEPT_IF(Alloc_Traits::always_equal_v())
+		: Base(alloc)
+	{
+		if (Alloc_Traits::always_equal_v() || getTAllocator() == other.getTAllocator())
+		{
+			this->swapStorage(other);
+			return;
+		}
+
+		this->createStorage(other.size());
+		this->mImpl.mLast = uninitializedMoveAllocated(
+			other.mImpl.mStart, other.mImpl.mLast, this->mImpl.mStart, getTAllocator());
+		other.clear();
+	}
+
 	Vector(
 		STD initializer_list<value_type> ilist, 
 		const allocator_type& alloc = allocator_type())
@@ -342,12 +421,15 @@ private:
 	template <typename InputIterator>
 	void doRangeInitialize(InputIterator first, InputIterator last, STD input_iterator_tag)
 	{
-		ClearGuard guard{ this };
-
+		TRY_START
 		for (; first != last; ++first)
 		{
-			//emplace_back(*first);
+			emplace_back(*first);
 		}
+		CATCH_ALL
+		clear();
+		THROW_AGAIN
+		END_CATCH
 	}
 
 	template <typename InputIterator>
@@ -367,7 +449,7 @@ public:
 			const allocator_type& alloc = allocator_type())
 		: Base(alloc)
 	{
-		doRangeInitialize(first, last, STD iterator_traits<InputIterator>::iterator_category);
+		doRangeInitialize(first, last, iterator_category_t<InputIterator>{});
 	}
 
 	~Vector() JLIBCXX_NOEXCEPT
@@ -375,36 +457,171 @@ public:
 		clear();
 	}
 
-private:
+	/*
+	* If the allocator propagates on copy assignment and the two differ,
+	* the current storage is released with the old allocator first.
+	*/
+	Vector& operator=(const Vector& other)
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
 
-	template <typename InputIterator>
-	void assignRange(InputIterator first, InputIterator last, STD input_iterator_tag)
+		if constexpr (Alloc_Traits::propagate_on_container_copy_assignment_v())
+		{
+			if (!Alloc_Traits::always_equal_v() && getTAllocator() != other.getTAllocator())
+			{
+				clear();
+				this->deallocateWholeArray();
+				this->mImpl.mStart = pointer();
+				this->mImpl.mLast = pointer();
+				this->mImpl.mEnd = pointer();
+			}
+
+			Alloc_Traits::doCopy(getTAllocator(), other.getTAllocator());
+		}
+
+		assignCounted(other.mImpl.mStart, other.size());
+		return *this;
+	}
+
+	/*
+	* Steals the storage if the allocator propagates or both compare equal.
+	* Otherwise other's allocator cannot free our memory, so the elements are moved one by one.
+	*/
+	Vector& operator=(Vector&& other) JLIBCXX_NOEXCEPT_IF(Alloc_Traits::nothrow_move()
+		&& noexcept(STD declval<Base&>().swapStorage(STD declval<Base&>())))
+	{
+		if (this == STD addressof(other))
+		{
+			return *this;
+		}
+
+		if constexpr (!Alloc_Traits::nothrow_move())
+		{
+			if (getTAllocator() != other.getTAllocator())
+			{
+				assignCounted(STD make_move_iterator(other.mImpl.mStart), other.size());
+				other.clear();
+				return *this;
+			}
+		}
+
+		// The old storage is released by temp, with the allocator it came from.
+		Vector temp(get_allocator());
+		this->swapStorage(temp);
+		this->swapStorage(other);
+		Alloc_Traits::doMove(getTAllocator(), other.getTAllocator());
+		return *this;
+	}
+
+	Vector& operator=(STD initializer_list<value_type> ilist)
 	{
+		assign(ilist);
+		return *this;
+	}
 
+private:
 
+	// Overwrite the elements and append or erase the difference. Works for single pass ranges.
+	template <typename InputIterator, typename Sentinel>
+	void assignInput(InputIterator first, Sentinel last)
+	{
+		pointer current = this->mImpl.mStart;
+		for (; first != last && current != this->mImpl.mLast; ++first, ++current)
+		{
+			*current = *first;
+		}
 
+		if (first == last)
+		{
+			eraseToEnd(current);
+			return;
+		}
+
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
 	}
 
-	template <typename InputIterator>
-	void assignRange(InputIterator first, InputIterator last, STD forward_iterator_tag)
+	// Assign n elements starting at first, reallocating at most once.
+	template <typename ForwardIterator>
+	void assignCounted(ForwardIterator first, const size_type n)
 	{
-		const auto length = myDistance(first, last);
+		if (n > capacity())
+		{
+			const size_type len = checkLength(n, get_allocator());
+			pointer newStart = this->allocateArray(len);
+
+			TRY_START
+			uninitializedCopyNAllocated(first, n, newStart, getTAllocator());
+			CATCH_ALL
+			this->deallocateArray(newStart, len);
+			THROW_AGAIN
+			END_CATCH
+
+			clear();
+			this->deallocateWholeArray();
+			this->mImpl.mStart = newStart;
+			this->mImpl.mLast = newStart + n;
+			this->mImpl.mEnd = newStart + len;
+			return;
+		}
 
+		const size_type oldSize = size();
+		if (oldSize >= n)
+		{
+			eraseToEnd(STD copy_n(first, n, this->mImpl.mStart));
+			return;
+		}
 
+		ForwardIterator mid = first;
+		STD advance(mid, oldSize);
+		STD copy(first, mid, this->mImpl.mStart);
+		this->mImpl.mLast = uninitializedCopyNAllocated(mid, n - oldSize, this->mImpl.mLast, getTAllocator());
 	}
 
+	template <typename InputIterator>
+	void assignRange(InputIterator first, InputIterator last, STD input_iterator_tag)
+	{
+		assignInput(first, last);
+	}
 
+	template <typename InputIterator>
+	void assignRange(InputIterator first, InputIterator last, STD forward_iterator_tag)
+	{
+		assignCounted(first, static_cast<size_type>(myDistance(first, last)));
+	}
 
 
 public:
 
 	constexpr void assign(size_type count, const_reference value)
 	{
-		// Reallocate and swap.
+		/*
+		 * Reallocate through our own allocator, as assignCounted does; a
+		 * temporary Vector would use a default-constructed one. value may
+		 * live in the old buffer, so it is released only after the fill.
+		 */
 		if (count > capacity())
 		{
-			Vector temp(count, value);
-			temp.mImpl.swapData(mImpl);
+			const size_type len = checkLength(count, get_allocator());
+			pointer newStart = this->allocateArray(len);
+
+			TRY_START
+			uninitializedFillRanges(newStart, count, value, getTAllocator());
+			CATCH_ALL
+			this->deallocateArray(newStart, len);
+			THROW_AGAIN
+			END_CATCH
+
+			clear();
+			this->deallocateWholeArray();
+			this->mImpl.mStart = newStart;
+			this->mImpl.mLast = newStart + count;
+			this->mImpl.mEnd = newStart + len;
 			return;
 		}
 
@@ -505,9 +722,66 @@ public:
 		return maxSize(this->getTAllocator());
 	}
 
+private:
+
+	// Grow by n elements built by initializer(dest, n), reallocating at most once.
+	template <typename Initializer>
+	void appendN(const size_type n, Initializer initializer)
+	{
+		if (static_cast<size_type>(this->mImpl.mEnd - this->mImpl.mLast) >= n)
+		{
+			this->mImpl.mLast = initializer(this->mImpl.mLast, n);
+			return;
+		}
+
+		reallocateAndConstruct(this->mImpl.mLast, n, "Vector::resize",
+			[&](pointer dest)
+			{
+				initializer(dest, n);
+			});
+	}
+
+public:
+
 	void resize(const size_type newSize)
 	{
-		
+		if (newSize > size())
+		{
+			appendN(newSize - size(), [this](pointer dest, size_type n) { return constructN(dest, n); });
+		}
+		else
+		{
+			eraseToEnd(this->mImpl.mStart + newSize);
+		}
+	}
+
+	void resize(const size_type newSize, const_reference value)
+	{
+		if (newSize > size())
+		{
+			insertFill(this->mImpl.mLast, newSize - size(), value);
+		}
+		else
+		{
+			eraseToEnd(this->mImpl.mStart + newSize);
+		}
+	}
+
+	/*
+	* Like resize, but new elements are default-initialized instead of value-initialized.
+	* For trivial T the new elements are left uninitialized, use it when they are
+	* overwritten right away.
+	*/
+	void resize_for_overwrite(const size_type newSize)
+	{
+		if (newSize > size())
+		{
+			appendN(newSize - size(), [this](pointer dest, size_type n) { return defaultInitializeN(dest, n); });
+		}
+		else
+		{
+			eraseToEnd(this->mImpl.mStart + newSize);
+		}
 	}
 
 	void shrink_to_fit()
@@ -516,11 +790,8 @@ public:
 		{
 			return;
 		}
-		
-		Vector(makeMoveIfNoexceptIterator(begin()),
-			makeMoveIfNoexceptIterator(end()), 
-			get_allocator())
-		.swap(*this);
+
+		reallocateExactly(size());
 	}
 
 	NODISCARD size_type capacity() const JLIBCXX_NOEXCEPT
@@ -535,7 +806,17 @@ public:
 
 	void reserve(const size_type n)
 	{
-		
+		if (n > max_size())
+		{
+			throwLengthError("Vector::reserve");
+		}
+
+		if (capacity() >= n)
+		{
+			return;
+		}
+
+		reallocateExactly(n);
 	}
 
 	NODISCARD reference operator[](size_type n) JLIBCXX_NOEXCEPT
@@ -618,35 +899,111 @@ private:
 			throwLengthError(string);
 		}
 
-		const auto newLen = size() + STD max(size(), n);
+		// Grow geometrically, but never by less than n.
+		const size_type growth = size() / JSTD_VECTOR_GROWTH_DENOMINATOR
+			* (JSTD_VECTOR_GROWTH_NUMERATOR - JSTD_VECTOR_GROWTH_DENOMINATOR);
+		const auto newLen = size() + STD max(growth, n);
 		return newLen < size() || newLen > max_size() ? max_size() : newLen;
 	}
 
-	// TODO:
-	template <typename... Args>
-	void reallocateInsert(iterator pos, Args&&... args)
+	/*
+	* Growth relocates when that cannot throw: one memmove for trivially relocatable types,
+	* otherwise a nothrow move and destroy per element. Same allocator rule as myDestroy.
+	*/
+	static constexpr bool useRelocate = is_nothrow_relocatable_v<T, T_Alloc_Type>;
+
+	// Elements of a contiguous source of T can be copied in with memmove.
+	template <typename Iterator>
+	static constexpr bool bitwiseCopyableFrom = is_memcpy_copyable_v<Iterator, pointer, T_Alloc_Type>;
+
+	/*
+	* Relocate [first, last) into the uninitialized storage at dest and return the new last.
+	* If relocation may throw, the elements are moved if the move constructor is noexcept and
+	* copied if not, so a throw leaves the source untouched. The source is then destroyed by
+	* the caller once the whole operation succeeded.
+	*/
+	static pointer relocateForGrowth(pointer first, pointer last, pointer dest, T_Alloc_Type& alloc)
+	{
+		if constexpr (useRelocate)
+		{
+			return myRelocate(first, last, dest, alloc);
+		}
+		else
+		{
+			return uninitializedCopyAllocated(
+				makeMoveIfNoexceptIterator(first),
+				makeMoveIfNoexceptIterator(last),
+				dest,
+				alloc);
+		}
+	}
+
+	// Move the elements into exactly len new slots, len >= size().
+	void reallocateExactly(const size_type len)
+	{
+		pointer newStart = this->allocateArray(len);
+		pointer newLast;
+
+		TRY_START
+		newLast = relocateForGrowth(this->mImpl.mStart, this->mImpl.mLast, newStart, getTAllocator());
+		CATCH_ALL
+		this->deallocateArray(newStart, len);
+		THROW_AGAIN
+		END_CATCH
+
+		replaceStorage(newStart, newLast, len);
+	}
+
+	// Destroy and free the current storage and adopt [newStart, newStart + len).
+	void replaceStorage(pointer newStart, pointer newLast, const size_type len) JLIBCXX_NOEXCEPT
 	{
-		const auto len = checkLengthByAndDisplayStr(static_cast<size_type>(1), "Vector::reallocateInsert");
-		auto oldStart = this->mImpl.mStart;
-		auto oldLast = this->mImpl.mLast;
-		const auto elementBefore = pos - begin();
+		// Relocated elements already ended their lifetime in the old storage.
+		if constexpr (!useRelocate)
+		{
+			myDestroy(this->mImpl.mStart, this->mImpl.mLast, getTAllocator());
+		}
+
+		this->deallocateWholeArray();
+		this->mImpl.mStart = newStart;
+		this->mImpl.mLast = newLast;
+		this->mImpl.mEnd = newStart + len;
+	}
+
+	/*
+	* Grow the storage to fit n more elements and let constructNew build them before pos.
+	* constructNew must clean up after itself if it throws.
+	*
+	* Provides the strong exception guarantee unless T has a throwing move
+	* constructor and is not copy constructible.
+	*/
+	template <typename ConstructNew>
+	void reallocateAndConstruct(pointer pos, const size_type n, const char* what, ConstructNew constructNew)
+	{
+		const auto len = checkLengthByAndDisplayStr(n, what);
+		const pointer oldStart = this->mImpl.mStart;
+		const pointer oldLast = this->mImpl.mLast;
+		const auto elementBefore = pos - oldStart;
 		pointer newStart = this->allocateArray(len);
 		pointer newLast = newStart;
+		bool constructed = false;
 
 		TRY_START
 
-		Alloc_Traits::construct(getTAllocator(), newStart + elementBefore, STD forward<Args>(args)...);
+		// Construct the new elements first, they may refer to elements of the old storage.
+		constructNew(newStart + elementBefore);
+		constructed = true;
 		newLast = pointer();
 
-
+		newLast = relocateForGrowth(oldStart, pos, newStart, getTAllocator()) + n;
+		newLast = relocateForGrowth(pos, oldLast, newLast, getTAllocator());
 
 		CATCH_ALL
 
 		if (!newLast)
 		{
-			Alloc_Traits::destroy(getTAllocator(), newStart + elementBefore);
+			myDestroy(newStart + elementBefore, newStart + elementBefore + n, getTAllocator());
 		}
-		else
+		else if (constructed)
 		{
 			myDestroy(newStart, newLast, getTAllocator());
 		}
@@ -656,7 +1013,145 @@ private:
 		THROW_AGAIN
 		END_CATCH
 
+		replaceStorage(newStart, newLast, len);
+	}
+
+	// Grow the storage and construct a new element before pos.
+	template <typename... Args>
+	void reallocateInsert(iterator pos, Args&&... args)
+	{
+		reallocateAndConstruct(pos.base(), static_cast<size_type>(1), "Vector::reallocateInsert",
+			[&](pointer dest)
+			{
+				Alloc_Traits::construct(getTAllocator(), dest, STD forward<Args>(args)...);
+			});
+	}
+
+	pointer toPointer(const_iterator pos) JLIBCXX_NOEXCEPT
+	{
+		return this->mImpl.mStart + (pos - cbegin());
+	}
+
+	// Insert n elements copied from first before pos, reallocating at most once.
+	template <typename ForwardIterator>
+	void insertCounted(pointer pos, ForwardIterator first, const size_type n)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		if (static_cast<size_type>(this->mImpl.mEnd - this->mImpl.mLast) < n)
+		{
+			reallocateAndConstruct(pos, n, "Vector::insert",
+				[&](pointer dest)
+				{
+					uninitializedCopyNAllocated(first, n, dest, getTAllocator());
+				});
+
+			return;
+		}
+
+		auto& alloc = getTAllocator();
+		const pointer oldLast = this->mImpl.mLast;
+		const auto elementsAfter = static_cast<size_type>(oldLast - pos);
+
+		if constexpr (bitwiseCopyableFrom<ForwardIterator>)
+		{
+			STD memmove(STD to_address(pos + n), STD to_address(pos), elementsAfter * sizeof(T));
+			STD memmove(STD to_address(pos), STD to_address(first), n * sizeof(T));
+			this->mImpl.mLast += n;
+		}
+		else if (elementsAfter > n)
+		{
+			uninitializedMoveAllocated(oldLast - n, oldLast, oldLast, alloc);
+			this->mImpl.mLast += n;
+			STD move_backward(pos, oldLast - n, oldLast);
+			STD copy_n(first, n, pos);
+		}
+		else
+		{
+			ForwardIterator mid = first;
+			STD advance(mid, elementsAfter);
+			this->mImpl.mLast = uninitializedCopyNAllocated(mid, n - elementsAfter, oldLast, alloc);
+			this->mImpl.mLast = uninitializedMoveAllocated(pos, oldLast, this->mImpl.mLast, alloc);
+			STD copy(first, mid, pos);
+		}
+	}
+
+	// Insert n copies of value before pos, reallocating at most once.
+	void insertFill(pointer pos, const size_type n, const value_type& value)
+	{
+		if (n == 0)
+		{
+			return;
+		}
+
+		if (static_cast<size_type>(this->mImpl.mEnd - this->mImpl.mLast) < n)
+		{
+			reallocateAndConstruct(pos, n, "Vector::insert",
+				[&](pointer dest)
+				{
+					uninitializedFillRanges(dest, n, value, getTAllocator());
+				});
+
+			return;
+		}
+
+		// value may refer to an element that is about to move.
+		const value_type copy(value);
+		auto& alloc = getTAllocator();
+		const pointer oldLast = this->mImpl.mLast;
+		const auto elementsAfter = static_cast<size_type>(oldLast - pos);
+
+		if (elementsAfter > n)
+		{
+			uninitializedMoveAllocated(oldLast - n, oldLast, oldLast, alloc);
+			this->mImpl.mLast += n;
+			STD move_backward(pos, oldLast - n, oldLast);
+			fillN(pos, n, copy);
+		}
+		else
+		{
+			this->mImpl.mLast = uninitializedFillRanges(oldLast, n - elementsAfter, copy, alloc);
+			this->mImpl.mLast = uninitializedMoveAllocated(pos, oldLast, this->mImpl.mLast, alloc);
+			fillRanges(pos, oldLast, copy);
+		}
+	}
+
+	// Single pass ranges cannot be measured, buffer them unless we append.
+	template <typename InputIterator, typename Sentinel>
+	void insertInput(pointer pos, InputIterator first, Sentinel last)
+	{
+		if (pos == this->mImpl.mLast)
+		{
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+
+			return;
+		}
+
+		Vector temp(get_allocator());
+		for (; first != last; ++first)
+		{
+			temp.emplace_back(*first);
+		}
+
+		insertCounted(pos, STD make_move_iterator(temp.begin()), temp.size());
+	}
 
+	template <typename InputIterator>
+	void insertRange(pointer pos, InputIterator first, InputIterator last, STD input_iterator_tag)
+	{
+		insertInput(pos, first, last);
+	}
+
+	template <typename ForwardIterator>
+	void insertRange(pointer pos, ForwardIterator first, ForwardIterator last, STD forward_iterator_tag)
+	{
+		insertCounted(pos, first, static_cast<size_type>(myDistance(first, last)));
 	}
 
 public:
@@ -681,20 +1176,144 @@ public:
 		}
 		else
 		{
-			reallocateInsert(cend(), STD forward<Args>(args)...);
+			reallocateInsert(end(), STD forward<Args>(args)...);
 		}
 
 		return back();
 	}
 
+	void pop_back() JLIBCXX_NOEXCEPT
+	{
+		--this->mImpl.mLast;
+		Alloc_Traits::destroy(getTAllocator(), this->mImpl.mLast);
+	}
 
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args)
+	{
+		const auto offset = pos - cbegin();
+		const pointer position = this->mImpl.mStart + offset;
 
+		if (this->mImpl.mLast == this->mImpl.mEnd)
+		{
+			reallocateInsert(iterator(position), STD forward<Args>(args)...);
+		}
+		else if (position == this->mImpl.mLast)
+		{
+			Alloc_Traits::construct(getTAllocator(), this->mImpl.mLast, STD forward<Args>(args)...);
+			++this->mImpl.mLast;
+		}
+		else
+		{
+			// Build the value first, args may refer to an element that is about to move.
+			value_type temp(STD forward<Args>(args)...);
+			Alloc_Traits::construct(getTAllocator(), this->mImpl.mLast, STD move(*(this->mImpl.mLast - 1)));
+			++this->mImpl.mLast;
+			STD move_backward(position, this->mImpl.mLast - 2, this->mImpl.mLast - 1);
+			*position = STD move(temp);
+		}
 
+		return iterator(this->mImpl.mStart + offset);
+	}
 
+	iterator insert(const_iterator pos, const_reference value)
+	{
+		return emplace(pos, value);
+	}
 
-	void swap(Vector& other) JLIBCXX_NOEXCEPT
+	iterator insert(const_iterator pos, value_type&& value)
 	{
-		mImpl.swapData(other.mImpl);
+		return emplace(pos, STD move(value));
+	}
+
+	iterator insert(const_iterator pos, size_type count, const_reference value)
+	{
+		const auto offset = pos - cbegin();
+		insertFill(toPointer(pos), count, value);
+		return iterator(this->mImpl.mStart + offset);
+	}
+
+	/*
+	* Forward ranges are measured once and inserted with at most one reallocation.
+	* The range must not point into this vector.
+	*/
+	template <typename InputIt, typename = RequireInputIter<InputIt>>
+	iterator insert(const_iterator pos, InputIt first, InputIt last)
+	{
+		const auto offset = pos - cbegin();
+		insertRange(toPointer(pos), first, last, iterator_category_t<InputIt>{});
+		return iterator(this->mImpl.mStart + offset);
+	}
+
+	iterator insert(const_iterator pos, STD initializer_list<value_type> ilist)
+	{
+		return insert(pos, ilist.begin(), ilist.end());
+	}
+
+	template <typename Range>
+	iterator insert_range(const_iterator pos, Range&& range)
+	{
+		const auto offset = pos - cbegin();
+
+		if constexpr (STD ranges::forward_range<Range>)
+		{
+			insertCounted(toPointer(pos),
+				STD ranges::begin(range),
+				static_cast<size_type>(STD ranges::distance(range)));
+		}
+		else
+		{
+			insertInput(toPointer(pos), STD ranges::begin(range), STD ranges::end(range));
+		}
+
+		return iterator(this->mImpl.mStart + offset);
+	}
+
+	template <typename Range>
+	void append_range(Range&& range)
+	{
+		insert_range(cend(), STD forward<Range>(range));
+	}
+
+	template <typename Range>
+	void assign_range(Range&& range)
+	{
+		if constexpr (STD ranges::forward_range<Range>)
+		{
+			assignCounted(STD ranges::begin(range), static_cast<size_type>(STD ranges::distance(range)));
+		}
+		else
+		{
+			assignInput(STD ranges::begin(range), STD ranges::end(range));
+		}
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		const pointer position = toPointer(pos);
+		if (position + 1 != this->mImpl.mLast)
+		{
+			STD move(position + 1, this->mImpl.mLast, position);
+		}
+
+		pop_back();
+		return iterator(position);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		const pointer start = toPointer(first);
+		if (first != last)
+		{
+			eraseToEnd(STD move(toPointer(last), this->mImpl.mLast, start));
+		}
+
+		return iterator(start);
+	}
+
+	void swap(Vector& other) JLIBCXX_NOEXCEPT_IF(noexcept(STD declval<Base&>().swapStorage(STD declval<Base&>())))
+	{
+		this->swapStorage(other);
 		Alloc_Traits::doSwap(getTAllocator(), other.getTAllocator());
 	}
 
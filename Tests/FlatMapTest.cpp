@@ -0,0 +1,157 @@
+/*
+* FlatMap / FlatSet checks. Standalone program:
+*   g++ -std=c++20 -I../MyList FlatMapTest.cpp && ./a.out
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FlatMap.h"
+
+namespace
+{
+
+// Copies and moves left before the next one throws.
+int operationsLeft = 1 << 30;
+
+struct Throwing
+{
+	int mValue;
+
+	explicit Throwing(const int value)
+		: mValue(value)
+	{ }
+
+	Throwing(const Throwing& other)
+		: mValue(other.mValue)
+	{
+		tick();
+	}
+
+	Throwing(Throwing&& other) noexcept(false)
+		: mValue(other.mValue)
+	{
+		tick();
+	}
+
+	Throwing& operator=(const Throwing& other)
+	{
+		tick();
+		mValue = other.mValue;
+		return *this;
+	}
+
+	Throwing& operator=(Throwing&& other) noexcept(false)
+	{
+		tick();
+		mValue = other.mValue;
+		return *this;
+	}
+
+	static void tick()
+	{
+		if (--operationsLeft < 0)
+		{
+			throw std::runtime_error("copy failed");
+		}
+	}
+};
+
+using Map = jstd::FlatMap<std::string, Throwing>;
+
+std::string keyOf(const int i)
+{
+	// Long enough to live on the heap, so a moved-from key reads back as "".
+	return "key-number-" + std::to_string(1000 + i) + "-padding-padding";
+}
+
+void checkSame(const Map& map, const std::vector<std::pair<std::string, int>>& expected)
+{
+	assert(map.size() == expected.size());
+	for (std::size_t i = 0; i < expected.size(); ++i)
+	{
+		assert(map.keys()[i] == expected[i].first);
+		assert(map.values()[i].mValue == expected[i].second);
+	}
+}
+
+// A throwing value copy in the merge must leave the old elements untouched.
+void mergeRollback()
+{
+	std::vector<std::pair<std::string, int>> before;
+	for (int i = 0; i < 40; i += 2)
+	{
+		before.emplace_back(keyOf(i), i);
+	}
+
+	std::vector<std::pair<std::string, Throwing>> incoming;
+	for (int i = 1; i < 40; i += 4)
+	{
+		incoming.emplace_back(keyOf(i), Throwing(-i));
+	}
+
+	bool finished = false;
+	for (int budget = 0; !finished; ++budget)
+	{
+		operationsLeft = 1 << 30;
+		Map map;
+		for (const auto& [key, value] : before)
+		{
+			map.try_emplace(key, value);
+		}
+
+		operationsLeft = budget;
+		try
+		{
+			map.insert(incoming.begin(), incoming.end());
+			finished = true;
+		}
+		catch (const std::runtime_error&)
+		{
+			operationsLeft = 1 << 30;
+			checkSame(map, before);
+		}
+
+		operationsLeft = 1 << 30;
+		if (finished)
+		{
+			auto after = before;
+			for (const auto& [key, value] : incoming)
+			{
+				after.emplace_back(key, value.mValue);
+			}
+
+			std::sort(after.begin(), after.end());
+			checkSame(map, after);
+			std::printf("merge rollback: ok after %d throwing runs\n", budget);
+		}
+	}
+}
+
+void basics()
+{
+	jstd::FlatMap<int, int> map{ { 3, 30 }, { 1, 10 }, { 2, 20 }, { 1, 99 } };
+	assert(map.size() == 3 && map.keys()[0] == 1 && map.values()[0] == 10);
+
+	const std::vector<std::pair<int, int>> more{ { 0, 0 }, { 2, 0 }, { 5, 50 } };
+	map.insert(more.begin(), more.end());
+	assert(map.size() == 5 && map.values()[1] == 10 && map.values()[2] == 20);
+
+	jstd::FlatSet<int> set{ 5, 1, 4, 1 };
+	assert(set.size() == 3 && *set.begin() == 1);
+	std::puts("basics: ok");
+}
+
+}
+
+int main()
+{
+	basics();
+	mergeRollback();
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+* MpmcQueue stress test and scaling benchmark. Standalone program:
+*   g++ -std=c++20 -O2 -pthread -I../MyList MpmcQueueStress.cpp
+*   ./a.out          stress test
+*   ./a.out bench    throughput from 1 to 64 threads
+*
+* The stress test encodes (producer, sequence) in every item and checks
+* that nothing is lost or duplicated, and that each consumer sees the
+* items of any one producer in the order they were pushed, which a
+* linearizable FIFO queue guarantees.
+*/
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Queue.h"
+
+namespace
+{
+
+using Item = std::uint64_t;
+
+Item makeItem(const std::uint64_t producer, const std::uint64_t sequence)
+{
+	return (producer << 32) | sequence;
+}
+
+std::uint64_t producerOf(const Item item)
+{
+	return item >> 32;
+}
+
+std::uint64_t sequenceOf(const Item item)
+{
+	return item & 0xFFFFFFFFu;
+}
+
+// Each consumer's items in the order it popped them.
+using Log = std::vector<Item>;
+
+void check(const std::vector<Log>& logs, const std::size_t producers, const std::size_t perProducer)
+{
+	std::vector<unsigned char> seen(producers * perProducer, 0);
+	std::size_t total = 0;
+
+	for (const Log& log : logs)
+	{
+		std::vector<std::int64_t> last(producers, -1);
+		for (const Item item : log)
+		{
+			const std::uint64_t producer = producerOf(item);
+			const std::uint64_t sequence = sequenceOf(item);
+			assert(producer < producers && sequence < perProducer);
+
+			// No duplicate anywhere.
+			assert(seen[producer * perProducer + sequence] == 0);
+			seen[producer * perProducer + sequence] = 1;
+
+			// Per-producer FIFO as seen by this consumer.
+			assert(static_cast<std::int64_t>(sequence) > last[producer]);
+			last[producer] = static_cast<std::int64_t>(sequence);
+		}
+
+		total += log.size();
+	}
+
+	// No loss.
+	assert(total == producers * perProducer);
+}
+
+// Blocking push and pop, each consumer pops an exact share.
+void stressBlocking(const std::size_t producers, const std::size_t consumers, const std::size_t perProducer, const std::size_t capacity)
+{
+	jstd::MpmcQueue<Item> queue(capacity);
+	std::vector<Log> logs(consumers);
+	std::vector<std::thread> threads;
+	const std::size_t total = producers * perProducer;
+
+	for (std::size_t c = 0; c < consumers; ++c)
+	{
+		const std::size_t share = total / consumers + (c < total % consumers ? 1 : 0);
+		threads.emplace_back([&queue, &logs, c, share]
+		{
+			logs[c].reserve(share);
+			for (std::size_t i = 0; i < share; ++i)
+			{
+				Item item = 0;
+				queue.pop(item);
+				logs[c].push_back(item);
+			}
+		});
+	}
+
+	for (std::size_t p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&queue, p, perProducer]
+		{
+			for (std::size_t i = 0; i < perProducer; ++i)
+			{
+				queue.push(makeItem(p, i));
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	assert(queue.empty());
+	check(logs, producers, perProducer);
+}
+
+// try_push and try_pop only, retrying on a full or empty queue.
+void stressTry(const std::size_t producers, const std::size_t consumers, const std::size_t perProducer, const std::size_t capacity)
+{
+	jstd::MpmcQueue<Item> queue(capacity);
+	std::vector<Log> logs(consumers);
+	std::vector<std::thread> threads;
+	const std::size_t total = producers * perProducer;
+	std::atomic<std::size_t> popped{ 0 };
+
+	for (std::size_t c = 0; c < consumers; ++c)
+	{
+		threads.emplace_back([&queue, &logs, &popped, c, total]
+		{
+			while (popped.load(std::memory_order_relaxed) < total)
+			{
+				Item item = 0;
+				if (queue.try_pop(item))
+				{
+					logs[c].push_back(item);
+					popped.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (std::size_t p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&queue, p, perProducer]
+		{
+			for (std::size_t i = 0; i < perProducer; ++i)
+			{
+				while (!queue.try_push(makeItem(p, i)))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	assert(queue.empty());
+	check(logs, producers, perProducer);
+}
+
+void stress()
+{
+	const std::size_t shapes[][2] = { { 1, 1 }, { 1, 8 }, { 8, 1 }, { 4, 4 }, { 16, 16 }, { 32, 32 } };
+	const std::size_t capacities[] = { 2, 64, 4096 };
+
+	for (const auto& shape : shapes)
+	{
+		for (const std::size_t capacity : capacities)
+		{
+			const std::size_t perProducer = 200000 / shape[0];
+			stressBlocking(shape[0], shape[1], perProducer, capacity);
+			stressTry(shape[0], shape[1], perProducer, capacity);
+			std::printf("%2zu producers, %2zu consumers, capacity %4zu: ok\n", shape[0], shape[1], capacity);
+		}
+	}
+}
+
+// Millions of items through the queue per second, threads split between producers and consumers.
+double throughput(const std::size_t threads, const std::size_t items)
+{
+	jstd::MpmcQueue<Item> queue(1024);
+	const auto start = std::chrono::steady_clock::now();
+
+	if (threads == 1)
+	{
+		for (std::size_t i = 0; i < items; ++i)
+		{
+			queue.push(i);
+			Item item = 0;
+			queue.pop(item);
+		}
+	}
+	else
+	{
+		const std::size_t producers = threads / 2;
+		const std::size_t consumers = threads - producers;
+		std::vector<std::thread> pool;
+
+		for (std::size_t c = 0; c < consumers; ++c)
+		{
+			const std::size_t share = items / consumers + (c < items % consumers ? 1 : 0);
+			pool.emplace_back([&queue, share]
+			{
+				Item item = 0;
+				for (std::size_t i = 0; i < share; ++i)
+				{
+					queue.pop(item);
+				}
+			});
+		}
+
+		for (std::size_t p = 0; p < producers; ++p)
+		{
+			const std::size_t share = items / producers + (p < items % producers ? 1 : 0);
+			pool.emplace_back([&queue, share]
+			{
+				for (std::size_t i = 0; i < share; ++i)
+				{
+					queue.push(i);
+				}
+			});
+		}
+
+		for (std::thread& thread : pool)
+		{
+			thread.join();
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return static_cast<double>(items) / elapsed.count() / 1e6;
+}
+
+void bench()
+{
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	for (std::size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		std::printf("%2zu threads: %7.2f M items/s\n", threads, throughput(threads, 4000000));
+	}
+}
+
+}
+
+int main(const int argc, const char* const argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "bench") == 0)
+	{
+		bench();
+	}
+	else
+	{
+		stress();
+	}
+
+	return 0;
+}
@@ -0,0 +1,198 @@
+/*
+* PriorityQueue / DaryHeap checks and arity benchmark. Standalone program:
+*   g++ -std=c++20 -O2 -I../MyList PriorityQueueTest.cpp
+*   ./a.out          ordering checks for arities 2, 3, 4 and 8
+*   ./a.out bench    push/pop timings for arities 2, 4 and 8
+*/
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "PritorityQueue.h"
+
+namespace
+{
+
+template <typename T, std::size_t Arity, typename Compare = std::less<T>>
+using Queue = jstd::PriorityQueue<T, std::vector<T>, Compare, jstd::DaryHeap<Arity>>;
+
+/*
+* Random push, push_range and pop_top against a std::multiset. push_range
+* batches are both small (sift up one by one) and large (heapify).
+*/
+template <std::size_t Arity, typename Compare>
+void ordering(const unsigned seed)
+{
+	std::mt19937 rng(seed);
+	Queue<int, Arity, Compare> queue;
+	std::multiset<int, Compare> model;
+
+	for (int step = 0; step < 6000; ++step)
+	{
+		const unsigned action = rng() % 10;
+		if (action < 3)
+		{
+			const int value = static_cast<int>(rng() % 1000);
+			queue.push(value);
+			model.insert(value);
+		}
+		else if (action < 5)
+		{
+			std::vector<int> batch(rng() % 2 ? rng() % 4 : rng() % 400);
+			for (int& value : batch)
+			{
+				value = static_cast<int>(rng() % 1000);
+				model.insert(value);
+			}
+
+			queue.push_range(batch);
+		}
+		else
+		{
+			// The top is the last element in the model's order.
+			for (unsigned pops = rng() % 50; pops != 0 && !model.empty(); --pops)
+			{
+				const auto expected = std::prev(model.end());
+				assert(queue.top() == *expected);
+				assert(queue.pop_top() == *expected);
+				model.erase(expected);
+			}
+		}
+
+		assert(queue.size() == model.size());
+	}
+
+	while (!model.empty())
+	{
+		const auto expected = std::prev(model.end());
+		assert(queue.pop_top() == *expected);
+		model.erase(expected);
+	}
+
+	assert(queue.empty());
+}
+
+// pop_top hands out the element by move, which also works for strings.
+template <std::size_t Arity>
+void popTopStrings()
+{
+	Queue<std::string, Arity> queue;
+	std::vector<std::string> words;
+	for (int i = 0; i < 500; ++i)
+	{
+		words.push_back(std::string(30, 'a') + std::to_string((i * 7919) % 500 + 1000));
+	}
+
+	queue.push_range(words);
+	std::string previous = queue.pop_top();
+	while (!queue.empty())
+	{
+		const std::string next = queue.pop_top();
+		assert(next.size() == 34 && next <= previous);
+		previous = next;
+	}
+}
+
+template <std::size_t Arity>
+void checkArity()
+{
+	for (unsigned seed = 1; seed <= 4; ++seed)
+	{
+		ordering<Arity, std::less<int>>(seed);
+		ordering<Arity, std::greater<int>>(seed);
+	}
+
+	popTopStrings<Arity>();
+	std::printf("arity %zu: push, push_range and pop_top ordering ok\n", Arity);
+}
+
+struct Wide
+{
+	std::uint64_t mKey;
+	std::uint64_t mPayload;
+
+	bool operator<(const Wide& other) const
+	{
+		return mKey < other.mKey;
+	}
+};
+
+template <typename Q, typename T>
+void timeQueue(const char* name, const std::vector<T>& input)
+{
+	Q queue;
+	const auto start = std::chrono::steady_clock::now();
+	for (const T& value : input)
+	{
+		queue.push(value);
+	}
+
+	const auto pushed = std::chrono::steady_clock::now();
+	std::uint64_t sum = 0;
+	while (!queue.empty())
+	{
+		sum += reinterpret_cast<const std::uint64_t&>(queue.top());
+		queue.pop();
+	}
+
+	const auto popped = std::chrono::steady_clock::now();
+	const std::chrono::duration<double, std::milli> push = pushed - start;
+	const std::chrono::duration<double, std::milli> pop = popped - pushed;
+	std::printf("  %-22s push %8.1f ms  pop %8.1f ms  (%llu)\n", name, push.count(), pop.count(),
+		static_cast<unsigned long long>(sum & 0xFF));
+}
+
+template <typename T>
+void benchType(const char* label, const std::size_t n)
+{
+	std::mt19937_64 rng(42);
+	std::vector<T> input(n);
+	for (T& value : input)
+	{
+		std::memset(&value, 0, sizeof(T));
+		reinterpret_cast<std::uint64_t&>(value) = rng();
+	}
+
+	std::printf("%s, %zu elements\n", label, n);
+	timeQueue<std::priority_queue<T>>("std::priority_queue", input);
+	timeQueue<Queue<T, 2>>("DaryHeap<2>", input);
+	timeQueue<Queue<T, 4>>("DaryHeap<4>", input);
+	timeQueue<Queue<T, 8>>("DaryHeap<8>", input);
+}
+
+void bench()
+{
+	for (const std::size_t n : { std::size_t(1) << 20, std::size_t(1) << 23 })
+	{
+		benchType<std::uint64_t>("uint64_t", n);
+		benchType<Wide>("16-byte struct", n);
+	}
+}
+
+}
+
+int main(const int argc, const char* const argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "bench") == 0)
+	{
+		bench();
+	}
+	else
+	{
+		checkArity<2>();
+		checkArity<3>();
+		checkArity<4>();
+		checkArity<8>();
+	}
+
+	return 0;
+}
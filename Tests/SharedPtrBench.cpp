@@ -0,0 +1,111 @@
+/*
+* Copy/destroy cost of the jstd shared pointers. Standalone program:
+*   g++ -std=c++20 -O2 -pthread -I../MyList SharedPtrBench.cpp && ./a.out
+*
+* Every operation assigns a shared pointer into one of 64 slots, switching
+* between two objects every 64 steps, so each one takes a reference on one
+* object and drops one on the other (assigning the pointer a slot already
+* holds may skip both). Single-threaded numbers cover every
+* pointer; the contended run has all threads share one object and leaves
+* out the non-atomic LocalSharedPtr and IntrusiveRefCounter<Single>.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SharePointer.h"
+
+namespace
+{
+
+constexpr std::size_t operations = 20000000;
+
+struct Payload
+{
+	int mValue = 0;
+};
+
+struct AtomicCounted : jstd::IntrusiveRefCounter<AtomicCounted, jstd::LockPolicy::Atomic>
+{
+	int mValue = 0;
+};
+
+struct SingleCounted : jstd::IntrusiveRefCounter<SingleCounted, jstd::LockPolicy::Single>
+{
+	int mValue = 0;
+};
+
+// Nanoseconds per copy and destroy, on one thread.
+template <typename Ptr>
+double copyDestroy(const Ptr& first, const Ptr& second, const std::size_t count)
+{
+	Ptr slots[64];
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		slots[i & 63] = (i & 64) ? second : first;
+	}
+
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / static_cast<double>(count);
+}
+
+// Nanoseconds per copy and destroy, threads all hammering the same count.
+template <typename Ptr>
+double contended(const Ptr& first, const Ptr& second, const unsigned threads)
+{
+	const std::size_t perThread = operations / threads;
+	std::vector<std::thread> pool;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; ++t)
+	{
+		pool.emplace_back([&first, &second, perThread] { copyDestroy(first, second, perThread); });
+	}
+
+	for (std::thread& thread : pool)
+	{
+		thread.join();
+	}
+
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / static_cast<double>(perThread * threads);
+}
+
+}
+
+int main()
+{
+	const auto shared = jstd::MakeShared<Payload>();
+	const auto shared2 = jstd::MakeShared<Payload>();
+	const auto local = jstd::MakeLocalShared<Payload>();
+	const auto local2 = jstd::MakeLocalShared<Payload>();
+	const jstd::IntrusivePtr<AtomicCounted> intrusiveAtomic(new AtomicCounted);
+	const jstd::IntrusivePtr<AtomicCounted> intrusiveAtomic2(new AtomicCounted);
+	const jstd::IntrusivePtr<SingleCounted> intrusiveSingle(new SingleCounted);
+	const jstd::IntrusivePtr<SingleCounted> intrusiveSingle2(new SingleCounted);
+	const auto standard = std::make_shared<Payload>();
+	const auto standard2 = std::make_shared<Payload>();
+
+	std::printf("single thread, ns per copy + destroy\n");
+	std::printf("  SharedPtr                   %6.2f\n", copyDestroy(shared, shared2, operations));
+	std::printf("  LocalSharedPtr              %6.2f\n", copyDestroy(local, local2, operations));
+	std::printf("  IntrusivePtr, atomic count  %6.2f\n", copyDestroy(intrusiveAtomic, intrusiveAtomic2, operations));
+	std::printf("  IntrusivePtr, single count  %6.2f\n", copyDestroy(intrusiveSingle, intrusiveSingle2, operations));
+	std::printf("  std::shared_ptr             %6.2f\n", copyDestroy(standard, standard2, operations));
+
+	std::printf("contended, two shared objects, ns per copy + destroy (hardware threads: %u)\n",
+		std::thread::hardware_concurrency());
+	for (unsigned threads = 2; threads <= 16; threads *= 2)
+	{
+		std::printf("  %2u threads: SharedPtr %6.2f  IntrusivePtr %6.2f  std::shared_ptr %6.2f\n",
+			threads,
+			contended(shared, shared2, threads),
+			contended(intrusiveAtomic, intrusiveAtomic2, threads),
+			contended(standard, standard2, threads));
+	}
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+* SharedPtr checks for adopting a pointer with a deleter. Standalone program:
+*   g++ -std=c++20 -I../MyList SharedPtrTest.cpp && ./a.out
+*/
+
+#include <cassert>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+
+#include "CountingAllocator.h"
+#include "SharePointer.h"
+#include "UniquePointer.h"
+
+namespace
+{
+
+// Copies and moves left before the next one throws, negative for never.
+int operationsLeft = -1;
+int deletions = 0;
+
+void spendOperation()
+{
+	if (operationsLeft == 0)
+	{
+		throw std::runtime_error("deleter");
+	}
+
+	if (operationsLeft > 0)
+	{
+		--operationsLeft;
+	}
+}
+
+/*
+* A deleter whose copy and move may throw. The move throws after it has stolen the state,
+* so calling a moved-from deleter is caught by the assert.
+*/
+struct CheckedDeleter
+{
+	bool mValid = true;
+
+	CheckedDeleter() = default;
+
+	CheckedDeleter(const CheckedDeleter& other)
+		: mValid(other.mValid)
+	{
+		spendOperation();
+	}
+
+	CheckedDeleter(CheckedDeleter&& other)
+		: mValid(other.mValid)
+	{
+		other.mValid = false;
+		spendOperation();
+	}
+
+	void operator()(int* ptr) const
+	{
+		assert(mValid);
+		++deletions;
+		delete ptr;
+	}
+};
+
+template <typename T>
+struct FailingAllocator
+{
+	using value_type = T;
+
+	FailingAllocator() = default;
+
+	template <typename U>
+	FailingAllocator(const FailingAllocator<U>&) { }
+
+	T* allocate(std::size_t)
+	{
+		throw std::bad_alloc();
+	}
+
+	void deallocate(T*, std::size_t) { }
+
+	friend bool operator==(const FailingAllocator&, const FailingAllocator&)
+	{
+		return true;
+	}
+};
+
+/*
+* Fail every copy or move of the deleter in turn. Each attempt either adopts the pointer or
+* throws having deleted it once, with a deleter that was not moved from, and no control block
+* is left allocated.
+*/
+void adoptWithThrowingDeleter()
+{
+	for (int budget = 0; budget < 8; ++budget)
+	{
+		jstd::AllocationCounter counter;
+		deletions = 0;
+		operationsLeft = budget;
+		try
+		{
+			jstd::SharedPtr<int> ptr(new int(budget), CheckedDeleter(), jstd::CountingAllocator<int>(counter));
+			operationsLeft = -1;
+			assert(*ptr == budget && ptr.use_count() == 1 && deletions == 0);
+		}
+		catch (const std::runtime_error&)
+		{
+			operationsLeft = -1;
+		}
+
+		assert(deletions == 1);
+		assert(counter.snapshot().liveAllocations() == 0);
+	}
+}
+
+void adoptWithFailingAllocator()
+{
+	deletions = 0;
+	try
+	{
+		jstd::SharedPtr<int> ptr(new int(1), CheckedDeleter(), FailingAllocator<int>());
+		assert(false);
+	}
+	catch (const std::bad_alloc&) { }
+
+	assert(deletions == 1);
+}
+
+// A UniquePtr keeps its pointer when the conversion throws, so it must not be deleted here.
+void fromUniquePtrThrowing()
+{
+	for (int budget = 0; budget < 4; ++budget)
+	{
+		deletions = 0;
+		{
+			jstd::UniquePtr<int, CheckedDeleter> owner(new int(budget));
+			operationsLeft = budget;
+			try
+			{
+				jstd::SharedPtr<int> ptr(std::move(owner));
+				operationsLeft = -1;
+				assert(!owner && *ptr == budget);
+			}
+			catch (const std::runtime_error&)
+			{
+				operationsLeft = -1;
+				assert(owner && owner.get_deleter().mValid && deletions == 0);
+			}
+		}
+
+		assert(deletions == 1);
+	}
+}
+
+}
+
+int main()
+{
+	adoptWithThrowingDeleter();
+	adoptWithFailingAllocator();
+	fromUniquePtrThrowing();
+	std::printf("shared pointer adoption ok\n");
+	return 0;
+}
@@ -0,0 +1,86 @@
+/*
+* Vector allocation checks, counted with CountingAllocator. Standalone program:
+*   g++ -std=c++20 -I../MyList VectorTest.cpp && ./a.out
+*/
+
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+#include "CountingAllocator.h"
+#include "Vector.h"
+
+namespace
+{
+
+template <typename T>
+using CountedVector = jstd::Vector<T, jstd::CountingAllocator<T>>;
+
+// reserve(n) followed by n emplace_back allocates exactly once.
+template <typename T, typename Make>
+void reserveThenEmplace(const std::size_t n, Make make)
+{
+	jstd::AllocationCounter counter;
+	{
+		CountedVector<T> vector{ jstd::CountingAllocator<T>(counter) };
+		vector.reserve(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			vector.emplace_back(make(i));
+		}
+
+		assert(vector.size() == n && vector.capacity() == n);
+		assert(counter.snapshot().allocations == 1);
+
+		// Within capacity, no further allocation.
+		vector.reserve(n / 2);
+		vector.resize(n / 2);
+		vector.resize(n);
+		assert(counter.snapshot().allocations == 1);
+	}
+
+	const jstd::AllocationStats stats = counter.snapshot();
+	assert(stats.deallocations == 1 && stats.bytesLive == 0);
+}
+
+void reserveCounts()
+{
+	for (const std::size_t n : { 1u, 2u, 100u, 10000u })
+	{
+		reserveThenEmplace<int>(n, [](const std::size_t i) { return static_cast<int>(i); });
+		reserveThenEmplace<std::string>(n, [](const std::size_t i) { return std::string(40, static_cast<char>('a' + i % 26)); });
+	}
+
+	std::puts("reserve then emplace_back: one allocation");
+}
+
+void resizeForOverwriteCounts()
+{
+	jstd::AllocationCounter counter;
+	CountedVector<unsigned char> vector{ jstd::CountingAllocator<unsigned char>(counter) };
+
+	vector.resize_for_overwrite(4096);
+	assert(vector.size() == 4096 && counter.snapshot().allocations == 1);
+
+	for (unsigned char& byte : vector)
+	{
+		byte = 7;
+	}
+
+	// CountingAllocator only forwards construction, so the elements are left as they were.
+	vector.clear();
+	vector.resize_for_overwrite(4096);
+	assert(counter.snapshot().allocations == 1);
+	assert(vector[0] == 7 && vector[4095] == 7);
+
+	std::puts("resize_for_overwrite: one allocation, no initialization");
+}
+
+}
+
+int main()
+{
+	reserveCounts();
+	resizeForOverwriteCounts();
+	return 0;
+}